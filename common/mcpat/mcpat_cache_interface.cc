@@ -2,6 +2,7 @@
  * Graphite-McPAT Cache Interface
  ***************************************************************************/
 
+#include <sstream>
 #include "mcpat_cache_interface.h"
 #include "simulator.h"
 #include "dvfs_manager.h"
@@ -25,27 +26,41 @@ McPATCacheInterface::McPATCacheInterface(Cache* cache)
       LOG_PRINT_ERROR("Could not read [general/technology_node] or [general/temperature] from the cfg file");
    }
 
-   // Make a ParseXML Object and Initialize it
-   _xml = new McPAT::ParseXML();
+   // Caches with the same parameters share their ParseXML and wrappers
+   UInt32 access_latency = _cache->_perf_model->getLatency(CachePerfModel::ACCESS_DATA_AND_TAGS).toCycles(_cache->_frequency);
+   ostringstream key;
+   key << technology_node << " " << temperature << " "
+       << _cache->_cache_size << " " << _cache->_line_size << " " << _cache->_associativity << " "
+       << _cache->_num_banks << " " << access_latency;
+   _cache_wrapper_entry = CacheWrapperCache::acquire(key.str());
 
-   // Initialize ParseXML Params and Stats
-   _xml->initialize();
-
-   // Fill the ParseXML's Core Params from McPATCacheInterface
-   fillCacheParamsIntoXML(technology_node, temperature);
-
-   // Create the cache wrappers
-   const DVFSManager::DVFSLevels& dvfs_levels = DVFSManager::getDVFSLevels();
-   for (DVFSManager::DVFSLevels::const_iterator it = dvfs_levels.begin(); it != dvfs_levels.end(); it++)
+   ScopedLock sl(_cache_wrapper_entry->lock);
+   if (!_cache_wrapper_entry->xml)
    {
-      double current_voltage = (*it).first;
-      double current_frequency = (*it).second;
-      // Create core wrapper (and) save for future use
-      _cache_wrapper_map[current_voltage] = createCacheWrapper(current_voltage, current_frequency);
+      // Make a ParseXML Object and Initialize it
+      _xml = new McPAT::ParseXML();
+
+      // Initialize ParseXML Params and Stats
+      _xml->initialize();
+
+      // Fill the ParseXML's Core Params from McPATCacheInterface
+      fillCacheParamsIntoXML(technology_node, temperature);
+
+      // Create the cache wrappers
+      const DVFSManager::DVFSLevels& dvfs_levels = DVFSManager::getDVFSLevels();
+      for (DVFSManager::DVFSLevels::const_iterator it = dvfs_levels.begin(); it != dvfs_levels.end(); it++)
+      {
+         double current_voltage = (*it).first;
+         double current_frequency = (*it).second;
+         // Create core wrapper (and) save for future use
+         _cache_wrapper_entry->wrapper_map[current_voltage] = createCacheWrapper(current_voltage, current_frequency);
+      }
+      _cache_wrapper_entry->xml = _xml;
    }
+   _xml = _cache_wrapper_entry->xml;
    
    // Initialize current cache wrapper
-   _cache_wrapper = _cache_wrapper_map[_cache->_voltage];
+   _cache_wrapper = _cache_wrapper_entry->wrapper_map[_cache->_voltage];
 
    // Initialize event counters
    initializeEventCounters();
@@ -59,9 +74,7 @@ McPATCacheInterface::McPATCacheInterface(Cache* cache)
 //---------------------------------------------------------------------------
 McPATCacheInterface::~McPATCacheInterface()
 {
-   for (CacheWrapperMap::iterator it = _cache_wrapper_map.begin(); it != _cache_wrapper_map.end(); it++)
-      delete (*it).second;
-   delete _xml;
+   CacheWrapperCache::release(_cache_wrapper_entry);
 }
 
 //---------------------------------------------------------------------------
@@ -88,7 +101,7 @@ void McPATCacheInterface::setDVFS(double old_frequency, double new_voltage, doub
    computeEnergy(curr_time, old_frequency);
    
    // Check if a McPATInterface object has already been created
-   _cache_wrapper = _cache_wrapper_map[new_voltage];
+   _cache_wrapper = _cache_wrapper_entry->wrapper_map[new_voltage];
    LOG_ASSERT_ERROR(_cache_wrapper, "McPAT cache power model with Voltage(%g) has NOT been created", new_voltage);
 }
 
@@ -104,6 +117,9 @@ void McPATCacheInterface::computeEnergy(const Time& curr_time, double frequency)
    Time time_interval = energy_compute_time - _last_energy_compute_time;
    UInt64 interval_cycles = time_interval.toCycles(frequency);
 
+   // The ParseXML and wrapper may be shared with other caches
+   ScopedLock sl(_cache_wrapper_entry->lock);
+
    // Fill the ParseXML's Core Event Stats from McPATCacheInterface
    fillCacheStatsIntoXML(interval_cycles);
 
@@ -7,6 +7,7 @@
 #include <map>
 using std::map;
 #include "contrib/mcpat/mcpat.h"
+#include "mcpat_wrapper_cache.h"
 #include "cache.h"
 
 //---------------------------------------------------------------------------
@@ -41,9 +42,9 @@ public:
    void outputSummary(ostream& os, const Time& target_completion_time, double frequency);
 
 private:
-   // McPAT Objects
-   typedef map<double,McPAT::CacheWrapper*> CacheWrapperMap;
-   CacheWrapperMap _cache_wrapper_map;
+   // McPAT Objects (shared with the caches that have the same parameters)
+   typedef McPATWrapperCache<McPAT::CacheWrapper> CacheWrapperCache;
+   CacheWrapperCache::Entry* _cache_wrapper_entry;
    McPAT::CacheWrapper* _cache_wrapper;
    McPAT::ParseXML* _xml;
    // Performance model of cache
@@ -2,6 +2,7 @@
  * Graphite-McPAT Core Interface
  ***************************************************************************/
 
+#include <sstream>
 #include "mcpat_core_interface.h"
 #include "simulator.h"
 #include "dvfs_manager.h"
@@ -42,28 +43,37 @@ McPATCoreInterface::McPATCoreInterface(CoreModel* core_model, double frequency,
    _enable_area_or_power_modeling = Config::getSingleton()->getEnableAreaModeling() || Config::getSingleton()->getEnablePowerModeling();
    if (_enable_area_or_power_modeling)
    {
-      // Make a ParseXML Object and Initialize it
-      _xml = new McPAT::ParseXML();
+      // Cores with the same parameters share their ParseXML and wrappers
+      _core_wrapper_entry = CoreWrapperCache::acquire(getArchitecturalParametersKey(technology_node, temperature));
 
-      // Initialize ParseXML Params and Stats
-      _xml->initialize();
-      _xml->setNiagara1();
+      ScopedLock sl(_core_wrapper_entry->lock);
+      if (!_core_wrapper_entry->xml)
+      {
+         // Make a ParseXML Object and Initialize it
+         _xml = new McPAT::ParseXML();
 
-      // Fill the ParseXML's Core Params from McPATCoreInterface
-      fillCoreParamsIntoXML(technology_node, temperature);
+         // Initialize ParseXML Params and Stats
+         _xml->initialize();
+         _xml->setNiagara1();
 
-      // Create the core wrappers
-      const DVFSManager::DVFSLevels& dvfs_levels = DVFSManager::getDVFSLevels();
-      for (DVFSManager::DVFSLevels::const_iterator it = dvfs_levels.begin(); it != dvfs_levels.end(); it++)
-      {
-         double current_voltage = (*it).first;
-         double current_frequency = (*it).second;
-         // Create core wrapper (and) save for future use
-         _core_wrapper_map[current_voltage] = createCoreWrapper(current_voltage, current_frequency);
+         // Fill the ParseXML's Core Params from McPATCoreInterface
+         fillCoreParamsIntoXML(technology_node, temperature);
+
+         // Create the core wrappers
+         const DVFSManager::DVFSLevels& dvfs_levels = DVFSManager::getDVFSLevels();
+         for (DVFSManager::DVFSLevels::const_iterator it = dvfs_levels.begin(); it != dvfs_levels.end(); it++)
+         {
+            double current_voltage = (*it).first;
+            double current_frequency = (*it).second;
+            // Create core wrapper (and) save for future use
+            _core_wrapper_entry->wrapper_map[current_voltage] = createCoreWrapper(current_voltage, current_frequency);
+         }
+         _core_wrapper_entry->xml = _xml;
       }
+      _xml = _core_wrapper_entry->xml;
 
       // Initialize current core wrapper
-      _core_wrapper = _core_wrapper_map[voltage];
+      _core_wrapper = _core_wrapper_entry->wrapper_map[voltage];
    }
 }
 
@@ -73,11 +83,7 @@ McPATCoreInterface::McPATCoreInterface(CoreModel* core_model, double frequency,
 McPATCoreInterface::~McPATCoreInterface()
 {
    if (_enable_area_or_power_modeling)
-   {
-      for (CoreWrapperMap::iterator it = _core_wrapper_map.begin(); it != _core_wrapper_map.end(); it++)
-         delete (*it).second;
-      delete _xml;
-   }
+      CoreWrapperCache::release(_core_wrapper_entry);
 }
 
 //---------------------------------------------------------------------------
@@ -107,7 +113,7 @@ void McPATCoreInterface::setDVFS(double old_frequency, double new_voltage, doubl
    computeEnergy(curr_time, old_frequency);
    
    // Check if a McPATInterface object has already been created
-   _core_wrapper = _core_wrapper_map[new_voltage];
+   _core_wrapper = _core_wrapper_entry->wrapper_map[new_voltage];
    LOG_ASSERT_ERROR(_core_wrapper, "McPAT core power model with Voltage(%g) has NOT been created", new_voltage);
 }
 
@@ -158,6 +164,30 @@ void McPATCoreInterface::initializeArchitecturalParameters(UInt32 load_queue_siz
    _register_windows_size = 0;
 }
 
+//---------------------------------------------------------------------------
+// Key of the shared ParseXML and wrappers (everything fillCoreParamsIntoXML uses)
+//---------------------------------------------------------------------------
+string McPATCoreInterface::getArchitecturalParametersKey(UInt32 technology_node, UInt32 temperature)
+{
+   ostringstream key;
+   key << technology_node << " " << temperature << " "
+       << _instruction_length << " " << _opcode_width << " " << _machine_type << " "
+       << _num_hardware_threads << " " << _fetch_width << " " << _num_instruction_fetch_ports << " "
+       << _decode_width << " " << _issue_width << " " << _commit_width << " "
+       << _fp_issue_width << " " << _prediction_width << " "
+       << _integer_pipeline_depth << " " << _fp_pipeline_depth << " "
+       << _ALU_per_core << " " << _MUL_per_core << " " << _FPU_per_core << " "
+       << _instruction_buffer_size << " " << _decoded_stream_buffer_size << " "
+       << _arch_regs_IRF_size << " " << _arch_regs_FRF_size << " "
+       << _phy_regs_IRF_size << " " << _phy_regs_FRF_size << " "
+       << _LSU_order << " " << _store_buffer_size << " " << _load_buffer_size << " "
+       << _num_memory_ports << " " << _RAS_size << " "
+       << _instruction_window_scheme << " " << _instruction_window_size << " "
+       << _fp_instruction_window_size << " " << _ROB_size << " " << _rename_scheme << " "
+       << _register_windows_size;
+   return key.str();
+}
+
 //---------------------------------------------------------------------------
 // Initialize Event Counters
 //---------------------------------------------------------------------------
@@ -478,6 +508,9 @@ void McPATCoreInterface::computeEnergy(const Time& curr_time, double frequency)
    Time time_interval = energy_compute_time - _last_energy_compute_time;
    UInt64 interval_cycles = time_interval.toCycles(frequency);
 
+   // The ParseXML and wrapper may be shared with other cores
+   ScopedLock sl(_core_wrapper_entry->lock);
+
    // Fill the ParseXML's Core Stats with the event counters
    fillCoreStatsIntoXML(interval_cycles);
 
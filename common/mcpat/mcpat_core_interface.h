@@ -10,6 +10,7 @@ using std::map;
 #include "instruction.h"
 #include "mcpat_instruction.h"
 #include "contrib/mcpat/mcpat.h"
+#include "mcpat_wrapper_cache.h"
 
 class CoreModel;
 
@@ -104,9 +105,9 @@ public:
 
 private:
    CoreModel* _core_model;
-   // McPAT Objects
-   typedef map<double,McPAT::CoreWrapper*> CoreWrapperMap;
-   CoreWrapperMap _core_wrapper_map;
+   // McPAT Objects (shared with the cores that have the same parameters)
+   typedef McPATWrapperCache<McPAT::CoreWrapper> CoreWrapperCache;
+   CoreWrapperCache::Entry* _core_wrapper_entry;
    McPAT::CoreWrapper* _core_wrapper;
    McPAT::ParseXML* _xml;
    // Output Data Structure
@@ -253,6 +254,7 @@ private:
    
    // Initialize Architectural Parameters
    void initializeArchitecturalParameters(UInt32 load_queue_size, UInt32 store_queue_size);
+   string getArchitecturalParametersKey(UInt32 technology_node, UInt32 temperature);
    // Initialize Event Counters
    void initializeEventCounters();
    // Initialize/update Output Data Structure
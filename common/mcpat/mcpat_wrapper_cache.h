@@ -0,0 +1,77 @@
+/*****************************************************************************
+ * Graphite-McPAT Wrapper Cache
+ ***************************************************************************/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include "contrib/mcpat/mcpat.h"
+#include "fixed_types.h"
+#include "lock.h"
+
+//---------------------------------------------------------------------------
+// Process-wide cache of McPAT wrappers. Building a wrapper runs CACTI over
+// all its arrays, and the ParseXML it is built from is several MB, so the
+// interfaces of all the tiles with the same parameters (the key) share one
+// ParseXML and one wrapper per DVFS level (indexed by voltage).
+// A wrapper keeps reading its stats from the ParseXML it was built from,
+// so computeEnergy() of the sharing interfaces is serialized on 'lock'.
+//---------------------------------------------------------------------------
+template <class Wrapper>
+class McPATWrapperCache
+{
+public:
+   typedef std::map<double,Wrapper*> WrapperMap;
+
+   struct Entry
+   {
+      Entry() : xml(NULL), ref_count(0) {}
+
+      McPAT::ParseXML* xml;      // NULL until the first user builds it (holding 'lock')
+      WrapperMap wrapper_map;
+      Lock lock;
+      UInt32 ref_count;
+   };
+
+   static Entry* acquire(const std::string& key)
+   {
+      ScopedLock sl(_entry_map_lock);
+      Entry*& entry = _entry_map[key];
+      if (!entry)
+         entry = new Entry();
+      entry->ref_count ++;
+      return entry;
+   }
+
+   static void release(Entry* entry)
+   {
+      ScopedLock sl(_entry_map_lock);
+      if (-- entry->ref_count > 0)
+         return;
+
+      for (typename EntryMap::iterator it = _entry_map.begin(); it != _entry_map.end(); it++)
+      {
+         if ((*it).second == entry)
+         {
+            _entry_map.erase(it);
+            break;
+         }
+      }
+      for (typename WrapperMap::iterator it = entry->wrapper_map.begin(); it != entry->wrapper_map.end(); it++)
+         delete (*it).second;
+      delete entry->xml;
+      delete entry;
+   }
+
+private:
+   typedef std::map<std::string,Entry*> EntryMap;
+
+   static EntryMap _entry_map;
+   static Lock _entry_map_lock;
+};
+
+template <class Wrapper>
+typename McPATWrapperCache<Wrapper>::EntryMap McPATWrapperCache<Wrapper>::_entry_map;
+template <class Wrapper>
+Lock McPATWrapperCache<Wrapper>::_entry_map_lock;
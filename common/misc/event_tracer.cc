@@ -0,0 +1,230 @@
+#include <sched.h>
+#include <unistd.h>
+#include <cassert>
+#include <sstream>
+#include <algorithm>
+
+#include "event_tracer.h"
+#include "simulator.h"
+#include "config.h"
+#include "log.h"
+
+using namespace std;
+
+EventTracer* EventTracer::_singleton;
+UInt32 EventTracer::_enabled_modules;
+
+EventTracer::RingBuffer::RingBuffer(UInt32 thread, UInt32 num_records)
+   : _thread(thread)
+   , _mask(num_records - 1)
+   , _records(new TraceRecord[num_records])
+   , _head(0)
+   , _tail(0)
+   , _num_dropped(0)
+   , _num_dropped_reported(0)
+{}
+
+EventTracer::RingBuffer::~RingBuffer()
+{
+   delete [] _records;
+}
+
+EventTracer::EventTracer()
+   : _buffer_tls(TLS::create())
+   , _file(NULL)
+   , _thread(NULL)
+   , _quit(false)
+   , _finished(false)
+   , _total_records(0)
+   , _total_dropped(0)
+{
+   UInt32 buffer_size = Sim()->getCfg()->getInt("trace/buffer_size", 65536);
+   LOG_ASSERT_ERROR(buffer_size > 0 && (buffer_size & (buffer_size - 1)) == 0,
+                    "trace/buffer_size(%u) must be a power of 2", buffer_size);
+   _buffer_size = buffer_size;
+   _drain_interval = Sim()->getCfg()->getInt("trace/drain_interval", 1000);
+
+   ostringstream filename;
+   filename << "event_trace." << Config::getSingleton()->getCurrentProcessNum() << ".bin";
+   _file = fopen(Sim()->getConfig()->formatOutputFileName(filename.str()).c_str(), "w");
+   LOG_ASSERT_ERROR(_file, "Could not open %s", filename.str().c_str());
+
+   TraceFileHeader header;
+   header.magic = TraceFileHeader::MAGIC;
+   header.version = TraceFileHeader::VERSION;
+   header.record_size = sizeof(TraceRecord);
+   header.num_events = NUM_TRACE_EVENTS;
+   fwrite(&header, sizeof(header), 1, _file);
+
+   assert(_singleton == NULL);
+   _singleton = this;
+   _enabled_modules = parseModules(Sim()->getCfg()->getString("trace/modules", ""));
+}
+
+EventTracer::~EventTracer()
+{
+   _enabled_modules = 0;
+   _singleton = NULL;
+
+   for (vector<RingBuffer*>::iterator it = _buffers.begin(); it != _buffers.end(); it++)
+      delete *it;
+   delete _buffer_tls;
+   delete _thread;
+
+   if (_file)
+      fclose(_file);
+}
+
+UInt32
+EventTracer::parseModules(string list)
+{
+   static const char* module_names[] =
+   {
+#define TRACE_MODULE_DEF(id, name) name,
+      TRACE_MODULE_LIST
+#undef TRACE_MODULE_DEF
+   };
+
+   if (list.find_first_not_of(" ") == string::npos)
+      return (1 << NUM_TRACE_MODULES) - 1;
+
+   UInt32 modules = 0;
+   istringstream is(list);
+   string name;
+   while (is >> name)
+   {
+      UInt32 i = 0;
+      while (i < NUM_TRACE_MODULES && name != module_names[i])
+         i ++;
+      LOG_ASSERT_ERROR(i < NUM_TRACE_MODULES, "Unknown trace module(%s)", name.c_str());
+      modules |= (1 << i);
+   }
+   return modules;
+}
+
+EventTracer::RingBuffer*
+EventTracer::getBuffer()
+{
+   RingBuffer* buffer = _buffer_tls->get<RingBuffer>();
+   if (buffer)
+      return buffer;
+
+   // First record of this thread
+   ScopedLock sl(_buffers_lock);
+   buffer = new RingBuffer(_buffers.size(), _buffer_size);
+   _buffers.push_back(buffer);
+   _buffer_tls->set(buffer);
+   return buffer;
+}
+
+void
+EventTracer::record(TraceEventId event, tile_id_t tile_id, UInt64 time, SInt64 arg0, SInt64 arg1, SInt64 arg2)
+{
+   RingBuffer* buffer = getBuffer();
+
+   UInt64 head = buffer->_head;
+   if (head - buffer->_tail > buffer->_mask)
+   {
+      buffer->_num_dropped ++;
+      return;
+   }
+
+   TraceRecord& record = buffer->_records[head & buffer->_mask];
+   record.event = event;
+   record.padding = 0;
+   record.tile_id = tile_id;
+   record.time = time;
+   record.args[0] = arg0;
+   record.args[1] = arg1;
+   record.args[2] = arg2;
+
+   // The record has to be complete before the drain thread can see it
+   __sync_synchronize();
+   buffer->_head = head + 1;
+}
+
+void
+EventTracer::drain(RingBuffer* buffer)
+{
+   UInt64 head = buffer->_head;
+   UInt64 tail = buffer->_tail;
+   UInt64 num_dropped = buffer->_num_dropped;
+   if (head == tail && num_dropped == buffer->_num_dropped_reported)
+      return;
+
+   // Read the records only after seeing the head that covers them
+   __sync_synchronize();
+
+   TraceBlockHeader header;
+   header.thread = buffer->_thread;
+   header.num_records = head - tail;
+   header.num_dropped = num_dropped - buffer->_num_dropped_reported;
+   fwrite(&header, sizeof(header), 1, _file);
+
+   // The records may wrap around the end of the ring
+   UInt64 begin = tail & buffer->_mask;
+   UInt64 num_first = min<UInt64>(head - tail, buffer->_mask + 1 - begin);
+   fwrite(&buffer->_records[begin], sizeof(TraceRecord), num_first, _file);
+   fwrite(&buffer->_records[0], sizeof(TraceRecord), (head - tail) - num_first, _file);
+
+   _total_records += (head - tail);
+   _total_dropped += header.num_dropped;
+   buffer->_num_dropped_reported = num_dropped;
+
+   // Hand the slots back to the producer only once they have been copied
+   __sync_synchronize();
+   buffer->_tail = head;
+}
+
+void
+EventTracer::drain()
+{
+   // Threads that register while the list is being walked are drained the next time
+   _buffers_lock.acquire();
+   vector<RingBuffer*> buffers = _buffers;
+   _buffers_lock.release();
+
+   for (vector<RingBuffer*>::iterator it = buffers.begin(); it != buffers.end(); it++)
+      drain(*it);
+}
+
+void
+EventTracer::run()
+{
+   LOG_PRINT("Event tracer thread starting...");
+
+   while (!_quit)
+   {
+      usleep(_drain_interval);
+      drain();
+   }
+
+   _finished = true;
+
+   LOG_PRINT("Event tracer thread exiting");
+}
+
+void
+EventTracer::start()
+{
+   _thread = Thread::create(this);
+   _thread->run();
+}
+
+void
+EventTracer::finish()
+{
+   _quit = true;
+
+   // Wait till the thread exits
+   while (!_finished)
+      sched_yield();
+
+   // Whatever was recorded since the last drain
+   _enabled_modules = 0;
+   drain();
+   fflush(_file);
+
+   LOG_ASSERT_WARNING(_total_dropped == 0, "Event tracer dropped %llu of %llu records, increase trace/buffer_size",
+                      _total_dropped, _total_dropped + _total_records);
+}
@@ -0,0 +1,93 @@
+#ifndef EVENT_TRACER_H
+#define EVENT_TRACER_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "fixed_types.h"
+#include "trace_events.h"
+#include "thread.h"
+#include "lock.h"
+#include "tls.h"
+
+// Low-overhead replacement for LOG_PRINT on hot paths. TRACE_EVENT()
+// appends a fixed-size binary record to a ring buffer owned by the calling
+// thread, without taking any lock or formatting anything. A drain thread
+// periodically moves the records of all the threads to a binary file, which
+// tools/trace_decoder renders as text. When a ring buffer is full, the
+// record is dropped (and counted) rather than stalling the thread.
+//
+// [trace]
+// enabled = true
+// modules = "core memory"    # empty: all modules
+
+class EventTracer : public Runnable
+{
+   public:
+      EventTracer();
+      ~EventTracer();
+
+      static EventTracer* getSingleton() { return _singleton; }
+
+      static bool isEnabled(UInt32 module) { return (_enabled_modules & (1 << module)) != 0; }
+
+      void record(TraceEventId event, tile_id_t tile_id, UInt64 time, SInt64 arg0, SInt64 arg1, SInt64 arg2);
+
+      void start();
+      void finish();
+
+   private:
+      // Single-producer (the owning thread), single-consumer (the drain
+      // thread) ring of records
+      struct RingBuffer
+      {
+         RingBuffer(UInt32 thread, UInt32 num_records);
+         ~RingBuffer();
+
+         UInt32 _thread;
+         UInt32 _mask;
+         TraceRecord* _records;
+         volatile UInt64 _head;     // written by the producer only
+         volatile UInt64 _tail;     // written by the consumer only
+         volatile UInt64 _num_dropped;
+         UInt64 _num_dropped_reported;
+      };
+
+      static EventTracer* _singleton;
+      static UInt32 _enabled_modules;
+
+      TLS* _buffer_tls;
+      std::vector<RingBuffer*> _buffers;
+      Lock _buffers_lock;
+      UInt32 _buffer_size;
+
+      FILE* _file;
+      UInt32 _drain_interval;    // in microseconds
+      Thread* _thread;
+      volatile bool _quit;
+      volatile bool _finished;
+
+      UInt64 _total_records;
+      UInt64 _total_dropped;
+
+      RingBuffer* getBuffer();
+      void drain();
+      void drain(RingBuffer* buffer);
+      void run();
+
+      static UInt32 parseModules(std::string list);
+};
+
+#define TRACE_EVENT(event, tile_id, time, arg0, arg1, arg2)                      \
+   do                                                                            \
+   {                                                                             \
+      if (EventTracer::isEnabled(TRACE_EVENT_MODULES[TRACE_##event]))            \
+      {                                                                          \
+         EventTracer::getSingleton()->record(TRACE_##event, tile_id, time,       \
+                                             (SInt64) (arg0), (SInt64) (arg1),   \
+                                             (SInt64) (arg2));                   \
+      }                                                                          \
+   } while (0)
+
+#endif // EVENT_TRACER_H
@@ -95,10 +95,6 @@ class Log
    {                                                                    \
    }                                                                    \
 
-// added by davidepatti
-#define MY_LOG_PRINT(...)                                                  \
-   _LOG_PRINT(Log::None, __VA_ARGS__); 
-
 #define __LOG_PRINT(err, file, line, ...)                               \
    {                                                                    \
       if (Log::getSingleton()->isLoggingEnabled() || err != Log::None)  \
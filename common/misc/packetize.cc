@@ -2,22 +2,118 @@
 #include "fixed_types.h"
 
 UnstructuredBuffer::UnstructuredBuffer()
+   : m_storage(m_inline)
+   , m_capacity(INLINE_CAPACITY)
+   , m_data(m_inline)
+   , m_read_pos(0)
+   , m_write_pos(0)
 {
 }
 
+UnstructuredBuffer::UnstructuredBuffer(const void* data, int size)
+   : m_storage(m_inline)
+   , m_capacity(INLINE_CAPACITY)
+   , m_data(m_inline)
+   , m_read_pos(0)
+   , m_write_pos(0)
+{
+   wrap(data, size);
+}
+
+UnstructuredBuffer::UnstructuredBuffer(const UnstructuredBuffer& buffer)
+   : m_storage(m_inline)
+   , m_capacity(INLINE_CAPACITY)
+   , m_data(m_inline)
+   , m_read_pos(0)
+   , m_write_pos(0)
+{
+   put<char>(buffer.m_data + buffer.m_read_pos, buffer.m_write_pos - buffer.m_read_pos);
+}
+
+UnstructuredBuffer::~UnstructuredBuffer()
+{
+   releaseStorage();
+}
+
+UnstructuredBuffer& UnstructuredBuffer::operator=(const UnstructuredBuffer& buffer)
+{
+   if (this != &buffer)
+   {
+      clear();
+      put<char>(buffer.m_data + buffer.m_read_pos, buffer.m_write_pos - buffer.m_read_pos);
+   }
+   return *this;
+}
+
 const void* UnstructuredBuffer::getBuffer()
 {
-   return m_chars.data();
+   return m_data + m_read_pos;
 }
 
 void UnstructuredBuffer::clear()
 {
-   m_chars.erase();
+   m_data = m_storage;
+   m_read_pos = 0;
+   m_write_pos = 0;
 }
 
 int UnstructuredBuffer::size()
 {
-   return m_chars.size();
+   return m_write_pos - m_read_pos;
+}
+
+void UnstructuredBuffer::wrap(const void* data, int size)
+{
+   assert(size >= 0);
+
+   // Unread data must be kept in order, so fall back to copying
+   if (m_write_pos != m_read_pos)
+   {
+      put<char>((const char*) data, size);
+      return;
+   }
+
+   m_data = (const char*) data;
+   m_read_pos = 0;
+   m_write_pos = size;
+}
+
+void UnstructuredBuffer::reserve(unsigned int bytes)
+{
+   unsigned int unread = m_write_pos - m_read_pos;
+
+   // Enough room in our own storage once the consumed bytes are dropped
+   if (unread + bytes <= m_capacity)
+   {
+      memmove(m_storage, m_data + m_read_pos, unread);
+      m_data = m_storage;
+      m_read_pos = 0;
+      m_write_pos = unread;
+      return;
+   }
+
+   unsigned int capacity = 2 * m_capacity;
+   if (capacity < unread + bytes)
+      capacity = unread + bytes;
+
+   char* storage = new char[capacity];
+   memcpy(storage, m_data + m_read_pos, unread);
+
+   releaseStorage();
+
+   m_storage = storage;
+   m_capacity = capacity;
+   m_data = m_storage;
+   m_read_pos = 0;
+   m_write_pos = unread;
+}
+
+void UnstructuredBuffer::releaseStorage()
+{
+   if (m_storage != m_inline)
+      delete [] m_storage;
+   m_storage = m_inline;
+   m_capacity = INLINE_CAPACITY;
 }
 
 // put buffer
@@ -103,3 +199,112 @@ int main(int argc, char* argv[])
 }
 
 #endif
+
+#ifdef BENCHMARK_UNSTRUCTURED_BUFFER
+
+// Encode/decode throughput of a typical sync/syscall message (k scalar
+// fields followed by a small payload). The string-based codec is the
+// previous implementation of UnstructuredBuffer and serves as the baseline.
+//
+// g++ -O2 -DBENCHMARK_UNSTRUCTURED_BUFFER -I. -I../user packetize.cc
+
+#include <iostream>
+#include <string>
+#include <sys/time.h>
+
+using namespace std;
+
+class StringBuffer
+{
+public:
+   template<class T> void put(const T& data)
+   { m_chars.append((const char*) &data, sizeof(T)); }
+   template<class T> void get(T& data)
+   { m_chars.copy((char*) &data, sizeof(T)); m_chars.erase(0, sizeof(T)); }
+   void put(const void* data, int size)
+   { m_chars.append((const char*) data, size); }
+   void get(void* data, int size)
+   { m_chars.copy((char*) data, size); m_chars.erase(0, size); }
+   const void* getBuffer() { return m_chars.data(); }
+   int size() { return m_chars.size(); }
+   void clear() { m_chars.erase(); }
+private:
+   string m_chars;
+};
+
+static double getTime()
+{
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static const int NUM_MESSAGES = 2000000;
+static const int NUM_FIELDS = 8;
+static char payload[128];
+static volatile UInt64 sink;
+
+static double benchmarkString()
+{
+   double start = getTime();
+   for (int m = 0; m < NUM_MESSAGES; m++)
+   {
+      StringBuffer send_buff;
+      for (UInt64 f = 0; f < NUM_FIELDS; f++)
+         send_buff.put<UInt64>(f + m);
+      send_buff.put(payload, sizeof(payload));
+
+      StringBuffer recv_buff;
+      recv_buff.put(send_buff.getBuffer(), send_buff.size());
+      UInt64 field;
+      for (int f = 0; f < NUM_FIELDS; f++)
+      {
+         recv_buff.get<UInt64>(field);
+         sink += field;
+      }
+      recv_buff.get(payload, sizeof(payload));
+   }
+   return NUM_MESSAGES / (getTime() - start);
+}
+
+static double benchmarkUnstructured(bool reuse)
+{
+   UnstructuredBuffer reused_send_buff;
+   UnstructuredBuffer reused_recv_buff;
+
+   double start = getTime();
+   for (int m = 0; m < NUM_MESSAGES; m++)
+   {
+      UnstructuredBuffer local_send_buff;
+      UnstructuredBuffer local_recv_buff;
+      UnstructuredBuffer& send_buff = reuse ? reused_send_buff : local_send_buff;
+      UnstructuredBuffer& recv_buff = reuse ? reused_recv_buff : local_recv_buff;
+      send_buff.clear();
+      recv_buff.clear();
+
+      for (UInt64 f = 0; f < NUM_FIELDS; f++)
+         send_buff << (f + m);
+      send_buff << make_pair(payload, (int) sizeof(payload));
+
+      // Zero-copy view of the received packet
+      recv_buff.wrap(send_buff.getBuffer(), send_buff.size());
+      UInt64 field;
+      for (int f = 0; f < NUM_FIELDS; f++)
+      {
+         recv_buff >> field;
+         sink += field;
+      }
+      recv_buff >> make_pair(payload, (int) sizeof(payload));
+   }
+   return NUM_MESSAGES / (getTime() - start);
+}
+
+int main(int argc, char* argv[])
+{
+   cout << "string (baseline)       : " << benchmarkString() << " msgs/s" << endl;
+   cout << "cursor, fresh buffers   : " << benchmarkUnstructured(false) << " msgs/s" << endl;
+   cout << "cursor, reused buffers  : " << benchmarkUnstructured(true) << " msgs/s" << endl;
+   return 0;
+}
+
+#endif
@@ -4,23 +4,56 @@
 #define PACKETIZE_H
 
 //#define DEBUG_UNSTRUCTURED_BUFFER
+//#define BENCHMARK_UNSTRUCTURED_BUFFER
 #include <assert.h>
-#include <string>
+#include <string.h>
 #include <utility>
 
+// Data is appended at a write offset and consumed from a read cursor, so
+// decoding a message costs O(size) in total instead of shifting the
+// remaining bytes on every get(). Small messages live in inline storage,
+// and heap storage is kept across clear(), so neither short-lived buffers
+// nor the per-core buffers that are reused for every message touch the
+// allocator in steady state.
+//
+// wrap() lets a buffer read directly out of memory it does not own (e.g.,
+// NetPacket::data) without copying it. The wrapped memory must outlive all
+// get() calls; the first put() after wrap() copies the unread bytes into
+// the buffer's own storage.
+
 class UnstructuredBuffer
 {
 
 private:
-    std::string m_chars;
+    static const unsigned int INLINE_CAPACITY = 64;
+
+    // Storage owned by this buffer (either m_inline or a heap block)
+    char* m_storage;
+    unsigned int m_capacity;
+    // Points either to m_storage or to wrapped memory
+    const char* m_data;
+    unsigned int m_read_pos;
+    unsigned int m_write_pos;
+    char m_inline[INLINE_CAPACITY];
+
+    void reserve(unsigned int bytes);
+    void releaseStorage();
 
 public:
 
     UnstructuredBuffer();
+    UnstructuredBuffer(const void* data, int size);
+    UnstructuredBuffer(const UnstructuredBuffer& buffer);
+    ~UnstructuredBuffer();
+    UnstructuredBuffer& operator=(const UnstructuredBuffer& buffer);
+
     const void* getBuffer();
     void clear();
     int size();
 
+    // Read directly from 'data' without copying it
+    void wrap(const void* data, int size);
+
     // These put / get scalars
     template<class T> void put(const T & data);
     template<class T> bool get(T& data);
@@ -40,7 +73,7 @@ public:
     UnstructuredBuffer& operator<<(std::pair<T*, I> buffer);
     template<class T, class I>
     UnstructuredBuffer& operator>>(std::pair<T*, I> buffer);
-    
+
     UnstructuredBuffer& operator<<(std::pair<const void*, int> buffer);
     UnstructuredBuffer& operator>>(std::pair<void*, int> buffer);
 };
@@ -48,17 +81,23 @@ public:
 template<class T> void UnstructuredBuffer::put(const T* data, int num)
 {
     assert(num >= 0);
-    m_chars.append((const char *) data, num * sizeof(T));
+    unsigned int bytes = num * sizeof(T);
+    if ((m_data != m_storage) || (m_write_pos + bytes > m_capacity))
+        reserve(bytes);
+
+    memcpy(m_storage + m_write_pos, data, bytes);
+    m_write_pos += bytes;
 }
 
 template<class T> bool UnstructuredBuffer::get(T* data, int num)
 {
     assert(num >= 0);
-    if (m_chars.size() < (num * sizeof(T)))
+    unsigned int bytes = num * sizeof(T);
+    if ((m_write_pos - m_read_pos) < bytes)
         return false;
 
-    m_chars.copy((char *) data, num * sizeof(T));
-    m_chars.erase(0, num * sizeof(T));
+    memcpy((char *) data, m_data + m_read_pos, bytes);
+    m_read_pos += bytes;
 
     return true;
 }
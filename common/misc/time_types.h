@@ -4,12 +4,41 @@
 #include "fixed_types.h"
 #include "log.h"
 
+// Period of a clock (frequency in GHz), for the modules that convert
+// between cycles and picoseconds on every access. When the period is an
+// exact integer number of picoseconds (1, 2, 2.5, 4 GHz...), the
+// conversions are done with integer arithmetic, up to the operand sizes
+// where the floating-point ceil() is known to be exact, so that both give
+// the same results. Other frequencies (e.g. 1.5 GHz) fall back to ceil().
+class ClockPeriod
+{
+   public:
+      explicit ClockPeriod(double frequency = 0);
+
+      double getFrequency() const { return _frequency; }
+      // 0 if the period is not an exact integer
+      UInt64 getPicosec() const { return _picosec; }
+
+      // Bounds within which the integer conversions are exact
+      static const UInt64 MAX_EXACT_PERIOD = 1ULL << 13;
+      static const UInt64 MAX_EXACT_CYCLES = 1ULL << 40;
+      static const UInt64 MAX_EXACT_PICOSEC = 1ULL << 46;
+
+   private:
+      double _frequency;
+      UInt64 _picosec;
+};
+
 class Latency
 {
    public:
-      Latency(UInt64 cycles = 0, double frequency = 0):_cycles(cycles), _frequency(frequency){};
+      Latency(UInt64 cycles = 0, double frequency = 0):_cycles(cycles), _frequency(frequency), _period(0){};
+      Latency(UInt64 cycles, const ClockPeriod& period):_cycles(cycles),
+                                                       _frequency(period.getFrequency()),
+                                                       _period(period.getPicosec()) {};
       Latency(const Latency& lat):_cycles(lat._cycles),
-                                  _frequency(lat._frequency) {};
+                                  _frequency(lat._frequency),
+                                  _period(lat._period) {};
       ~Latency(){};
 
       Latency operator+(const Latency& lat) const;
@@ -26,6 +55,7 @@ class Latency
    private:
       UInt64 _cycles;
       double _frequency;
+      UInt64 _period;      // ClockPeriod::getPicosec()
 };
 
 class Time
@@ -67,6 +97,7 @@ class Time
             { _picosec -= time._picosec; }
 
       UInt64 toCycles(double frequency) const;
+      UInt64 toCycles(const ClockPeriod& period) const;
       UInt64 getTime() const { return _picosec; }
       
       UInt64 toPicosec() const { return _picosec; }
@@ -78,8 +109,32 @@ class Time
 };
 
 
+inline ClockPeriod::ClockPeriod(double frequency)
+   : _frequency(frequency)
+   , _picosec(0)
+{
+   double period = 1000.0 / frequency;
+   if ((frequency <= 0) || (period >= MAX_EXACT_PERIOD))
+      return;
+
+   UInt64 picosec = (UInt64) floor(period + 0.5);
+   if (picosec == 0)
+      return;
+
+   // 1000/picosec is a double only if the odd part of picosec divides 125,
+   // and then it is the frequency only if the division gives it back
+   UInt64 odd_part = picosec;
+   while ((odd_part % 2) == 0)
+      odd_part /= 2;
+   if (((125 % odd_part) == 0) && ((1000.0 / picosec) == frequency))
+      _picosec = picosec;
+}
+
 inline UInt64 Latency::toPicosec() const
 {
+   if ((_period != 0) && (_cycles < ClockPeriod::MAX_EXACT_CYCLES))
+      return _cycles * _period;
+
    UInt64 picosec = (UInt64) ceil( ((double) 1000*_cycles) /  ((double) _frequency) );
 
    return picosec;
@@ -90,7 +145,9 @@ inline Latency Latency::operator+(const Latency& lat) const
    LOG_ASSERT_ERROR(_frequency == lat._frequency,
       "Attempting to add latencies from different frequencies");
 
-   return Latency(_cycles + lat._cycles, _frequency);
+   Latency sum(*this);
+   sum._cycles += lat._cycles;
+   return sum;
 }
 
 inline Latency Latency::operator+=(const Latency& lat)
@@ -108,8 +165,20 @@ inline UInt64 Time::toCycles(double frequency) const
    return cycles;
 }
 
+inline UInt64 Time::toCycles(const ClockPeriod& period) const
+{
+   UInt64 period_in_picosec = period.getPicosec();
+   if ((period_in_picosec != 0) && (_picosec < ClockPeriod::MAX_EXACT_PICOSEC))
+      return (_picosec + period_in_picosec - 1) / period_in_picosec;
+
+   return toCycles(period.getFrequency());
+}
+
 inline UInt64 Time::toNanosec() const
 {
+   if (_picosec < ClockPeriod::MAX_EXACT_PICOSEC)
+      return (_picosec + 999) / 1000;
+
    return (UInt64) ceil(((double) _picosec)/double(1.0e3));
 }
 
@@ -0,0 +1,125 @@
+#ifndef TRACE_EVENTS_H
+#define TRACE_EVENTS_H
+
+#include "fixed_types.h"
+
+// Modules and events known to the EventTracer. Every event carries up to
+// three signed 64-bit arguments, which the format string (rendered offline by
+// tools/trace_decoder) has to print as 'long long': %lld for tile IDs (which
+// are negative for BROADCAST and MULTICAST), %llu or %llx for the rest.
+//
+// TRACE_MODULE_DEF(id, name)
+// TRACE_EVENT_DEF(module_id, event_id, format)
+
+#define TRACE_MODULE_LIST                                               \
+   TRACE_MODULE_DEF(CORE,     "core")                                   \
+   TRACE_MODULE_DEF(MEMORY,   "memory")                                 \
+   TRACE_MODULE_DEF(NETWORK,  "network")                                \
+   TRACE_MODULE_DEF(SYSTEM,   "system")
+
+#define TRACE_EVENT_LIST                                                \
+   TRACE_EVENT_DEF(CORE, CORE_INITIALIZED,                              \
+                   "Initialized Core")                                  \
+   TRACE_EVENT_DEF(CORE, CORE_INSTRUCTION_READ,                         \
+                   "Instruction: Address(%#llx), Size(%llu), Start READ") \
+   TRACE_EVENT_DEF(CORE, CORE_MEMORY_ACCESS_START,                      \
+                   "Mem Op(%llu) - ADDR(%#llx), data_size(%llu), START") \
+   TRACE_EVENT_DEF(CORE, CORE_MEMORY_ACCESS_END,                        \
+                   "Mem Op(%llu) - ADDR(%#llx), data_size(%llu), END") \
+   TRACE_EVENT_DEF(MEMORY, MEMORY_OP_FROM_CORE,                         \
+                   "processMemOpFromCore(), lock_signal(%llu), mem_op_type(%llu), ca_address(%#llx)") \
+   TRACE_EVENT_DEF(MEMORY, MEMORY_MSG_RECEIVED,                         \
+                   "Got Shmem Msg: type(%llu), address(%#llx), sender(%lld)") \
+   TRACE_EVENT_DEF(MEMORY, MEMORY_MSG_SENT,                             \
+                   "Sending Msg: type(%llu), address(%#llx), receiver(%lld)") \
+   TRACE_EVENT_DEF(MEMORY, MEMORY_MSG_BROADCAST,                        \
+                   "Broadcasting Msg: type(%llu), address(%#llx)")      \
+   TRACE_EVENT_DEF(MEMORY, MEMORY_MSG_MULTICAST,                        \
+                   "Multicasting Msg: type(%llu), address(%#llx), num_receivers(%llu)") \
+   TRACE_EVENT_DEF(NETWORK, NETWORK_SEND,                               \
+                   "netSend: type %llu, from %lld to %lld")             \
+   TRACE_EVENT_DEF(NETWORK, NETWORK_MULTICAST,                          \
+                   "netMulticast: type %llu, from %lld to %llu tiles")  \
+   TRACE_EVENT_DEF(NETWORK, NETWORK_SEND_TO_TRANSPORT,                  \
+                   "Send packet : type %llu, from %lld, next_hop %lld") \
+   TRACE_EVENT_DEF(NETWORK, NETWORK_PULL,                               \
+                   "Pull packet : type %llu, from %lld")                \
+   TRACE_EVENT_DEF(NETWORK, NETWORK_CALLBACK,                           \
+                   "Executing callback on packet : type %llu, from %lld, to %lld") \
+   TRACE_EVENT_DEF(NETWORK, NETWORK_ENQUEUE,                            \
+                   "Enqueuing packet : type %llu, from %lld, to %lld")  \
+   TRACE_EVENT_DEF(NETWORK, NETWORK_FORWARD,                            \
+                   "Forwarding packet : type %llu, from %lld, to %lld") \
+   TRACE_EVENT_DEF(NETWORK, NETWORK_RECV,                               \
+                   "netRecv: type %llu, from %lld, started waiting at %llu ns") \
+   TRACE_EVENT_DEF(SYSTEM, SYSTEM_MUTEX_LOCK,                           \
+                   "mutexLock(): mux(%llu)")                            \
+   TRACE_EVENT_DEF(SYSTEM, SYSTEM_MUTEX_UNLOCK,                         \
+                   "mutexUnlock(): mux(%llu)")                          \
+   TRACE_EVENT_DEF(SYSTEM, SYSTEM_COND_WAIT,                            \
+                   "condWait(): cond(%llu), mux(%llu)")                 \
+   TRACE_EVENT_DEF(SYSTEM, SYSTEM_COND_SIGNAL,                          \
+                   "condSignal(): cond(%llu)")                          \
+   TRACE_EVENT_DEF(SYSTEM, SYSTEM_COND_BROADCAST,                       \
+                   "condBroadcast(): cond(%llu)")                       \
+   TRACE_EVENT_DEF(SYSTEM, SYSTEM_BARRIER_WAIT,                         \
+                   "barrierWait(): barrier(%llu)")                      \
+   TRACE_EVENT_DEF(SYSTEM, SYSTEM_BARRIER_RESPONSE,                     \
+                   "barrierResponse!: barrier(%llu), start_time(%llu ns)")
+
+enum TraceModuleId
+{
+#define TRACE_MODULE_DEF(id, name) TRACE_MODULE_##id,
+   TRACE_MODULE_LIST
+#undef TRACE_MODULE_DEF
+   NUM_TRACE_MODULES
+};
+
+enum TraceEventId
+{
+#define TRACE_EVENT_DEF(module_id, event_id, format) TRACE_##event_id,
+   TRACE_EVENT_LIST
+#undef TRACE_EVENT_DEF
+   NUM_TRACE_EVENTS
+};
+
+// Indexed with a constant event ID, so that the module is folded in at
+// compile time
+static const UInt8 TRACE_EVENT_MODULES[] =
+{
+#define TRACE_EVENT_DEF(module_id, event_id, format) TRACE_MODULE_##module_id,
+   TRACE_EVENT_LIST
+#undef TRACE_EVENT_DEF
+};
+
+// Binary trace file: a TraceFileHeader, then any number of blocks, each a
+// TraceBlockHeader followed by 'num_records' TraceRecords of one thread.
+
+struct TraceRecord
+{
+   UInt16 event;
+   UInt16 padding;
+   SInt32 tile_id;
+   UInt64 time;      // in nanoseconds
+   SInt64 args[3];
+};
+
+struct TraceFileHeader
+{
+   static const UInt32 MAGIC = 0x43525447;   // "GTRC"
+   static const UInt32 VERSION = 1;
+
+   UInt32 magic;
+   UInt32 version;
+   UInt32 record_size;
+   UInt32 num_events;
+};
+
+struct TraceBlockHeader
+{
+   UInt32 thread;
+   UInt32 num_records;
+   UInt64 num_dropped;   // records lost by this thread since its last block
+};
+
+#endif // TRACE_EVENTS_H
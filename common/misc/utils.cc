@@ -1,6 +1,7 @@
 #include <cmath>
 #include <cstring>
 #include <cassert>
+#include <sys/time.h>
 #include "utils.h"
 
 string myDecStr(UInt64 v, UInt32 w)
@@ -160,6 +161,13 @@ void splitIntoTokens(const string& line, vector<string>& tokens, const char* del
    }
 }
 
+UInt64 getWallClockTime()
+{
+   timeval t;
+   gettimeofday(&t, NULL);
+   return (((UInt64) t.tv_sec) * 1000000 + t.tv_usec);
+}
+
 double computeMean(const vector<UInt64>& vec)
 {
    double sigma_x = 0.0;
@@ -154,6 +154,9 @@ void parseList(const string& list, vector<string>& vec, string delim);
 
 void splitIntoTokens(const string& line, vector<string>& tokens, const char* delimiters);
 
+// Host wall clock time (in microseconds)
+UInt64 getWallClockTime();
+
 // Compute different statistics
 double computeMean(const vector<UInt64>& vec);
 double computeStddev(const vector<UInt64>& vec);
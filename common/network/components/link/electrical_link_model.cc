@@ -37,9 +37,12 @@ ElectricalLinkModel::processPacket(const NetPacket& pkt, UInt64& zero_load_delay
    // Update event counters
    UInt32 pkt_length = _model->getModeledLength(pkt); // pkt_length is in bits
    SInt32 num_flits = _model->computeNumFlits(pkt_length);
-   _total_link_traversals += num_flits;
+   __sync_fetch_and_add(&_total_link_traversals, num_flits);
    
    // Update dynamic energy
    if (Config::getSingleton()->getEnablePowerModeling())
+   {
+      ScopedLock sl(_power_model_lock);
       _power_model->updateDynamicEnergy(num_flits);
+   }
 }
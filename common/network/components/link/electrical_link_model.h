@@ -5,6 +5,7 @@ using std::string;
 
 #include "link_model.h"
 #include "fixed_types.h"
+#include "lock.h"
 #include "electrical_link_power_model.h"
 
 class NetPacket;
@@ -28,6 +29,7 @@ public:
 
 private:
    ElectricalLinkPowerModel* _power_model;
+   Lock _power_model_lock;
    
    // Event counters
    UInt64 _total_link_traversals;
@@ -4,6 +4,7 @@
 #include "utils.h"
 #include "queue_model_history_list.h"
 #include "queue_model_history_tree.h"
+#include "queue_model_history_btree.h"
 #include "log.h"
 #include "time_types.h"
 
@@ -13,6 +14,7 @@ RouterModel::RouterModel(NetworkModel* model, double frequency, double voltage,
                          bool contention_model_enabled, string& contention_model_type)
    : _model(model)
    , _frequency(frequency)
+   , _clock_period(frequency)
    , _num_input_ports(num_input_ports)
    , _num_output_ports(num_output_ports)
    , _delay(delay)
@@ -22,10 +24,17 @@ RouterModel::RouterModel(NetworkModel* model, double frequency, double voltage,
    if (_contention_model_enabled)
    {
       _contention_model_list.resize(_num_output_ports);
+      _contention_model_lock_list.resize(_num_output_ports);
       for (SInt32 i = 0; i < _num_output_ports; i++)
+      {
          _contention_model_list[i] = QueueModel::create(contention_model_type, /* UInt64 */ 1);
+         _contention_model_lock_list[i] = new Lock();
+      }
    }
 
+   for (SInt32 i = 0; i < _num_output_ports; i++)
+      _all_output_ports.push_back(i);
+
    initializeEventCounters();
    initializeContentionCounters();
    
@@ -44,7 +53,10 @@ RouterModel::~RouterModel()
    if (_contention_model_enabled)
    {
       for (SInt32 i = 0; i < _num_output_ports; i++)
+      {
          delete _contention_model_list[i];
+         delete _contention_model_lock_list[i];
+      }
    }
 }
 
@@ -52,29 +64,20 @@ void
 RouterModel::processPacket(const NetPacket& pkt, SInt32 output_port,
                            UInt64& zero_load_delay, UInt64& contention_delay)
 {
-   vector<SInt32> output_port_list;
-   
    if (output_port == OUTPUT_PORT_ALL)
-   {
-      for (SInt32 i = 0; i < _num_output_ports; i++)
-         output_port_list.push_back(i);
-   }
+      processPacket(pkt, &_all_output_ports[0], _num_output_ports, zero_load_delay, contention_delay);
    else // only 1 output port
-   {
-      output_port_list.push_back(output_port);
-   }
-
-   processPacket(pkt, output_port_list, zero_load_delay, contention_delay);
+      processPacket(pkt, &output_port, 1, zero_load_delay, contention_delay);
 }
 
 void
-RouterModel::processPacket(const NetPacket& pkt, vector<SInt32>& output_port_list,
-                                  UInt64& zero_load_delay, UInt64& contention_delay)
+RouterModel::processPacket(const NetPacket& pkt, const SInt32* output_port_list, SInt32 num_output_ports,
+                           UInt64& zero_load_delay, UInt64& contention_delay)
 {
    if (!_model->isModelEnabled(pkt))
       return;
 
-   assert( (1 <= (SInt32) output_port_list.size()) && (_num_output_ports >= (SInt32) output_port_list.size()) );
+   assert( (1 <= num_output_ports) && (_num_output_ports >= num_output_ports) );
 
    // Supposed to increment both zero_load_delay and contention_delay
    UInt32 packet_length = _model->getModeledLength(pkt); // packet_length is in bits
@@ -85,10 +88,14 @@ RouterModel::processPacket(const NetPacket& pkt, vector<SInt32>& output_port_lis
   
    if (_contention_model_enabled)
    {
+      UInt64 pkt_time = pkt.time.toCycles(_clock_period);
       UInt64 max_queue_delay = 0;
-      for (vector<SInt32>::iterator it = output_port_list.begin(); it != output_port_list.end(); it++)
+      for (SInt32 i = 0; i < num_output_ports; i++)
       {
-         UInt64 queue_delay = _contention_model_list[*it]->computeQueueDelay(pkt.time.toCycles(_frequency), num_flits);
+         SInt32 output_port = output_port_list[i];
+         _contention_model_lock_list[output_port]->acquire();
+         UInt64 queue_delay = _contention_model_list[output_port]->computeQueueDelay(pkt_time, num_flits);
+         _contention_model_lock_list[output_port]->release();
          max_queue_delay = max<UInt64>(max_queue_delay, queue_delay);
       }
 
@@ -96,15 +103,18 @@ RouterModel::processPacket(const NetPacket& pkt, vector<SInt32>& output_port_lis
       contention_delay += max_queue_delay;
 
       // Update Contention Counters
-      updateContentionCounters(max_queue_delay, output_port_list);
+      updateContentionCounters(max_queue_delay, output_port_list, num_output_ports);
    }
 
    // Update Event Counters
-   updateEventCounters(num_flits, output_port_list);
+   updateEventCounters(num_flits, num_output_ports);
 
    // Update Dynamic Energy Counters
    if (Config::getSingleton()->getEnablePowerModeling())
-      _power_model->updateDynamicEnergy(num_flits, 1, output_port_list.size());
+   {
+      ScopedLock sl(_power_model_lock);
+      _power_model->updateDynamicEnergy(num_flits, 1, num_output_ports);
+   }
 }
 
 void
@@ -117,13 +127,13 @@ RouterModel::initializeEventCounters()
 }
 
 void
-RouterModel::updateEventCounters(SInt32 num_flits, vector<SInt32>& output_port_list)
+RouterModel::updateEventCounters(SInt32 num_flits, SInt32 num_output_ports)
 {
    // Increment Event Counters
-   _total_buffer_writes += num_flits;
-   _total_buffer_reads += num_flits;
-   _total_switch_allocator_requests += 1;
-   _total_crossbar_traversals[output_port_list.size()-1] += num_flits;
+   __sync_fetch_and_add(&_total_buffer_writes, num_flits);
+   __sync_fetch_and_add(&_total_buffer_reads, num_flits);
+   __sync_fetch_and_add(&_total_switch_allocator_requests, 1);
+   __sync_fetch_and_add(&_total_crossbar_traversals[num_output_ports-1], num_flits);
 }
 
 void
@@ -134,12 +144,12 @@ RouterModel::initializeContentionCounters()
 }
 
 void
-RouterModel::updateContentionCounters(UInt64 contention_delay, vector<SInt32>& output_port_list)
+RouterModel::updateContentionCounters(UInt64 contention_delay, const SInt32* output_port_list, SInt32 num_output_ports)
 {
-   for (vector<SInt32>::iterator it = output_port_list.begin(); it != output_port_list.end(); it++)
+   for (SInt32 i = 0; i < num_output_ports; i++)
    {
-      _total_contention_delay[*it] += contention_delay;
-      _total_packets[*it] ++;
+      __sync_fetch_and_add(&_total_contention_delay[output_port_list[i]], contention_delay);
+      __sync_fetch_and_add(&_total_packets[output_port_list[i]], 1);
    }
 }
 
@@ -209,6 +219,11 @@ RouterModel::getPercentAnalyticalModelsUsed(SInt32 output_port_start, SInt32 out
          QueueModelHistoryTree* queue_model = (QueueModelHistoryTree*) _contention_model_list[i];
          total_analytical_model_requests += queue_model->getTotalRequestsUsingAnalyticalModel();
       }
+      else if (queue_model_type == QueueModel::HISTORY_BTREE)
+      {
+         QueueModelHistoryBTree* queue_model = (QueueModelHistoryBTree*) _contention_model_list[i];
+         total_analytical_model_requests += queue_model->getTotalRequestsUsingAnalyticalModel();
+      }
    }
 
    return (total_requests > 0) ? (((float) total_analytical_model_requests * 100) / total_requests) : 0.0;
@@ -6,6 +6,7 @@ using std::string;
 using std::vector;
 
 #include "fixed_types.h"
+#include "lock.h"
 #include "queue_model.h"
 #include "router_power_model.h"
 
@@ -23,7 +24,7 @@ public:
 
    void processPacket(const NetPacket& pkt, SInt32 output_port,
                       UInt64& zero_load_delay, UInt64& contention_delay);
-   void processPacket(const NetPacket& pkt, vector<SInt32>& output_port_list,
+   void processPacket(const NetPacket& pkt, const SInt32* output_port_list, SInt32 num_output_ports,
                       UInt64& zero_load_delay, UInt64& contention_delay);
    
    // Event Counters
@@ -49,11 +50,17 @@ public:
 private:
    NetworkModel* _model;
    double _frequency;
+   ClockPeriod _clock_period;
    SInt32 _num_input_ports;
    SInt32 _num_output_ports;
    UInt64 _delay;
    bool _contention_model_enabled;
    vector<QueueModel*> _contention_model_list;
+   // Packets going out of different ports only share the (atomic) counters,
+   // so each queue model has its own lock
+   vector<Lock*> _contention_model_lock_list;
+   // [0, _num_output_ports), for OUTPUT_PORT_ALL
+   vector<SInt32> _all_output_ports;
 
    // Event Counters
    UInt64 _total_buffer_writes;
@@ -63,6 +70,7 @@ private:
 
    // Energy Model
    RouterPowerModel* _power_model;
+   Lock _power_model_lock;
 
    // Contention Counters
    vector<UInt64> _total_contention_delay;
@@ -71,9 +79,9 @@ private:
    // Initialize Event Counters
    void initializeEventCounters();
    // Update Event Counters
-   void updateEventCounters(SInt32 num_flits, vector<SInt32>& output_port_list);
+   void updateEventCounters(SInt32 num_flits, SInt32 num_output_ports);
    // Initialize Contention Counters
    void initializeContentionCounters();
    // Update Contention Counters
-   void updateContentionCounters(UInt64 contention_delay, vector<SInt32>& output_port_list);
+   void updateContentionCounters(UInt64 contention_delay, const SInt32* output_port_list, SInt32 num_output_ports);
 };
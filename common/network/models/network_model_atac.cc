@@ -32,6 +32,9 @@ SInt32 NetworkModelAtac::_sub_cluster_width;
 SInt32 NetworkModelAtac::_sub_cluster_height;
 // Cluster Boundaries and Access Points
 vector<NetworkModelAtac::ClusterInfo> NetworkModelAtac::_cluster_info_list;
+// Routing tables
+vector<NetworkModelAtac::TileInfo> NetworkModelAtac::_tile_info_list;
+vector<UInt8> NetworkModelAtac::_global_route_table;
 // Type of Receive Network
 NetworkModelAtac::ReceiveNetType NetworkModelAtac::_receive_net_type;
 // Num Receive Nets
@@ -56,12 +59,16 @@ NetworkModelAtac::NetworkModelAtac(Network *net, SInt32 network_id)
 
    // Has Broadcast Capability
    _has_broadcast_capability = true;
+   _has_multicast_capability = false;
 
    // Initialize ANet topology
    initializeANetTopologyParams();
 
    // Initialize ENet, ONet and BNet parameters
    createANetRouterAndLinkModels();
+
+   // Compute the ENet routing table of this router
+   initializeENetRoutingTable();
 }
 
 NetworkModelAtac::~NetworkModelAtac()
@@ -123,6 +130,70 @@ NetworkModelAtac::initializeANetTopologyParams()
    _enet_height = _enet_width;
    
    initializeClusters();
+
+   initializeRoutingTables();
+}
+
+void
+NetworkModelAtac::initializeRoutingTables()
+{
+   SInt32 num_application_tiles = Config::getSingleton()->getApplicationTiles();
+
+   for (SInt32 i = 0; i < _num_clusters; i++)
+   {
+      getTileIDListInCluster(i, _cluster_info_list[i]._tile_id_list);
+      _cluster_info_list[i]._optical_hub = getTileIDWithOpticalHub(i);
+   }
+
+   _tile_info_list.resize(num_application_tiles);
+   for (tile_id_t tile_id = 0; tile_id < num_application_tiles; tile_id++)
+   {
+      TileInfo& tile_info = _tile_info_list[tile_id];
+      tile_info._cluster_id = getClusterID(tile_id);
+      tile_info._nearest_access_point = getNearestAccessPoint(tile_id);
+      tile_info._index_in_cluster = getIndexInList(tile_id, _cluster_info_list[tile_info._cluster_id]._tile_id_list);
+   }
+
+   // After _tile_info_list, computeGlobalRoute() looks up the clusters there
+   _global_route_table.resize(num_application_tiles * num_application_tiles);
+   for (tile_id_t sender = 0; sender < num_application_tiles; sender++)
+   {
+      for (tile_id_t receiver = 0; receiver < num_application_tiles; receiver++)
+         _global_route_table[sender * num_application_tiles + receiver] = computeGlobalRoute(sender, receiver);
+   }
+}
+
+void
+NetworkModelAtac::initializeENetRoutingTable()
+{
+   if (isSystemTile(_tile_id))
+      return;
+
+   SInt32 cx, cy;
+   computePositionOnENet(_tile_id, cx, cy);
+
+   SInt32 num_application_tiles = Config::getSingleton()->getApplicationTiles();
+   _enet_next_dest_table.resize(num_application_tiles);
+   for (tile_id_t receiver = 0; receiver < num_application_tiles; receiver++)
+   {
+      SInt32 dx, dy;
+      computePositionOnENet(receiver, dx, dy);
+
+      NextDest next_dest;
+      if (cx > dx)
+         next_dest = NextDest(computeTileIDOnENet(cx-1,cy), LEFT, EMESH);
+      else if (cx < dx)
+         next_dest = NextDest(computeTileIDOnENet(cx+1,cy), RIGHT, EMESH);
+      else if (cy > dy)
+         next_dest = NextDest(computeTileIDOnENet(cx,cy-1), DOWN, EMESH);
+      else if (cy < dy)
+         next_dest = NextDest(computeTileIDOnENet(cx,cy+1), UP, EMESH);
+      else // (cx == dx) && (cy == dy)
+         next_dest = NextDest(_tile_id, SELF, RECEIVE_TILE);
+
+      assert(0 <= next_dest._output_port && next_dest._output_port < (SInt32) _enet_link_list.size());
+      _enet_next_dest_table[receiver] = next_dest;
+   }
 }
 
 void
@@ -334,7 +405,7 @@ NetworkModelAtac::destroyANetRouterAndLinkModels()
 }
 
 void
-NetworkModelAtac::routePacket(const NetPacket& pkt, queue<Hop>& next_hops)
+NetworkModelAtac::routePacket(const NetPacket& pkt, HopVector& next_hops)
 {
    tile_id_t pkt_sender = TILE_ID(pkt.sender);
    tile_id_t pkt_receiver = TILE_ID(pkt.receiver);
@@ -347,13 +418,14 @@ NetworkModelAtac::routePacket(const NetPacket& pkt, queue<Hop>& next_hops)
       UInt64 contention_delay = 0;
       _injection_router->processPacket(pkt, 0, zero_load_delay, contention_delay);
       
-      Hop hop(pkt, _tile_id, EMESH, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+      Hop hop(pkt, _tile_id, EMESH, Latency(zero_load_delay,_clock_period), Latency(contention_delay,_clock_period));
       next_hops.push(hop);
    }
 
    else // (pkt.node_type != SEND_TILE) (In one of the intermediate routers)
    {
-      GlobalRoute global_route = computeGlobalRoute(pkt_sender, pkt_receiver);
+      GlobalRoute global_route = (pkt_receiver == NetPacket::BROADCAST) ? GLOBAL_ONET :
+         (GlobalRoute) _global_route_table[pkt_sender * _tile_info_list.size() + pkt_receiver];
       if (global_route == GLOBAL_ENET)
       {
          LOG_PRINT("Global Route: ENET");
@@ -368,47 +440,31 @@ NetworkModelAtac::routePacket(const NetPacket& pkt, queue<Hop>& next_hops)
 }
 
 void
-NetworkModelAtac::routePacketOnENet(const NetPacket& pkt, tile_id_t pkt_sender, tile_id_t pkt_receiver, queue<Hop>& next_hops)
+NetworkModelAtac::routePacketOnENet(const NetPacket& pkt, tile_id_t pkt_sender, tile_id_t pkt_receiver, HopVector& next_hops)
 {
    LOG_ASSERT_ERROR(pkt_receiver != NetPacket::BROADCAST, "Cannot broadcast packets on ENet");
 
-   SInt32 cx, cy, dx, dy;
-   computePositionOnENet(_tile_id, cx, cy);
-   computePositionOnENet(pkt_receiver, dx, dy); 
-
-   NextDest next_dest;
-
-   if (cx > dx)
-      next_dest = NextDest(computeTileIDOnENet(cx-1,cy), LEFT, EMESH);
-   else if (cx < dx)
-      next_dest = NextDest(computeTileIDOnENet(cx+1,cy), RIGHT, EMESH);
-   else if (cy > dy)
-      next_dest = NextDest(computeTileIDOnENet(cx,cy-1), DOWN, EMESH);
-   else if (cy < dy)
-      next_dest = NextDest(computeTileIDOnENet(cx,cy+1), UP, EMESH);
-   else // (cx == dx) && (cy == dy)
-      next_dest = NextDest(_tile_id, SELF, RECEIVE_TILE);
+   const NextDest& next_dest = _enet_next_dest_table[pkt_receiver];
 
    UInt64 zero_load_delay = 0;
    UInt64 contention_delay = 0;
 
    // Go through router and link
-   assert(0 <= next_dest._output_port && next_dest._output_port < (SInt32) _enet_link_list.size());
-
    _enet_router->processPacket(pkt, next_dest._output_port, zero_load_delay, contention_delay);
    _enet_link_list[next_dest._output_port]->processPacket(pkt, zero_load_delay);
 
-   Hop hop(pkt, next_dest._tile_id, next_dest._node_type, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+   Hop hop(pkt, next_dest._tile_id, next_dest._node_type, Latency(zero_load_delay,_clock_period), Latency(contention_delay,_clock_period));
    next_hops.push(hop);
 }
 
 void
-NetworkModelAtac::routePacketOnONet(const NetPacket& pkt, tile_id_t pkt_sender, tile_id_t pkt_receiver, queue<Hop>& next_hops)
+NetworkModelAtac::routePacketOnONet(const NetPacket& pkt, tile_id_t pkt_sender, tile_id_t pkt_receiver, HopVector& next_hops)
 {
    if (pkt.node_type == EMESH)
    {
-      assert(getClusterID(pkt_sender) == getClusterID(_tile_id));
-      if (isAccessPoint(_tile_id))
+      const TileInfo& tile_info = _tile_info_list[_tile_id];
+      assert(_tile_info_list[pkt_sender]._cluster_id == tile_info._cluster_id);
+      if (tile_info._nearest_access_point == _tile_id)
       {
          UInt64 zero_load_delay = 0;
          UInt64 contention_delay = 0;
@@ -416,12 +472,12 @@ NetworkModelAtac::routePacketOnONet(const NetPacket& pkt, tile_id_t pkt_sender,
          _enet_router->processPacket(pkt, _num_enet_router_ports, zero_load_delay, contention_delay);
          _enet_link_list[_num_enet_router_ports]->processPacket(pkt, zero_load_delay);
 
-         Hop hop(pkt, getTileIDWithOpticalHub(getClusterID(_tile_id)), SEND_HUB, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+         Hop hop(pkt, _cluster_info_list[tile_info._cluster_id]._optical_hub, SEND_HUB, Latency(zero_load_delay,_clock_period), Latency(contention_delay,_clock_period));
          next_hops.push(hop);
       }
       else // (!isAccessPoint(_tile_id))
       {
-         tile_id_t access_point = getNearestAccessPoint(pkt_sender);
+         tile_id_t access_point = _tile_info_list[pkt_sender]._nearest_access_point;
          routePacketOnENet(pkt, pkt_sender, access_point, next_hops);
       }
    }
@@ -440,7 +496,7 @@ NetworkModelAtac::routePacketOnONet(const NetPacket& pkt, tile_id_t pkt_sender,
             
             for (SInt32 i = 0; i < _num_clusters; i++)
             {
-               Hop hop(pkt, getTileIDWithOpticalHub(i), RECEIVE_HUB, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+               Hop hop(pkt, _cluster_info_list[i]._optical_hub, RECEIVE_HUB, Latency(zero_load_delay,_clock_period), Latency(contention_delay,_clock_period));
                next_hops.push(hop);
             }
          }
@@ -455,7 +511,7 @@ NetworkModelAtac::routePacketOnONet(const NetPacket& pkt, tile_id_t pkt_sender,
                _optical_link->processPacket(pkt, 1 /* send to only 1 endpoint */, zero_load_delay);
               
                LOG_PRINT("Cluster: %i, Contention delay: %llu", i, contention_delay); 
-               Hop hop(pkt, getTileIDWithOpticalHub(i), RECEIVE_HUB, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+               Hop hop(pkt, _cluster_info_list[i]._optical_hub, RECEIVE_HUB, Latency(zero_load_delay,_clock_period), Latency(contention_delay,_clock_period));
                next_hops.push(hop);
             }
          }
@@ -472,15 +528,14 @@ NetworkModelAtac::routePacketOnONet(const NetPacket& pkt, tile_id_t pkt_sender,
          _send_hub_router->processPacket(pkt, 0, zero_load_delay, contention_delay);
          _optical_link->processPacket(pkt, 1 /* send to only 1 endpoint */, zero_load_delay);
 
-         Hop hop(pkt, getTileIDWithOpticalHub(getClusterID(pkt_receiver)), RECEIVE_HUB, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+         Hop hop(pkt, _cluster_info_list[_tile_info_list[pkt_receiver]._cluster_id]._optical_hub, RECEIVE_HUB, Latency(zero_load_delay,_clock_period), Latency(contention_delay,_clock_period));
          next_hops.push(hop);
       }
    }
 
    else if (pkt.node_type == RECEIVE_HUB)
    {
-      vector<tile_id_t> tile_id_list;
-      getTileIDListInCluster(getClusterID(_tile_id), tile_id_list);
+      const vector<tile_id_t>& tile_id_list = _cluster_info_list[_tile_info_list[_tile_id]._cluster_id]._tile_id_list;
       assert(_cluster_size == (SInt32) tile_id_list.size());
 
       // get receive net id
@@ -515,7 +570,7 @@ NetworkModelAtac::routePacketOnONet(const NetPacket& pkt, tile_id_t pkt_sender,
          }
          else // (pkt_receiver != NetPacket::BROADCAST)
          {
-            SInt32 idx = getIndexInList(pkt_receiver, tile_id_list);
+            SInt32 idx = _tile_info_list[pkt_receiver]._index_in_cluster;
             assert(idx >= 0 && idx < (SInt32) _cluster_size);
 
             _star_net_router_list[receive_net_id]->processPacket(pkt, idx, zero_load_delay, contention_delay);
@@ -525,15 +580,15 @@ NetworkModelAtac::routePacketOnONet(const NetPacket& pkt, tile_id_t pkt_sender,
 
       if (pkt_receiver == NetPacket::BROADCAST)
       {
-         for (vector<tile_id_t>::iterator it = tile_id_list.begin(); it != tile_id_list.end(); it++)
+         for (vector<tile_id_t>::const_iterator it = tile_id_list.begin(); it != tile_id_list.end(); it++)
          {
-            Hop hop(pkt, *it, RECEIVE_TILE, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+            Hop hop(pkt, *it, RECEIVE_TILE, Latency(zero_load_delay,_clock_period), Latency(contention_delay,_clock_period));
             next_hops.push(hop);
          }
       }
       else // (pkt_receiver != NetPacket::BROADCAST)
       {
-         Hop hop(pkt, pkt_receiver, RECEIVE_TILE, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+         Hop hop(pkt, pkt_receiver, RECEIVE_TILE, Latency(zero_load_delay,_clock_period), Latency(contention_delay,_clock_period));
          next_hops.push(hop);
       }
    }
@@ -800,7 +855,7 @@ NetworkModelAtac::computeGlobalRoute(tile_id_t sender, tile_id_t receiver)
    if (receiver == NetPacket::BROADCAST)
       return GLOBAL_ONET;
 
-   if (getClusterID(sender) == getClusterID(receiver))
+   if (_tile_info_list[sender]._cluster_id == _tile_info_list[receiver]._cluster_id)
    {
       return GLOBAL_ENET;
    }
@@ -836,7 +891,7 @@ SInt32
 NetworkModelAtac::computeReceiveNetID(tile_id_t sender)
 {
    // This can be made random also if needed
-   SInt32 sending_cluster_id = getClusterID(sender);
+   SInt32 sending_cluster_id = _tile_info_list[sender]._cluster_id;
    return (sending_cluster_id % _num_receive_networks_per_cluster);
 }
 
@@ -21,7 +21,7 @@ public:
    NetworkModelAtac(Network *net, SInt32 network_id);
    ~NetworkModelAtac();
 
-   void routePacket(const NetPacket &pkt, queue<Hop> &nextHops);
+   void routePacket(const NetPacket &pkt, HopVector &nextHops);
 
    static bool isTileCountPermissible(SInt32 tile_count);
    static pair<bool, vector<tile_id_t> > computeMemoryControllerPositions(SInt32 num_memory_controllers, SInt32 tile_count);
@@ -103,9 +103,23 @@ private:
       };
       Boundary _boundary;
       vector<tile_id_t> _access_point_list;
+      vector<tile_id_t> _tile_id_list;
+      tile_id_t _optical_hub;
    };
 
    static vector<ClusterInfo> _cluster_info_list;
+
+   // Routing tables, computed at startup
+   class TileInfo
+   {
+   public:
+      SInt32 _cluster_id;
+      tile_id_t _nearest_access_point;
+      SInt32 _index_in_cluster;   // Index in the _tile_id_list of its cluster
+   };
+   static vector<TileInfo> _tile_info_list;
+   // Global route, indexed by [sender * num_application_tiles + receiver]
+   static vector<UInt8> _global_route_table;
    
    // Type of Receive Network
    static ReceiveNetType _receive_net_type;
@@ -142,11 +156,16 @@ private:
    vector<RouterModel*> _star_net_router_list;
    vector<vector<ElectricalLinkModel*> > _star_net_link_list;
 
+   // Next destination of a packet routed on the ENet at this router, indexed by the receiver
+   vector<NextDest> _enet_next_dest_table;
+
    // Private Functions
-   void routePacketOnENet(const NetPacket& pkt, tile_id_t sender, tile_id_t receiver, queue<Hop>& next_hops);
-   void routePacketOnONet(const NetPacket& pkt, tile_id_t sender, tile_id_t receiver, queue<Hop>& next_hops);
+   void routePacketOnENet(const NetPacket& pkt, tile_id_t sender, tile_id_t receiver, HopVector& next_hops);
+   void routePacketOnONet(const NetPacket& pkt, tile_id_t sender, tile_id_t receiver, HopVector& next_hops);
 
    static void initializeANetTopologyParams();
+   static void initializeRoutingTables();
+   void initializeENetRoutingTable();
    void createANetRouterAndLinkModels();
    void destroyANetRouterAndLinkModels();
   
@@ -176,6 +195,6 @@ private:
 
    // Routing
    static GlobalRoutingStrategy parseGlobalRoutingStrategy(string strategy);
-   GlobalRoute computeGlobalRoute(tile_id_t sender, tile_id_t receiver);
+   static GlobalRoute computeGlobalRoute(tile_id_t sender, tile_id_t receiver);
    static ReceiveNetType parseReceiveNetType(string receive_net_type);
 };
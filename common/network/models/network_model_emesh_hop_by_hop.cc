@@ -23,18 +23,33 @@ NetworkModelEMeshHopByHop::NetworkModelEMeshHopByHop(Network* net, SInt32 networ
 
       // Is broadcast tree enabled?
       _has_broadcast_capability = Sim()->getCfg()->getBool("network/emesh_hop_by_hop/broadcast_tree_enabled");
+      // Is multicast tree enabled?
+      _has_multicast_capability = Sim()->getCfg()->getBool("network/emesh_hop_by_hop/multicast_tree_enabled", false);
+      // Route packets through all the routers at the sender?
+      _routed_at_source = Sim()->getCfg()->getBool("network/emesh_hop_by_hop/route_at_source", false);
    }
    catch(...)
    {
       LOG_PRINT_ERROR("Could not read emesh_hop_by_hop parameters from the configuration file");
    }
 
+   // The routers of the other tiles have to be in this process
+   LOG_ASSERT_ERROR(!_routed_at_source || (Config::getSingleton()->getProcessCount() == 1),
+                    "Cannot route emesh_hop_by_hop packets at the source with (%i) processes",
+                    Config::getSingleton()->getProcessCount());
+
+   // Only the routers and links are touched when routing a packet
+   _has_thread_safe_routing = true;
+
    // Initialize Topology Params
    initializeEMeshTopologyParams();
 
    // Create Router & Link Models
    _num_mesh_router_ports = 5;
    createRouterAndLinkModels();
+
+   // Compute the routing tables
+   initializeRoutingTables();
 }
 
 NetworkModelEMeshHopByHop::~NetworkModelEMeshHopByHop()
@@ -143,7 +158,65 @@ NetworkModelEMeshHopByHop::destroyRouterAndLinkModels()
 }
 
 void
-NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, queue<Hop> &next_hops)
+NetworkModelEMeshHopByHop::initializeRoutingTables()
+{
+   if (isSystemTile(_tile_id))
+      return;
+
+   SInt32 cx, cy;
+   computePosition(_tile_id, cx, cy);
+
+   // Unicast (XY routing)
+   SInt32 num_application_tiles = Config::getSingleton()->getApplicationTiles();
+   _unicast_next_dest_table.resize(num_application_tiles);
+   for (tile_id_t receiver = 0; receiver < num_application_tiles; receiver++)
+   {
+      SInt32 dx, dy;
+      computePosition(receiver, dx, dy);
+
+      NextDest next_dest;
+      if (cx > dx)
+         next_dest = NextDest(computeTileID(cx-1,cy), LEFT, EMESH);
+      else if (cx < dx)
+         next_dest = NextDest(computeTileID(cx+1,cy), RIGHT, EMESH);
+      else if (cy > dy)
+         next_dest = NextDest(computeTileID(cx,cy-1), DOWN, EMESH);
+      else if (cy < dy)
+         next_dest = NextDest(computeTileID(cx,cy+1), UP, EMESH);
+      else
+         next_dest = NextDest(_tile_id, SELF, RECEIVE_TILE);
+
+      assert(next_dest._tile_id != INVALID_TILE_ID);
+      assert(next_dest._output_port >= 0 && next_dest._output_port < (SInt32) _mesh_link_list.size());
+      _unicast_next_dest_table[receiver] = next_dest;
+   }
+
+   // Broadcast: the packet goes up and down the column of the sender and,
+   // in the row of the sender, left and right as well
+   for (SInt32 y_sign = -1; y_sign <= 1; y_sign++)
+   {
+      for (SInt32 x_sign = -1; x_sign <= 1; x_sign++)
+      {
+         NextDestList& next_dest_list = _broadcast_next_dest_table[y_sign+1][x_sign+1];
+
+         if (y_sign >= 0)
+            next_dest_list.push(NextDest(computeTileID(cx,cy+1), UP, EMESH));
+         if (y_sign <= 0)
+            next_dest_list.push(NextDest(computeTileID(cx,cy-1), DOWN, EMESH));
+         if (y_sign == 0)
+         {
+            if (x_sign >= 0)
+               next_dest_list.push(NextDest(computeTileID(cx+1,cy), RIGHT, EMESH));
+            if (x_sign <= 0)
+               next_dest_list.push(NextDest(computeTileID(cx-1,cy), LEFT, EMESH));
+         }
+         next_dest_list.push(NextDest(_tile_id, SELF, RECEIVE_TILE));
+      }
+   }
+}
+
+void
+NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, HopVector &next_hops)
 {
    tile_id_t pkt_sender = TILE_ID(pkt.sender);
    tile_id_t pkt_receiver = TILE_ID(pkt.receiver);
@@ -154,7 +227,7 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, queue<Hop> &next_ho
       UInt64 contention_delay = 0;
       _injection_router->processPacket(pkt, 0, zero_load_delay, contention_delay);
       
-      Hop hop(pkt, _tile_id, EMESH, Latency(0,_frequency), Latency(contention_delay,_frequency));
+      Hop hop(pkt, _tile_id, EMESH, Latency(0,_clock_period), Latency(contention_delay,_clock_period));
       next_hops.push(hop);
    }
 
@@ -166,91 +239,30 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, queue<Hop> &next_ho
          computePosition(pkt_sender, sx, sy);
          computePosition(_tile_id, cx, cy);
 
-         list<NextDest> next_dest_list;
-
-         if (cy >= sy)
-            next_dest_list.push_back(NextDest(computeTileID(cx,cy+1), UP, EMESH));
-         if (cy <= sy)
-            next_dest_list.push_back(NextDest(computeTileID(cx,cy-1), DOWN, EMESH));
-         if (cy == sy)
-         {
-            if (cx >= sx)
-               next_dest_list.push_back(NextDest(computeTileID(cx+1,cy), RIGHT, EMESH));
-            if (cx <= sx)
-               next_dest_list.push_back(NextDest(computeTileID(cx-1,cy), LEFT, EMESH));
-         }
-         next_dest_list.push_back(NextDest(_tile_id, SELF, RECEIVE_TILE));
-
-         UInt64 zero_load_delay = 0;
-         UInt64 contention_delay = 0;
-        
-         // Get the link delay as well as a vector of directions
-         // Remove the tile_ids' that are invalid
-         UInt64 max_link_delay = 0;
-         vector<SInt32> output_port_list;
-         for (list<NextDest>::iterator it = next_dest_list.begin(); it != next_dest_list.end(); )
-         {
-            if ((*it)._tile_id != INVALID_TILE_ID)
-            {
-               SInt32 output_port = (*it)._output_port;
-               output_port_list.push_back(output_port);
-            
-               UInt64 link_delay = 0;
-               _mesh_link_list[output_port]->processPacket(pkt, link_delay);
-               max_link_delay = max<UInt64>(max_link_delay, link_delay);
-
-               it ++;
-            }
-            else
-            {
-               it = next_dest_list.erase(it);
-            }
-         }
-         // Update the zero_load_delay
-         zero_load_delay += max_link_delay;
-
-         // Get the router to process the packet
-         _mesh_router->processPacket(pkt, output_port_list, zero_load_delay, contention_delay);
-
-         // Populate the next_hops queue
-         for (list<NextDest>::iterator it = next_dest_list.begin(); it != next_dest_list.end(); it++)
-         {
-            Hop hop(pkt, (*it)._tile_id, (*it)._node_type, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
-            next_hops.push(hop);
-         }
+         const NextDestList& next_dest_list = _broadcast_next_dest_table[(cy > sy) - (cy < sy) + 1][(cx > sx) - (cx < sx) + 1];
+         routePacketToNextDests(pkt, next_dest_list, next_hops);
       }
 
-      else // (pkt_receiver != NetPacket::BROADCAST)
+      else if (pkt_receiver == NetPacket::MULTICAST)
       {
-         SInt32 cx, cy, dx, dy;
-         computePosition(_tile_id, cx, cy);
-         computePosition(pkt_receiver, dx, dy);
-
-         NextDest next_dest;
+         NextDestList next_dest_list;
+         computeMulticastNextDests(pkt, next_dest_list);
+         routePacketToNextDests(pkt, next_dest_list, next_hops);
+      }
 
-         if (cx > dx)
-            next_dest = NextDest(computeTileID(cx-1,cy), LEFT, EMESH);
-         else if (cx < dx)
-            next_dest = NextDest(computeTileID(cx+1,cy), RIGHT, EMESH);
-         else if (cy > dy)
-            next_dest = NextDest(computeTileID(cx,cy-1), DOWN, EMESH);
-         else if (cy < dy)
-            next_dest = NextDest(computeTileID(cx,cy+1), UP, EMESH);
-         else
-            next_dest = NextDest(_tile_id, SELF, RECEIVE_TILE);
+      else // (pkt_receiver != NetPacket::BROADCAST) && (pkt_receiver != NetPacket::MULTICAST)
+      {
+         const NextDest& next_dest = _unicast_next_dest_table[pkt_receiver];
 
          UInt64 zero_load_delay = 0;
          UInt64 contention_delay = 0;
 
-         assert(next_dest._output_port >= 0 && next_dest._output_port < (SInt32) _mesh_link_list.size());
-
          // Go through router
          _mesh_router->processPacket(pkt, next_dest._output_port, zero_load_delay, contention_delay);
          // Go through link
          _mesh_link_list[next_dest._output_port]->processPacket(pkt, zero_load_delay);
 
-         assert(next_dest._tile_id != INVALID_TILE_ID);
-         Hop hop(pkt, next_dest._tile_id, next_dest._node_type, Latency(zero_load_delay,_frequency), Latency(contention_delay,_frequency));
+         Hop hop(pkt, next_dest._tile_id, next_dest._node_type, Latency(zero_load_delay,_clock_period), Latency(contention_delay,_clock_period));
          next_hops.push(hop);
       
       } // (pkt_receiver == NetPacket::BROADCAST)
@@ -263,6 +275,90 @@ NetworkModelEMeshHopByHop::routePacket(const NetPacket &pkt, queue<Hop> &next_ho
    }
 }
 
+void
+NetworkModelEMeshHopByHop::routePacketToNextDests(const NetPacket& pkt, const NextDestList& next_dest_list, HopVector& next_hops)
+{
+   UInt64 zero_load_delay = 0;
+   UInt64 contention_delay = 0;
+  
+   // Get the link delay as well as a vector of directions
+   UInt64 max_link_delay = 0;
+   SInt32 output_port_list[UP + 1];
+   for (UInt32 i = 0; i < next_dest_list._size; i++)
+   {
+      SInt32 output_port = next_dest_list._next_dests[i]._output_port;
+      output_port_list[i] = output_port;
+      
+      UInt64 link_delay = 0;
+      _mesh_link_list[output_port]->processPacket(pkt, link_delay);
+      max_link_delay = max<UInt64>(max_link_delay, link_delay);
+   }
+   // Update the zero_load_delay
+   zero_load_delay += max_link_delay;
+
+   // Get the router to process the packet
+   _mesh_router->processPacket(pkt, output_port_list, next_dest_list._size, zero_load_delay, contention_delay);
+
+   // Populate the next_hops queue
+   for (UInt32 i = 0; i < next_dest_list._size; i++)
+   {
+      const NextDest& next_dest = next_dest_list._next_dests[i];
+      Hop hop(pkt, next_dest._tile_id, next_dest._node_type, Latency(zero_load_delay,_clock_period), Latency(contention_delay,_clock_period));
+      next_hops.push(hop);
+   }
+}
+
+void
+NetworkModelEMeshHopByHop::computeMulticastNextDests(const NetPacket& pkt, NextDestList& next_dest_list)
+{
+   // The multicast tree is the union of the XY routes from the sender to
+   // each receiver, so a router only has to look at the receivers whose
+   // route passes through it
+   SInt32 sx, sy, cx, cy;
+   computePosition(TILE_ID(pkt.sender), sx, sy);
+   computePosition(_tile_id, cx, cy);
+
+   bool output_port_used[UP + 1];
+   for (SInt32 i = SELF; i <= UP; i++)
+      output_port_used[i] = false;
+
+   for (UInt32 i = 0; i < pkt.num_multicast_receivers; i++)
+   {
+      SInt32 dx, dy;
+      computePosition(pkt.multicast_receivers[i], dx, dy);
+
+      bool on_x_segment = (cy == sy) && (min<SInt32>(sx,dx) <= cx) && (cx <= max<SInt32>(sx,dx));
+      bool on_y_segment = (cx == dx) && (min<SInt32>(sy,dy) <= cy) && (cy <= max<SInt32>(sy,dy));
+      if (!on_x_segment && !on_y_segment)
+         continue;
+
+      if (cx > dx)
+         output_port_used[LEFT] = true;
+      else if (cx < dx)
+         output_port_used[RIGHT] = true;
+      else if (cy > dy)
+         output_port_used[DOWN] = true;
+      else if (cy < dy)
+         output_port_used[UP] = true;
+      else
+         output_port_used[SELF] = true;
+   }
+
+   if (output_port_used[UP])
+      next_dest_list.push(NextDest(computeTileID(cx,cy+1), UP, EMESH));
+   if (output_port_used[DOWN])
+      next_dest_list.push(NextDest(computeTileID(cx,cy-1), DOWN, EMESH));
+   if (output_port_used[RIGHT])
+      next_dest_list.push(NextDest(computeTileID(cx+1,cy), RIGHT, EMESH));
+   if (output_port_used[LEFT])
+      next_dest_list.push(NextDest(computeTileID(cx-1,cy), LEFT, EMESH));
+   if (output_port_used[SELF])
+      next_dest_list.push(NextDest(_tile_id, SELF, RECEIVE_TILE));
+
+   LOG_ASSERT_ERROR(next_dest_list._size > 0, "Multicast packet from tile(%i) reached tile(%i) off its tree",
+                    TILE_ID(pkt.sender), _tile_id);
+}
+
 void
 NetworkModelEMeshHopByHop::computePosition(tile_id_t tile_id, SInt32 &x, SInt32 &y)
 {
@@ -63,8 +63,33 @@ private:
    RouterModel* _mesh_router;
    vector<ElectricalLinkModel*> _mesh_link_list;
 
+   // Next destinations of a packet at this router (the ones off the mesh are left out)
+   class NextDestList
+   {
+   public:
+      NextDestList() : _size(0) {}
+      void push(const NextDest& next_dest)
+      {
+         if (next_dest._tile_id != INVALID_TILE_ID)
+            _next_dests[_size++] = next_dest;
+      }
+
+      NextDest _next_dests[UP + 1];
+      UInt32 _size;
+   };
+
+   // Routing tables of this router, computed at startup
+   // |---- Next destination of a unicast packet, indexed by the receiver
+   vector<NextDest> _unicast_next_dest_table;
+   // |---- Branches of the broadcast tree, indexed by where the sender is
+   //       relative to this router: [sign(y - sender_y) + 1][sign(x - sender_x) + 1]
+   NextDestList _broadcast_next_dest_table[3][3];
+
    // Routing Function
-   void routePacket(const NetPacket &pkt, queue<Hop> &next_hops);
+   void routePacket(const NetPacket &pkt, HopVector &next_hops);
+   void routePacketToNextDests(const NetPacket& pkt, const NextDestList& next_dest_list, HopVector& next_hops);
+   void computeMulticastNextDests(const NetPacket& pkt, NextDestList& next_dest_list);
+   void initializeRoutingTables();
   
    // DVFS 
    void setDVFS(double frequency, double voltage, const Time& curr_time);
@@ -33,8 +33,12 @@ NetworkModelEMeshHopCounter::NetworkModelEMeshHopCounter(Network *net, SInt32 ne
 
    // Broadcast Capability
    _has_broadcast_capability = false;
+   _has_multicast_capability = false;
 
    createRouterAndLinkModels();
+
+   // Compute the number of hops to every receiver
+   initializeRoutingTable();
    
    // Initialize event counters
    initializeEventCounters();
@@ -106,6 +110,25 @@ NetworkModelEMeshHopCounter::destroyRouterAndLinkModels()
    }
 }
 
+void
+NetworkModelEMeshHopCounter::initializeRoutingTable()
+{
+   if (isSystemTile(_tile_id))
+      return;
+
+   SInt32 sx, sy;
+   computePosition(_tile_id, sx, sy);
+
+   SInt32 num_application_tiles = Config::getSingleton()->getApplicationTiles();
+   _num_hops_table.resize(num_application_tiles);
+   for (tile_id_t receiver = 0; receiver < num_application_tiles; receiver++)
+   {
+      SInt32 dx, dy;
+      computePosition(receiver, dx, dy);
+      _num_hops_table[receiver] = computeDistance(sx, sy, dx, dy);
+   }
+}
+
 void
 NetworkModelEMeshHopCounter::initializeEventCounters()
 {
@@ -140,15 +163,12 @@ NetworkModelEMeshHopCounter::computeDistance(SInt32 x1, SInt32 y1, SInt32 x2, SI
 }
 
 void
-NetworkModelEMeshHopCounter::routePacket(const NetPacket &pkt, queue<Hop> &next_hops)
+NetworkModelEMeshHopCounter::routePacket(const NetPacket &pkt, HopVector &next_hops)
 {
-   SInt32 sx, sy, dx, dy;
-
-   computePosition(TILE_ID(pkt.sender), sx, sy);
-   computePosition(TILE_ID(pkt.receiver), dx, dy);
+   assert(TILE_ID(pkt.sender) == _tile_id);
 
-   UInt32 num_hops = computeDistance(sx, sy, dx, dy);
-   Latency latency = (isModelEnabled(pkt)) ? Latency(num_hops * _hop_latency,_frequency) : Latency(0,_frequency);
+   UInt32 num_hops = _num_hops_table[TILE_ID(pkt.receiver)];
+   Latency latency = (isModelEnabled(pkt)) ? Latency(num_hops * _hop_latency,_clock_period) : Latency(0,_clock_period);
 
    updateDynamicEnergy(pkt, num_hops);
 
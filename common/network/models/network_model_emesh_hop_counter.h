@@ -12,7 +12,7 @@ public:
    NetworkModelEMeshHopCounter(Network *net, SInt32 network_id);
    ~NetworkModelEMeshHopCounter();
 
-   void routePacket(const NetPacket &pkt, queue<Hop> &next_hops);
+   void routePacket(const NetPacket &pkt, HopVector &next_hops);
    void outputSummary(std::ostream &out, const Time& target_completion_time);
 
    // Energy computation
@@ -31,6 +31,8 @@ private:
    ElectricalLinkPowerModel* _electrical_link_power_model;
    // Latency parameters
    UInt64 _hop_latency;
+   // Number of hops from this tile, indexed by the receiver
+   vector<UInt32> _num_hops_table;
 
    // Event counters
    UInt64 _buffer_writes;
@@ -44,6 +46,7 @@ private:
    
    // Create/destroy router/link models
    void createRouterAndLinkModels();
+   void initializeRoutingTable();
    void initializeEventCounters();
    void destroyRouterAndLinkModels();
    
@@ -7,16 +7,17 @@ NetworkModelMagic::NetworkModelMagic(Network *net, SInt32 network_id)
 {
    _flit_width = -1;
    _has_broadcast_capability = false;
+   _has_multicast_capability = false;
 }
 
 NetworkModelMagic::~NetworkModelMagic()
 {}
 
 void
-NetworkModelMagic::routePacket(const NetPacket &pkt, queue<Hop> &next_hops)
+NetworkModelMagic::routePacket(const NetPacket &pkt, HopVector &next_hops)
 {
    LOG_PRINT("Entering routePacket");
    // A latency of '1'
-   Hop hop(pkt, TILE_ID(pkt.receiver), RECEIVE_TILE, Latency(1,_frequency), Latency(0,_frequency));
+   Hop hop(pkt, TILE_ID(pkt.receiver), RECEIVE_TILE, Latency(1,_clock_period), Latency(0,_clock_period));
    next_hops.push(hop);
 }
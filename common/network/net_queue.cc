@@ -0,0 +1,207 @@
+#include "net_queue.h"
+#include "tile.h"
+#include "log.h"
+
+NetQueue::NetQueue(SInt32 num_tiles)
+   : _num_tiles(num_tiles)
+   , _next_seq_num(0)
+   , _sender_lists(num_tiles, (List*) NULL)
+   , _free_entries(NULL)
+{}
+
+NetQueue::~NetQueue()
+{
+   Entry* entry = _global_list.head;
+   while (entry)
+   {
+      Entry* next = entry->next[GLOBAL_LIST];
+      delete entry;
+      entry = next;
+   }
+   while (_free_entries)
+   {
+      Entry* next = _free_entries->next[GLOBAL_LIST];
+      delete _free_entries;
+      _free_entries = next;
+   }
+   for (SInt32 i = 0; i < _num_tiles; i++)
+      delete _sender_lists[i];
+}
+
+void NetQueue::push(const NetPacket& packet)
+{
+   LOG_ASSERT_ERROR(0 <= packet.sender.tile_id && packet.sender.tile_id < _num_tiles,
+                    "Invalid Packet Sender(%i)", packet.sender.tile_id);
+   LOG_ASSERT_ERROR(0 <= packet.type && packet.type < NUM_PACKET_TYPES,
+                    "Invalid Packet Type(%i)", packet.type);
+
+   Entry* entry;
+   if (_free_entries)
+   {
+      entry = _free_entries;
+      _free_entries = entry->next[GLOBAL_LIST];
+   }
+   else
+   {
+      entry = new Entry;
+   }
+   entry->packet = packet;
+   entry->seq_num = _next_seq_num ++;
+
+   List*& sender_list = _sender_lists[packet.sender.tile_id];
+   if (sender_list == NULL)
+      sender_list = new List();
+
+   link(_global_list, GLOBAL_LIST, entry);
+   link(*sender_list, SENDER_LIST, entry);
+   link(_type_lists[packet.type], TYPE_LIST, entry);
+}
+
+bool NetQueue::pop(const NetMatch& match, core_id_t receiver, NetPacket& packet)
+{
+   Entry* found = NULL;
+
+   // Pick the family of lists that holds the fewest packets. Any of them
+   // contains every candidate, since the full match is checked per entry.
+   bool use_sender_lists = !match.senders.empty();
+   if (use_sender_lists && !match.types.empty())
+   {
+      UInt32 sender_lists_size = 0;
+      for (UInt32 i = 0; i < match.senders.size(); i++)
+      {
+         List* list = getSenderList(match.senders[i].tile_id);
+         sender_lists_size += (list) ? list->size : 0;
+      }
+      UInt32 type_lists_size = 0;
+      for (UInt32 i = 0; i < match.types.size(); i++)
+      {
+         if (0 <= match.types[i] && match.types[i] < NUM_PACKET_TYPES)
+            type_lists_size += _type_lists[match.types[i]].size;
+      }
+      use_sender_lists = (sender_lists_size <= type_lists_size);
+   }
+
+   if (use_sender_lists)
+   {
+      for (UInt32 i = 0; i < match.senders.size(); i++)
+         found = older(found, findFirst(getSenderList(match.senders[i].tile_id), SENDER_LIST, match, receiver));
+   }
+   else if (!match.types.empty())
+   {
+      for (UInt32 i = 0; i < match.types.size(); i++)
+      {
+         if (0 <= match.types[i] && match.types[i] < NUM_PACKET_TYPES)
+            found = older(found, findFirst(&_type_lists[match.types[i]], TYPE_LIST, match, receiver));
+      }
+   }
+   else
+   {
+      found = findFirst(&_global_list, GLOBAL_LIST, match, receiver);
+   }
+
+   if (found == NULL)
+      return false;
+
+   packet = found->packet;
+
+   unlink(_global_list, GLOBAL_LIST, found);
+   unlink(*_sender_lists[found->packet.sender.tile_id], SENDER_LIST, found);
+   unlink(_type_lists[found->packet.type], TYPE_LIST, found);
+
+   found->next[GLOBAL_LIST] = _free_entries;
+   _free_entries = found;
+
+   return true;
+}
+
+bool NetQueue::matches(const NetPacket& packet, const NetMatch& match, core_id_t receiver)
+{
+   // make sure that this core is the proper destination core for this tile
+   if ( (packet.receiver.tile_id != receiver.tile_id || packet.receiver.core_type != receiver.core_type) &&
+        (packet.receiver.tile_id != NetPacket::BROADCAST) )
+   {
+      return false;
+   }
+
+   if (match.senders.empty())
+   {
+      // An empty sender list matches the main core of every tile
+      if (packet.sender.core_type != MAIN_CORE_TYPE)
+         return false;
+   }
+   else
+   {
+      bool sender_found = false;
+      for (UInt32 i = 0; (i < match.senders.size()) && !sender_found; i++)
+      {
+         sender_found = (packet.sender.tile_id == match.senders[i].tile_id) &&
+                        (packet.sender.core_type == match.senders[i].core_type);
+      }
+      if (!sender_found)
+         return false;
+   }
+
+   if (!match.types.empty())
+   {
+      bool type_found = false;
+      for (UInt32 i = 0; (i < match.types.size()) && !type_found; i++)
+         type_found = (packet.type == match.types[i]);
+      if (!type_found)
+         return false;
+   }
+
+   return true;
+}
+
+NetQueue::List* NetQueue::getSenderList(tile_id_t sender) const
+{
+   if (sender < 0 || sender >= _num_tiles)
+      return NULL;
+   return _sender_lists[sender];
+}
+
+void NetQueue::link(List& list, ListId id, Entry* entry)
+{
+   entry->prev[id] = list.tail;
+   entry->next[id] = NULL;
+   if (list.tail)
+      list.tail->next[id] = entry;
+   else
+      list.head = entry;
+   list.tail = entry;
+   list.size ++;
+}
+
+void NetQueue::unlink(List& list, ListId id, Entry* entry)
+{
+   if (entry->prev[id])
+      entry->prev[id]->next[id] = entry->next[id];
+   else
+      list.head = entry->next[id];
+   if (entry->next[id])
+      entry->next[id]->prev[id] = entry->prev[id];
+   else
+      list.tail = entry->prev[id];
+   list.size --;
+}
+
+NetQueue::Entry* NetQueue::findFirst(const List* list, ListId id, const NetMatch& match, core_id_t receiver) const
+{
+   if (list == NULL)
+      return NULL;
+   for (Entry* entry = list->head; entry != NULL; entry = entry->next[id])
+   {
+      if (matches(entry->packet, match, receiver))
+         return entry;
+   }
+   return NULL;
+}
+
+NetQueue::Entry* NetQueue::older(Entry* a, Entry* b)
+{
+   if (a == NULL)
+      return b;
+   if (b == NULL)
+      return a;
+   return (a->seq_num < b->seq_num) ? a : b;
+}
@@ -0,0 +1,81 @@
+#ifndef NET_QUEUE_H
+#define NET_QUEUE_H
+
+#include <vector>
+using std::vector;
+
+#include "fixed_types.h"
+#include "packet_type.h"
+#include "network.h"
+
+// Indexed store for the packets that are waiting to be picked up by
+// Network::netRecv(). Every packet is linked into three FIFO lists at
+// once: the global list, the list of its sender and the list of its type.
+// A match only walks the lists selected by the NetMatch (and for each list
+// almost always stops at the head), so receiving a packet no longer costs
+// a scan of the whole queue. Packets are stamped with an arrival sequence
+// number so that the oldest matching packet is returned, exactly like the
+// linear scan this replaces.
+//
+// NetQueue is not thread-safe. The caller (Network) holds _netQueueLock.
+
+class NetQueue
+{
+public:
+   NetQueue(SInt32 num_tiles);
+   ~NetQueue();
+
+   void push(const NetPacket& packet);
+   // Removes the oldest packet that matches 'match' (with the receiver
+   // already resolved to 'receiver') and copies it into 'packet'
+   bool pop(const NetMatch& match, core_id_t receiver, NetPacket& packet);
+
+   bool empty() const { return (_global_list.head == NULL); }
+   UInt32 size() const { return _global_list.size; }
+
+   static bool matches(const NetPacket& packet, const NetMatch& match, core_id_t receiver);
+
+private:
+   enum ListId
+   {
+      GLOBAL_LIST = 0,
+      SENDER_LIST,
+      TYPE_LIST,
+      NUM_LISTS
+   };
+
+   struct Entry
+   {
+      NetPacket packet;
+      UInt64 seq_num;
+      Entry* prev[NUM_LISTS];
+      Entry* next[NUM_LISTS];
+   };
+
+   struct List
+   {
+      List() : head(NULL), tail(NULL), size(0) {}
+      Entry* head;
+      Entry* tail;
+      UInt32 size;
+   };
+
+   SInt32 _num_tiles;
+   UInt64 _next_seq_num;
+
+   List _global_list;
+   // Per-sender lists are only allocated when a sender first shows up
+   vector<List*> _sender_lists;
+   List _type_lists[NUM_PACKET_TYPES];
+
+   // Recycled entries, so that steady-state traffic does not hit the allocator
+   Entry* _free_entries;
+
+   List* getSenderList(tile_id_t sender) const;
+   void link(List& list, ListId id, Entry* entry);
+   void unlink(List& list, ListId id, Entry* entry);
+   Entry* findFirst(const List* list, ListId id, const NetMatch& match, core_id_t receiver) const;
+   static Entry* older(Entry* a, Entry* b);
+};
+
+#endif // NET_QUEUE_H
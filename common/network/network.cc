@@ -3,6 +3,8 @@
 #include "tile.h"
 #include "core_model.h"
 #include "network.h"
+#include "net_queue.h"
+#include "packet_buffer.h"
 #include "memory_manager.h"
 #include "simulator.h"
 #include "tile_manager.h"
@@ -11,6 +13,7 @@
 #include "statistics_manager.h"
 #include "utils.h"
 #include "log.h"
+#include "event_tracer.h"
 
 using namespace std;
 
@@ -29,6 +32,14 @@ Network::Network(Tile *tile)
 
    _transport = Transport::getSingleton()->createNode(_tile->getId());
 
+   _netQueue = new NetQueue(_numMod);
+   _packetBufferPool = new PacketBufferPool();
+
+   _numPacketsSent = 0;
+   _bytesSerialized = 0;
+   _bytesSentToTransport = 0;
+   _bytesCopiedOnReceive = 0;
+
    _callbacks = new NetworkCallback [NUM_PACKET_TYPES];
    _callbackObjs = new void* [NUM_PACKET_TYPES];
    for (SInt32 i = 0; i < NUM_PACKET_TYPES; i++)
@@ -59,6 +70,9 @@ Network::~Network()
    delete [] _callbackObjs;
    delete [] _callbacks;
 
+   delete _netQueue;
+   delete _packetBufferPool;
+
    delete _transport;
 
    LOG_PRINT("Destroyed Network.");
@@ -86,6 +100,17 @@ void Network::outputSummary(std::ostream &out, const Time& target_completion_tim
       out << "  Network (" <<  _models[i]->getNetworkName() << "): " << endl;
       _models[i]->outputSummary(out, target_completion_time);
    }
+
+   UInt64 total_bytes_copied = _bytesSerialized + _bytesSentToTransport + _bytesCopiedOnReceive;
+   out << "  Packet Copies: " << endl;
+   out << "    Total Packets Sent: " << _numPacketsSent << endl;
+   out << "    Bytes Serialized: " << _bytesSerialized << endl;
+   out << "    Bytes Sent to Transport: " << _bytesSentToTransport << endl;
+   out << "    Bytes Copied on Receive: " << _bytesCopiedOnReceive << endl;
+   if (_numPacketsSent > 0)
+      out << "    Average Bytes Copied per Packet: " << ((float) total_bytes_copied) / _numPacketsSent << endl;
+   else
+      out << "    Average Bytes Copied per Packet: 0" << endl;
 }
 
 // Polling function that performs background activities, such as
@@ -98,10 +123,16 @@ void Network::netPullFromTransport()
    {
       LOG_PRINT("Entering netPullFromTransport");
 
-      NetPacket packet(_transport->recv());
+      // Only the header is copied out of the transport buffer for now; where
+      // the payload goes depends on who consumes the packet
+      Byte* buffer = _transport->recv();
+      NetPacket packet = *((NetPacket*) buffer);
+      packet.data = (packet.length > 0) ? buffer + sizeof(NetPacket) : NULL;
+      if (packet.num_multicast_receivers > 0)
+         packet.multicast_receivers = (tile_id_t*) (buffer + sizeof(NetPacket) + packet.length);
 
-      LOG_PRINT("Pull packet : type %i, from (%i, %i), time %llu",
-                (SInt32)packet.type, packet.sender.tile_id, packet.sender.core_type, packet.time.toNanosec());
+      TRACE_EVENT(NETWORK_PULL, _tile->getId(), packet.time.toNanosec(),
+                  packet.type, packet.sender.tile_id, 0);
       LOG_ASSERT_ERROR(0 <= packet.sender.tile_id && packet.sender.tile_id < _numMod,
                        "Invalid Packet Sender(%i)", packet.sender);
       LOG_ASSERT_ERROR(0 <= packet.type && packet.type < NUM_PACKET_TYPES,
@@ -111,6 +142,14 @@ void Network::netPullFromTransport()
    
       if (model->isPacketReadyToBeReceived(packet))   // Receive Packet
       {
+         // A multicast packet is delivered as if it had been sent to this tile alone
+         if (TILE_ID(packet.receiver) == NetPacket::MULTICAST)
+         {
+            packet.receiver = Tile::getMainCoreId(_tile->getId());
+            packet.num_multicast_receivers = 0;
+            packet.multicast_receivers = NULL;
+         }
+
          // I have accepted the packet - process the received packet
          model->__processReceivedPacket(packet);
          
@@ -119,48 +158,63 @@ void Network::netPullFromTransport()
 
          if (callback != NULL)
          {
-            LOG_PRINT("Executing callback on packet : type %i, from (%i, %i), to (%i, %i), tile_id %i, time %llu", 
-                      (SInt32) packet.type, packet.sender.tile_id, packet.sender.core_type,
-                      packet.receiver.tile_id, packet.receiver.core_type,
-                      _tile->getId(), packet.time.toNanosec());
+            TRACE_EVENT(NETWORK_CALLBACK, _tile->getId(), packet.time.toNanosec(),
+                        packet.type, packet.sender.tile_id, packet.receiver.tile_id);
             assert(0 <= packet.sender.tile_id && packet.sender.tile_id < _numMod);
             assert(0 <= packet.type && packet.type < NUM_PACKET_TYPES);
 
+            // Callbacks do not keep the payload around, so they read it
+            // straight out of the transport buffer
             callback(_callbackObjs[packet.type], packet);
 
-            // De-allocate packet payload
-            if (packet.length > 0)
-               delete [] (Byte*) packet.data;
+            _transport->releaseBuffer(buffer);
          }
 
          // synchronous I/O support
          else
          {
-            LOG_PRINT("Enqueuing packet : type %i, from (%i, %i), to (%i, %i), tile_id %i, time %llu",
-                      (SInt32)packet.type, packet.sender.tile_id, packet.sender.core_type,
-                      packet.receiver.tile_id, packet.receiver.core_type,
-                      _tile->getId(), packet.time.toNanosec());
+            TRACE_EVENT(NETWORK_ENQUEUE, _tile->getId(), packet.time.toNanosec(),
+                        packet.type, packet.sender.tile_id, packet.receiver.tile_id);
+
+            // The receiver owns (and deletes) the payload of a queued packet
+            if (packet.length > 0)
+            {
+               Byte* data_buffer = new Byte[packet.length];
+               memcpy(data_buffer, packet.data, packet.length);
+               packet.data = data_buffer;
+               __sync_fetch_and_add(&_bytesCopiedOnReceive, packet.length);
+            }
+            _transport->releaseBuffer(buffer);
 
             _netQueueLock.acquire();
-            _netQueue.push_back(packet);
-            _netQueueLock.release();
+            _netQueue->push(packet);
 
-            _netQueueCond.broadcast();
+            // Wake up only the receivers that are waiting for this packet
+            for (list<NetRecvWaiter*>::iterator it = _netRecvWaiters.begin(); it != _netRecvWaiters.end(); )
+            {
+               NetRecvWaiter* waiter = *it;
+               if (NetQueue::matches(packet, *waiter->match, waiter->receiver))
+               {
+                  it = _netRecvWaiters.erase(it);
+                  waiter->cond.signal();
+               }
+               else
+               {
+                  it ++;
+               }
+            }
+            _netQueueLock.release();
          }
       }
 
       else // Forward Packet
       { 
-         LOG_PRINT("Forwarding packet : type %i, from (%i, %i), to (%i, %i), tile_id %i, time %llu.", 
-                   (SInt32) packet.type, packet.sender.tile_id, packet.sender.core_type,
-                   packet.receiver.tile_id, packet.receiver.core_type,
-                   _tile->getId(), packet.time.toNanosec());
+         TRACE_EVENT(NETWORK_FORWARD, _tile->getId(), packet.time.toNanosec(),
+                     packet.type, packet.sender.tile_id, packet.receiver.tile_id);
 
          forwardPacket(packet);
-         
-         // De-allocate packet payload
-         if (packet.length > 0)
-            delete [] (Byte*) packet.data;
+
+         _transport->releaseBuffer(buffer);
       }
    }
    while (_transport->query());
@@ -177,21 +231,18 @@ SInt32 Network::netSend(NetPacket& packet)
 
    NetworkModel* model = getNetworkModelFromPacketType(packet.type);
 
-   LOG_PRINT("netSend: type %i, from (%i,%i) to (%i,%i), tile_id %i, time %llu",
-             packet.type, packet.sender.tile_id, packet.sender.core_type,
-             packet.receiver.tile_id, packet.receiver.core_type,
-             _tile->getId(), packet.time.toNanosec());
+   TRACE_EVENT(NETWORK_SEND, _tile->getId(), packet.time.toNanosec(),
+               packet.type, packet.sender.tile_id, packet.receiver.tile_id);
    
+   __sync_fetch_and_add(&_numPacketsSent, 1);
 
-   // Send packet as multiple packets if model has not broadcast capability and receiver is ALL
+   // Send packet as a multicast to all tiles if model has not broadcast capability and receiver is ALL
    if ( (TILE_ID(packet.receiver) == NetPacket::BROADCAST) && (!model->hasBroadcastCapability()) )
    {
-      for (tile_id_t i = 0; i < (tile_id_t) Config::getSingleton()->getTotalTiles(); i++)
-      {
-         packet.receiver = CORE_ID(i);
-         __attribute__((unused)) SInt32 ret = forwardPacket(packet);
-         LOG_ASSERT_ERROR(ret == (SInt32) packet.length, "forwardPacket-ret(%i) != packet.length(%u)", ret, packet.length);
-      }
+      vector<tile_id_t> receivers(Config::getSingleton()->getTotalTiles());
+      for (tile_id_t i = 0; i < (tile_id_t) receivers.size(); i++)
+         receivers[i] = i;
+      multicastPacket(packet, receivers);
    }
 
    else // (packet.receiver != NetPacket::BROADCAST) || (model->hasBroadcastCapability())
@@ -211,168 +262,146 @@ SInt32 Network::netSend(module_t module, NetPacket& packet)
    return netSend(packet);
 }
 
+SInt32 Network::netMulticast(NetPacket& packet, const vector<tile_id_t>& receivers)
+{
+   TRACE_EVENT(NETWORK_MULTICAST, _tile->getId(), packet.time.toNanosec(),
+               packet.type, packet.sender.tile_id, receivers.size());
+
+   __sync_fetch_and_add(&_numPacketsSent, 1);
+
+   multicastPacket(packet, receivers);
+
+   return packet.length;
+}
+
+SInt32 Network::netMulticast(module_t module, NetPacket& packet, const vector<tile_id_t>& receivers)
+{
+   NetworkModel* model = getNetworkModelFromPacketType(packet.type);
+   packet.time += model->getSynchronizationDelay(module);
+   return netMulticast(packet, receivers);
+}
+
+void Network::multicastPacket(NetPacket& packet, const vector<tile_id_t>& receivers)
+{
+   NetworkModel* model = getNetworkModelFromPacketType(packet.type);
+   tile_id_t sender = TILE_ID(packet.sender);
+   tile_id_t num_application_tiles = (tile_id_t) Config::getSingleton()->getApplicationTiles();
+
+   // Only application tiles other than the sender are reached through the
+   // multicast tree. The rest get their own copy of the packet.
+   vector<tile_id_t> tree_receivers;
+   if (model->hasMulticastCapability() && (sender < num_application_tiles))
+   {
+      for (UInt32 i = 0; i < receivers.size(); i++)
+      {
+         if ((receivers[i] != sender) && (receivers[i] < num_application_tiles))
+            tree_receivers.push_back(receivers[i]);
+      }
+      // Not worth a tree
+      if (tree_receivers.size() < 2)
+         tree_receivers.clear();
+   }
+
+   // All unicast copies share one serialized buffer
+   PacketBuffer* packet_buffer = NULL;
+   for (UInt32 i = 0; i < receivers.size(); i++)
+   {
+      if (!tree_receivers.empty() && (receivers[i] != sender) && (receivers[i] < num_application_tiles))
+         continue;
+
+      packet.receiver = CORE_ID(receivers[i]);
+      if (packet_buffer == NULL)
+      {
+         packet_buffer = _packetBufferPool->create(packet);
+         __sync_fetch_and_add(&_bytesSerialized, packet.bufferSize());
+      }
+      else
+      {
+         // Routing the previous receiver rewrote the header, the payload is still valid
+         packet_buffer->setHeader(packet);
+         __sync_fetch_and_add(&_bytesSerialized, sizeof(NetPacket));
+      }
+
+      __attribute__((unused)) SInt32 ret = forwardPacket(packet_buffer);
+      LOG_ASSERT_ERROR(ret == (SInt32) packet.length, "forwardPacket-ret(%i) != packet.length(%u)", ret, packet.length);
+   }
+   if (packet_buffer)
+      packet_buffer->release();
+
+   if (!tree_receivers.empty())
+   {
+      packet.receiver = CORE_ID(NetPacket::MULTICAST);
+      packet.num_multicast_receivers = tree_receivers.size();
+      packet.multicast_receivers = &tree_receivers[0];
+
+      __attribute__((unused)) SInt32 ret = forwardPacket(packet);
+      LOG_ASSERT_ERROR(ret == (SInt32) packet.length, "forwardPacket-ret(%i) != packet.length(%u)", ret, packet.length);
+
+      packet.num_multicast_receivers = 0;
+      packet.multicast_receivers = NULL;
+   }
+}
 
 SInt32 Network::forwardPacket(const NetPacket& packet)
 {
-   // Create a buffer suitable for forwarding
-   Byte* buffer = packet.makeBuffer();
-   NetPacket* buf_pkt = (NetPacket*) buffer;
+   PacketBuffer* packet_buffer = _packetBufferPool->create(packet);
+   __sync_fetch_and_add(&_bytesSerialized, packet.bufferSize());
+
+   SInt32 ret = forwardPacket(packet_buffer);
+
+   packet_buffer->release();
+   return ret;
+}
+
+SInt32 Network::forwardPacket(PacketBuffer* packet_buffer)
+{
+   NetPacket* buf_pkt = packet_buffer->getPacket();
 
    LOG_ASSERT_ERROR((buf_pkt->type >= 0) && (buf_pkt->type < NUM_PACKET_TYPES),
                     "buf_pkt->type(%u) INVALID", buf_pkt->type);
 
    NetworkModel *model = getNetworkModelFromPacketType(buf_pkt->type);
 
-   queue<NetworkModel::Hop> hop_queue;
-   model->__routePacket(*buf_pkt, hop_queue);
+   NetworkModel::HopVector hops;
+   model->__routePacket(*buf_pkt, hops);
 
-   while (!hop_queue.empty())
+   // With the shared memory shortcut (or a model routed at the source), the
+   // hops of the intermediate routers are appended to 'hops' as we go
+   for (UInt32 i = 0; i < hops.size(); i++)
    {
-      NetworkModel::Hop hop = hop_queue.front();
-      hop_queue.pop();
+      // Copy, pushing more hops may move the vector's storage
+      NetworkModel::Hop hop = hops[i];
 
       buf_pkt->node_type = hop._next_node_type;
       buf_pkt->time = hop._time;
       buf_pkt->zero_load_delay = hop._zero_load_delay;
       buf_pkt->contention_delay = hop._contention_delay;
       
-      if ( (hop._next_node_type != NetworkModel::RECEIVE_TILE) && (_sharedMemoryShortcutEnabled) )
+      if ( (hop._next_node_type != NetworkModel::RECEIVE_TILE) &&
+           (_sharedMemoryShortcutEnabled || model->isRoutedAtSource()) )
       {
          Tile* next_tile = Sim()->getTileManager()->getTileFromID(hop._next_tile_id);
          assert(next_tile);
          NetworkModel* next_network_model = next_tile->getNetwork()->getNetworkModelFromPacketType(buf_pkt->type);
-         next_network_model->__routePacket(*buf_pkt, hop_queue);
+         next_network_model->__routePacket(*buf_pkt, hops);
       }
       else
       {
-         LOG_PRINT("Send packet : type %i, from (%i,%i), to (%i, %i), next_hop %i, tile_id %i, time %llu",
-                   (SInt32) buf_pkt->type,
-                   buf_pkt->sender.tile_id, buf_pkt->sender.core_type,
-                   buf_pkt->receiver.tile_id, buf_pkt->receiver.core_type,
-                   hop._next_tile_id,
-                   _tile->getId(), hop._time.toNanosec());
+         TRACE_EVENT(NETWORK_SEND_TO_TRANSPORT, _tile->getId(), hop._time.toNanosec(),
+                     buf_pkt->type, buf_pkt->sender.tile_id, hop._next_tile_id);
          
-         _transport->send(hop._next_tile_id, buffer, packet.bufferSize());
+         _transport->send(hop._next_tile_id, packet_buffer->getBuffer(), packet_buffer->getSize());
+         __sync_fetch_and_add(&_bytesSentToTransport, packet_buffer->getSize());
       }
    }
 
-   delete [] buffer;
-
-   return packet.length;
+   return buf_pkt->length;
 }
 
-// Stupid helper class to eliminate special cases for empty
-// sender/type vectors in a NetMatch
-class NetRecvIterator
-{
-   public:
-      NetRecvIterator(UInt32 i)
-            : _mode(INT)
-            , _max(i)
-            , _i(0)
-      {
-      }
-      NetRecvIterator(const std::vector<core_id_t> &v)
-            : _mode(SENDER_VECTOR)
-            , _senders(&v)
-            , _i(0)
-      {
-      }
-      NetRecvIterator(const std::vector<PacketType> &v)
-            : _mode(TYPE_VECTOR)
-            , _types(&v)
-            , _i(0)
-      {
-      }
-
-      inline UInt32 get()
-      {
-         switch (_mode)
-         {
-         case INT:
-            return _i;
-         case TYPE_VECTOR:
-            return (UInt32)_types->at(_i);
-         default:
-            assert(false);
-            return (UInt32)-1;
-         };
-      }
-
-      inline core_id_t getId()
-      {
-         switch (_mode)
-         {
-         case INT:
-            return Tile::getMainCoreId(_i);
-         case SENDER_VECTOR:
-            return (core_id_t)_senders->at(_i);
-         default:
-            assert(false);
-            return INVALID_CORE_ID;
-         };
-      }
-
-      inline Boolean done()
-      {
-         switch (_mode)
-         {
-         case INT:
-            return _i >= _max;
-         case SENDER_VECTOR:
-            return _i >= _senders->size();
-         case TYPE_VECTOR:
-            return _i >= _types->size();
-         default:
-            assert(false);
-            return true;
-         };
-      }
-
-      inline void next()
-      {
-         ++_i;
-      }
-
-      inline void reset()
-      {
-         _i = 0;
-      }
-
-   private:
-      enum
-      {
-         INT, SENDER_VECTOR, TYPE_VECTOR
-      } _mode;
-
-      union
-      {
-         UInt32 _max;
-         const std::vector<core_id_t> *_senders;
-         const std::vector<PacketType> *_types;
-      };
-
-      UInt32 _i;
-};
-
 NetPacket Network::netRecv(const NetMatch &match)
 {
    LOG_PRINT("netRecv: Entering.");
 
-   // Track via iterator to minimize copying
-   NetQueue::iterator itr;
-   Boolean found;
-
-   found = false;
-
-   NetRecvIterator sender = match.senders.empty()
-                            ? NetRecvIterator(_numMod)
-                            : NetRecvIterator(match.senders);
-
-   NetRecvIterator type = match.types.empty()
-                          ? NetRecvIterator((UInt32)NUM_PACKET_TYPES)
-                          : NetRecvIterator(match.types);
-
    core_id_t receiver = match.receiver.tile_id == INVALID_TILE_ID 
                         ? _tile->getCore()->getId() 
                         : match.receiver;
@@ -382,65 +411,35 @@ NetPacket Network::netRecv(const NetMatch &match)
    Time start_time = _tile->getCore()->getModel()->getCurrTime();
    LOG_PRINT("netRecv: Start waiting at %llu", start_time.toNanosec());
 
+   NetPacket packet;
+   NetRecvWaiter waiter;
+   waiter.match = &match;
+   waiter.receiver = receiver;
+
    _netQueueLock.acquire();
 
-   while (!found)
+   // go to sleep until a matching packet arrives if none have been found
+   while (!_netQueue->pop(match, receiver, packet))
    {
-      itr = _netQueue.end();
-
-      // check every entry in the queue
-      for (NetQueue::iterator i = _netQueue.begin();
-            (i != _netQueue.end()) && !found;
-            i++)
-      {
-         // make sure that this core is the proper destination core for this tile
-         if (i->receiver.tile_id != receiver.tile_id || i->receiver.core_type != receiver.core_type)
-         {
-            if (i->receiver.tile_id != NetPacket::BROADCAST)
-               continue;
-         }
-
-         // only find packets that match
-         for (sender.reset(); !sender.done() && !found; sender.next())
-         {
-            if (i->sender.tile_id != sender.getId().tile_id || i->sender.core_type != sender.getId().core_type)
-               continue;
-
-            for (type.reset(); !type.done() && !found; type.next())
-            {
-               if (i->type != (PacketType)type.get())
-                  continue;
-
-               found = true;
-               itr = i;
-            }
-         }
-      }
-
-      // go to sleep until a packet arrives if none have been found
-      if (!found)
-      {
-         LOG_PRINT("netRecv: Packet match NOT found");
-         LOG_PRINT("netRecv: Waiting on condition variable");
-         _netQueueCond.wait(_netQueueLock);
-         LOG_PRINT("netRecv: Woken up");
-      }
+      LOG_PRINT("netRecv: Packet match NOT found");
+      LOG_PRINT("netRecv: Waiting on condition variable");
+      _netRecvWaiters.push_back(&waiter);
+      waiter.cond.wait(_netQueueLock);
+      // Spurious wakeups leave the waiter registered
+      _netRecvWaiters.remove(&waiter);
+      LOG_PRINT("netRecv: Woken up");
    }
 
-   LOG_PRINT("netRecv: Packet match found");
-
-   assert(found == true && itr != _netQueue.end());
-   assert(0 <= itr->sender.tile_id && itr->sender.tile_id < _numMod);
-   assert(0 <= itr->type && itr->type < NUM_PACKET_TYPES);
-   assert((itr->receiver.tile_id == _tile->getId()) || (itr->receiver.tile_id == NetPacket::BROADCAST));
+   _netQueueLock.release();
 
-   // Copy result
-   NetPacket packet = *itr;
-   _netQueue.erase(itr);
+   LOG_PRINT("netRecv: Packet match found");
 
-   _netQueueLock.release();
+   assert(0 <= packet.sender.tile_id && packet.sender.tile_id < _numMod);
+   assert(0 <= packet.type && packet.type < NUM_PACKET_TYPES);
+   assert((packet.receiver.tile_id == _tile->getId()) || (packet.receiver.tile_id == NetPacket::BROADCAST));
 
-   LOG_PRINT("netRecv: Started waiting at %llu ns, Got packet at %llu ns", start_time.toNanosec(), packet.time.toNanosec());
+   TRACE_EVENT(NETWORK_RECV, _tile->getId(), packet.time.toNanosec(),
+               packet.type, packet.sender.tile_id, start_time.toNanosec());
 
    if (packet.time > start_time)
    {
@@ -652,6 +651,8 @@ NetPacket::NetPacket()
    , data(0)
    , zero_load_delay(0)
    , contention_delay(0)
+   , num_multicast_receivers(0)
+   , multicast_receivers(NULL)
 {
 }
 
@@ -664,6 +665,8 @@ NetPacket::NetPacket(Time t, PacketType ty, SInt32 s,
    , data(d)
    , zero_load_delay(0)
    , contention_delay(0)
+   , num_multicast_receivers(0)
+   , multicast_receivers(NULL)
 {
    sender = Tile::getMainCoreId(s);
    receiver = Tile::getMainCoreId(r);
@@ -681,30 +684,17 @@ NetPacket::NetPacket(Time t, PacketType ty, core_id_t s,
    , data(d)
    , zero_load_delay(0)
    , contention_delay(0)
+   , num_multicast_receivers(0)
+   , multicast_receivers(NULL)
 {
 }
 
-NetPacket::NetPacket(Byte *buffer)
-{
-   memcpy(this, buffer, sizeof(*this));
-
-   // LOG_ASSERT_ERROR(length > 0, "type(%u), sender(%i), receiver(%i), length(%u)", type, sender, receiver, length);
-   if (length > 0)
-   {
-      Byte* data_buffer = new Byte[length];
-      memcpy(data_buffer, buffer + sizeof(*this), length);
-      data = data_buffer;
-   }
-
-   delete [] buffer;
-}
-
 // This implementation is slightly wasteful because there is no need
 // to copy the const void* value in the NetPacket when length == 0,
 // but I don't see this as a major issue.
 UInt32 NetPacket::bufferSize() const
 {
-   return (sizeof(*this) + length);
+   return (sizeof(*this) + length + num_multicast_receivers * sizeof(tile_id_t));
 }
 
 Byte* NetPacket::makeBuffer() const
@@ -716,6 +706,7 @@ Byte* NetPacket::makeBuffer() const
 
    memcpy(buffer, this, sizeof(*this));
    memcpy(buffer + sizeof(*this), data, length);
+   memcpy(buffer + sizeof(*this) + length, multicast_receivers, num_multicast_receivers * sizeof(tile_id_t));
 
    return buffer;
 }
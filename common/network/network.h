@@ -21,6 +21,9 @@ using std::list;
 class Tile;
 class Network;
 class NetworkModel;
+class NetQueue;
+class PacketBuffer;
+class PacketBufferPool;
 
 // -- Network Packets -- //
 
@@ -41,8 +44,12 @@ public:
    Time zero_load_delay;
    Time contention_delay;
 
+   // Receivers of a multicast packet (receiver is MULTICAST). In buffers
+   // made by makeBuffer(), the list follows the payload.
+   UInt32 num_multicast_receivers;
+   const tile_id_t *multicast_receivers;
+
    NetPacket();
-   explicit NetPacket(Byte*);
    NetPacket(Time time, PacketType type, core_id_t sender, 
              core_id_t receiver, UInt32 length, const void *data);
    NetPacket(Time time, PacketType type, SInt32 sender, 
@@ -52,10 +59,9 @@ public:
    Byte *makeBuffer() const;
 
    static const SInt32 BROADCAST = 0xDEADBABE;
+   static const SInt32 MULTICAST = 0xDEADCAFE;
 };
 
-typedef list<NetPacket> NetQueue;
-
 // -- Network Matches -- //
 
 class NetMatch
@@ -98,6 +104,11 @@ public:
 
    SInt32 netSend(NetPacket& packet);
    SInt32 netSend(module_t module, NetPacket& packet);
+   // Sends 'packet' to every tile in 'receivers'. The packet is serialized
+   // once, and is routed as a single multicast packet on models that can
+   // do so (see NetworkModel::hasMulticastCapability()).
+   SInt32 netMulticast(NetPacket& packet, const vector<tile_id_t>& receivers);
+   SInt32 netMulticast(module_t module, NetPacket& packet, const vector<tile_id_t>& receivers);
    NetPacket netRecv(const NetMatch &match);
 
    // -- Wrappers -- //
@@ -132,9 +143,18 @@ private:
    SInt32 _tid;
    SInt32 _numMod;
 
-   NetQueue _netQueue;
+   // A thread blocked in netRecv(). Each waiter sleeps on its own condition
+   // variable and is only woken up by a packet that matches it.
+   struct NetRecvWaiter
+   {
+      const NetMatch* match;
+      core_id_t receiver;
+      ConditionVariable cond;
+   };
+
+   NetQueue* _netQueue;
    Lock _netQueueLock;
-   ConditionVariable _netQueueCond;
+   list<NetRecvWaiter*> _netRecvWaiters;
    
    // -- Network Injection/Ejection Rate Trace -- //
    static bool* _utilizationTraceEnabled;
@@ -143,7 +163,19 @@ private:
    // Is shortCut available through shared memory
    bool _sharedMemoryShortcutEnabled;
 
+   // Serialized packets being sent or forwarded from this tile
+   PacketBufferPool* _packetBufferPool;
+
+   // Bytes of packets copied around by the simulator (not modeled traffic),
+   // to be compared against the number of packets the application sent
+   volatile UInt64 _numPacketsSent;
+   volatile UInt64 _bytesSerialized;
+   volatile UInt64 _bytesSentToTransport;
+   volatile UInt64 _bytesCopiedOnReceive;
+
    SInt32 forwardPacket(const NetPacket& packet);
+   SInt32 forwardPacket(PacketBuffer* packet_buffer);
+   void multicastPacket(NetPacket& packet, const vector<tile_id_t>& receivers);
    
    // -- Network Injection/Ejection Rate Trace -- //
    static void computeTraceEnabledNetworks();
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <new>
 using namespace std;
 
 #include "network.h"
@@ -17,6 +18,8 @@ using namespace std;
 NetworkModel::NetworkModel(Network *network, SInt32 network_id)
    : _frequency(0)
    , _voltage(0)
+   , _routed_at_source(false)
+   , _has_thread_safe_routing(false)
    , _module(INVALID_MODULE)
    , _network(network)
    , _network_id(network_id)
@@ -85,10 +88,22 @@ NetworkModel::isPacketReadyToBeReceived(const NetPacket& pkt)
 }
 
 void
-NetworkModel::__routePacket(const NetPacket& pkt, queue<Hop>& next_hops)
+NetworkModel::__routePacket(const NetPacket& pkt, HopVector& next_hops)
 {
-   ScopedLock sl(_lock);
+   if (_has_thread_safe_routing)
+   {
+      routePacketAtTile(pkt, next_hops);
+   }
+   else
+   {
+      ScopedLock sl(_lock);
+      routePacketAtTile(pkt, next_hops);
+   }
+}
 
+void
+NetworkModel::routePacketAtTile(const NetPacket& pkt, HopVector& next_hops)
+{
    __attribute__((unused)) tile_id_t pkt_sender = TILE_ID(pkt.sender);
    __attribute__((unused)) tile_id_t pkt_receiver = TILE_ID(pkt.receiver);
 
@@ -107,7 +122,8 @@ NetworkModel::__routePacket(const NetPacket& pkt, queue<Hop>& next_hops)
    }
 
    LOG_ASSERT_ERROR( isApplicationTile(pkt_sender)                                               &&
-                     (isApplicationTile(pkt_receiver) || (pkt_receiver == NetPacket::BROADCAST)) &&
+                     (isApplicationTile(pkt_receiver) || (pkt_receiver == NetPacket::BROADCAST)  ||
+                      (pkt_receiver == NetPacket::MULTICAST))                                    &&
                      (pkt_sender != pkt_receiver),
                      "pkt_sender(%i), pkt_receiver(%i)", pkt_sender, pkt_receiver );
 
@@ -145,8 +161,8 @@ NetworkModel::processReceivedPacket(NetPacket& pkt)
    // Add serialization latency due to finite link bandwidth
    UInt64 num_flits = computeNumFlits(getModeledLength(pkt));
 
-   pkt.time += Latency(num_flits,_frequency);
-   pkt.zero_load_delay += Latency(num_flits,_frequency);
+   pkt.time += Latency(num_flits,_clock_period);
+   pkt.zero_load_delay += Latency(num_flits,_clock_period);
 }
 
 void
@@ -236,17 +252,18 @@ NetworkModel::updateSendCounters(const NetPacket& packet)
    UInt32 packet_length = getModeledLength(packet); // In bits
    SInt32 num_flits = computeNumFlits(packet_length);
    
-   _total_packets_sent ++;
-   _total_flits_sent += num_flits;
-   _total_bits_sent += packet_length;
-   _total_flits_sent_in_current_interval += num_flits;
+   // Not under _lock with thread-safe routing
+   __sync_fetch_and_add(&_total_packets_sent, 1);
+   __sync_fetch_and_add(&_total_flits_sent, num_flits);
+   __sync_fetch_and_add(&_total_bits_sent, packet_length);
+   __sync_fetch_and_add(&_total_flits_sent_in_current_interval, num_flits);
 
    if (receiver == NetPacket::BROADCAST)
    {
-      _total_packets_broadcasted ++;
-      _total_flits_broadcasted += num_flits;
-      _total_bits_broadcasted += packet_length;
-      _total_flits_broadcasted_in_current_interval += num_flits;
+      __sync_fetch_and_add(&_total_packets_broadcasted, 1);
+      __sync_fetch_and_add(&_total_flits_broadcasted, num_flits);
+      __sync_fetch_and_add(&_total_bits_broadcasted, packet_length);
+      __sync_fetch_and_add(&_total_flits_broadcasted_in_current_interval, num_flits);
    }
 }
 
@@ -411,7 +428,7 @@ NetworkModel::computeProcessToTileMapping(UInt32 network_type)
 }
 
 bool
-NetworkModel::processCornerCases(const NetPacket& pkt, queue<Hop>& next_hops)
+NetworkModel::processCornerCases(const NetPacket& pkt, HopVector& next_hops)
 {
    tile_id_t pkt_sender = TILE_ID(pkt.sender);
    tile_id_t pkt_receiver = TILE_ID(pkt.receiver);
@@ -447,7 +464,8 @@ NetworkModel::processCornerCases(const NetPacket& pkt, queue<Hop>& next_hops)
    {
       assert( (pkt_sender != pkt_receiver)                                                   &&
               isApplicationTile(pkt_sender)                                                  &&
-              (isApplicationTile(pkt_receiver) || (pkt_receiver == NetPacket::BROADCAST)) );
+              (isApplicationTile(pkt_receiver) || (pkt_receiver == NetPacket::BROADCAST)  ||
+               (pkt_receiver == NetPacket::MULTICAST)) );
 
       if (pkt_receiver == NetPacket::BROADCAST)
       {
@@ -485,6 +503,7 @@ void NetworkModel::initializeDVFS()
 
    int rc = DVFSManager::getInitialFrequencyAndVoltage(_module, _frequency, _voltage);
    LOG_ASSERT_ERROR(rc == 0, "Error setting initial voltage for frequency(%g)", _frequency);
+   _clock_period = ClockPeriod(_frequency);
 
    // Asynchronous communication
    _synchronization_delay = Time(Latency(DVFSManager::getSynchronizationDelay(), _frequency));
@@ -519,6 +538,7 @@ NetworkModel::setDVFS(double frequency, voltage_option_t voltage_flag, const Tim
    if (rc==0)
    {
       _frequency = frequency;
+      _clock_period = ClockPeriod(_frequency);
       setDVFS(_frequency, _voltage, curr_time);
       _synchronization_delay = Time(Latency(DVFSManager::getSynchronizationDelay(), _frequency));
    }
@@ -536,11 +556,11 @@ NetworkModel::initializeCurrentUtilizationStatistics()
 void
 NetworkModel::popCurrentUtilizationStatistics(UInt64& flits_sent, UInt64& flits_broadcasted, UInt64& flits_received)
 {
-   flits_sent = _total_flits_sent_in_current_interval;
-   flits_broadcasted = _total_flits_broadcasted_in_current_interval;
+   // Senders may be updating the send counters concurrently
+   flits_sent = __sync_fetch_and_and(&_total_flits_sent_in_current_interval, 0);
+   flits_broadcasted = __sync_fetch_and_and(&_total_flits_broadcasted_in_current_interval, 0);
    flits_received = _total_flits_received_in_current_interval;
-   
-   initializeCurrentUtilizationStatistics();
+   _total_flits_received_in_current_interval = 0;
 }
 
 Time
@@ -565,3 +585,36 @@ NetworkModel::Hop::Hop(const NetPacket& pkt, tile_id_t next_tile_id, SInt32 next
 NetworkModel::Hop::~Hop()
 {}
 
+NetworkModel::HopVector::HopVector()
+   : _hops((Hop*) _inline_hops)
+   , _size(0)
+   , _capacity(INLINE_CAPACITY)
+{}
+
+NetworkModel::HopVector::~HopVector()
+{
+   for (UInt32 i = 0; i < _size; i++)
+      _hops[i].~Hop();
+   if (_hops != (Hop*) _inline_hops)
+      delete [] (Byte*) _hops;
+}
+
+void
+NetworkModel::HopVector::push(const Hop& hop)
+{
+   if (_size == _capacity)
+   {
+      Hop* hops = (Hop*) new Byte[2 * _capacity * sizeof(Hop)];
+      for (UInt32 i = 0; i < _size; i++)
+      {
+         new (&hops[i]) Hop(_hops[i]);
+         _hops[i].~Hop();
+      }
+      if (_hops != (Hop*) _inline_hops)
+         delete [] (Byte*) _hops;
+      _hops = hops;
+      _capacity *= 2;
+   }
+   new (&_hops[_size ++]) Hop(hop);
+}
+
@@ -62,12 +62,44 @@ public:
       Time _contention_delay;
    };
 
+   // Hops filled in by routePacket(). Network::forwardPacket() appends the
+   // hops of intermediate routers (shared memory shortcut) to the same
+   // vector while walking it, so it is consumed in FIFO order. The first
+   // INLINE_CAPACITY hops live in the object itself, so routing a packet
+   // does not allocate; only wide broadcasts spill over to the heap.
+   class HopVector
+   {
+   public:
+      HopVector();
+      ~HopVector();
+
+      void push(const Hop& hop);
+
+      UInt32 size() const                          { return _size; }
+      bool empty() const                           { return (_size == 0); }
+      const Hop& operator[](UInt32 index) const    { return _hops[index]; }
+
+   private:
+      static const UInt32 INLINE_CAPACITY = 16;
+
+      Hop* _hops;
+      UInt32 _size;
+      UInt32 _capacity;
+      // Raw storage, Hop has no default constructor
+      UInt64 _inline_hops[(INLINE_CAPACITY * sizeof(Hop) + sizeof(UInt64) - 1) / sizeof(UInt64)];
+
+      HopVector(const HopVector&);
+      HopVector& operator=(const HopVector&);
+   };
+
    string getNetworkName() { return _network_name; }
    
    bool hasBroadcastCapability() { return _has_broadcast_capability; }
+   bool hasMulticastCapability() { return _has_multicast_capability; }
+   bool isRoutedAtSource() { return _routed_at_source; }
 
    bool isPacketReadyToBeReceived(const NetPacket& pkt);
-   void __routePacket(const NetPacket &pkt, queue<Hop> &next_hops);
+   void __routePacket(const NetPacket &pkt, HopVector &next_hops);
    void __processReceivedPacket(NetPacket &pkt);
 
    virtual void outputSummary(std::ostream &out, const Time& target_completion_time);
@@ -128,12 +160,22 @@ protected:
 
    // Frequency
    double _frequency;
+   // Clock period at _frequency, for converting delays to Time
+   ClockPeriod _clock_period;
    // Voltage
    double _voltage;
    // Flit Width
    SInt32 _flit_width;
    // Has Broadcast Capability
    bool _has_broadcast_capability;
+   // Can route a packet to a list of receivers (NetPacket::MULTICAST) at once
+   bool _has_multicast_capability;
+   // The sender routes the packet through the intermediate routers itself
+   // (as with the shared memory shortcut) and sends it to the receivers only
+   bool _routed_at_source;
+   // routePacket() only uses routers and links, which do their own locking,
+   // so many threads can route packets through this model at once
+   bool _has_thread_safe_routing;
    // Tile ID
    tile_id_t _tile_id;
    // Tile Width
@@ -185,7 +227,7 @@ private:
    UInt64 _total_flits_broadcasted_in_current_interval;
    UInt64 _total_flits_received_in_current_interval;
 
-   virtual void routePacket(const NetPacket &pkt, queue<Hop> &next_hops) = 0;
+   virtual void routePacket(const NetPacket &pkt, HopVector &next_hops) = 0;
    virtual void processReceivedPacket(NetPacket &pkt);
  
    // DVFS 
@@ -193,7 +235,9 @@ private:
    virtual void setDVFS(double frequency, double voltage, const Time& curr_time) {}
 
    // Process Corner Cases
-   bool processCornerCases(const NetPacket &pkt, queue<Hop> &next_hops);
+   bool processCornerCases(const NetPacket &pkt, HopVector &next_hops);
+   // Body of __routePacket()
+   void routePacketAtTile(const NetPacket &pkt, HopVector &next_hops);
 
    // Update Send & Receive Counters
    void updateSendCounters(const NetPacket& packet);
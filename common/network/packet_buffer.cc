@@ -0,0 +1,111 @@
+#include <cstring>
+#include <new>
+
+#include "packet_buffer.h"
+#include "log.h"
+
+// -- PacketBuffer -- //
+
+void PacketBuffer::release()
+{
+   _pool->recycle(this);
+}
+
+void PacketBuffer::setHeader(const NetPacket& packet)
+{
+   LOG_ASSERT_ERROR(packet.bufferSize() == _size,
+                    "Packet size(%u) does not match buffer size(%u)", packet.bufferSize(), _size);
+
+   NetPacket* buf_pkt = new (getPacket()) NetPacket(packet);
+   // Routing looks at the payload (e.g., to check whether a memory packet is
+   // modeled), so point at our own copy rather than at the sender's memory
+   buf_pkt->data = getBuffer() + sizeof(NetPacket);
+   if (packet.num_multicast_receivers > 0)
+      buf_pkt->multicast_receivers = (tile_id_t*) (getBuffer() + sizeof(NetPacket) + packet.length);
+}
+
+// -- PacketBufferPool -- //
+
+PacketBufferPool::PacketBufferPool()
+{
+   for (UInt32 i = 0; i < NUM_CLASSES; i++)
+   {
+      _free_lists[i] = NULL;
+      _num_free[i] = 0;
+   }
+}
+
+PacketBufferPool::~PacketBufferPool()
+{
+   for (UInt32 i = 0; i < NUM_CLASSES; i++)
+   {
+      while (_free_lists[i])
+      {
+         PacketBuffer* packet_buffer = _free_lists[i];
+         _free_lists[i] = packet_buffer->_next_free;
+         delete [] (Byte*) packet_buffer;
+      }
+   }
+}
+
+PacketBuffer* PacketBufferPool::create(const NetPacket& packet)
+{
+   UInt32 size = packet.bufferSize();
+
+   UInt32 size_class = 0;
+   while ((size_class < NUM_CLASSES) && ((1U << (size_class + MIN_CLASS_SHIFT)) < size))
+      size_class ++;
+
+   PacketBuffer* packet_buffer = NULL;
+   if (size_class < NUM_CLASSES)
+   {
+      ScopedLock sl(_locks[size_class]);
+      packet_buffer = _free_lists[size_class];
+      if (packet_buffer)
+      {
+         _free_lists[size_class] = packet_buffer->_next_free;
+         _num_free[size_class] --;
+      }
+   }
+
+   if (packet_buffer == NULL)
+   {
+      UInt32 capacity = (size_class < NUM_CLASSES) ? (1U << (size_class + MIN_CLASS_SHIFT)) : size;
+      packet_buffer = (PacketBuffer*) new Byte[sizeof(PacketBuffer) + capacity];
+      packet_buffer->_pool = this;
+      packet_buffer->_size_class = size_class;
+   }
+
+   packet_buffer->_next_free = NULL;
+   packet_buffer->_size = size;
+
+   packet_buffer->setHeader(packet);
+   if (packet.length > 0)
+      memcpy(packet_buffer->getBuffer() + sizeof(NetPacket), packet.data, packet.length);
+   if (packet.num_multicast_receivers > 0)
+   {
+      memcpy(packet_buffer->getBuffer() + sizeof(NetPacket) + packet.length, packet.multicast_receivers,
+             packet.num_multicast_receivers * sizeof(tile_id_t));
+   }
+
+   return packet_buffer;
+}
+
+void PacketBufferPool::recycle(PacketBuffer* packet_buffer)
+{
+   UInt32 size_class = packet_buffer->_size_class;
+
+   if (size_class < NUM_CLASSES)
+   {
+      ScopedLock sl(_locks[size_class]);
+      if (_num_free[size_class] < MAX_FREE_BUFFERS)
+      {
+         packet_buffer->_next_free = _free_lists[size_class];
+         _free_lists[size_class] = packet_buffer;
+         _num_free[size_class] ++;
+         return;
+      }
+   }
+
+   delete [] (Byte*) packet_buffer;
+}
@@ -0,0 +1,66 @@
+#ifndef PACKET_BUFFER_H
+#define PACKET_BUFFER_H
+
+#include "fixed_types.h"
+#include "lock.h"
+#include "network.h"
+
+class PacketBufferPool;
+
+// A NetPacket in the format the transport layer carries it: the NetPacket
+// header immediately followed by the payload and, for multicast packets,
+// the list of receivers. Network serializes a packet once per send and
+// hands the same buffer to every hop and, when a broadcast or multicast is
+// sent as unicasts, to every receiver; each hop only rewrites the header
+// fields it owns. The transport copies the buffer on send, so it has a
+// single owner, who gives it back to its pool with release().
+
+class PacketBuffer
+{
+public:
+   void release();
+
+   NetPacket* getPacket()     { return (NetPacket*) (this + 1); }
+   Byte* getBuffer()          { return (Byte*) (this + 1); }
+   UInt32 getSize() const     { return _size; }
+
+   // Overwrite the header with that of 'packet' (the rest is left alone)
+   void setHeader(const NetPacket& packet);
+
+private:
+   friend class PacketBufferPool;
+
+   PacketBufferPool* _pool;
+   PacketBuffer* _next_free;
+   UInt32 _size;
+   UInt32 _size_class;
+};
+
+// Recycles PacketBuffers by size class, so that steady-state sends do not
+// hit the allocator. Every Network owns one.
+
+class PacketBufferPool
+{
+public:
+   PacketBufferPool();
+   ~PacketBufferPool();
+
+   // Serializes 'packet' into a buffer
+   PacketBuffer* create(const NetPacket& packet);
+
+private:
+   friend class PacketBuffer;
+
+   // Size classes of 128 bytes to 16 kB; larger buffers are not pooled
+   static const UInt32 MIN_CLASS_SHIFT = 7;
+   static const UInt32 NUM_CLASSES = 8;
+   static const UInt32 MAX_FREE_BUFFERS = 256;
+
+   Lock _locks[NUM_CLASSES];
+   PacketBuffer* _free_lists[NUM_CLASSES];
+   UInt32 _num_free[NUM_CLASSES];
+
+   void recycle(PacketBuffer* packet_buffer);
+};
+
+#endif // PACKET_BUFFER_H
@@ -4,6 +4,7 @@
 #include "queue_model_basic.h"
 #include "queue_model_history_list.h"
 #include "queue_model_history_tree.h"
+#include "queue_model_history_btree.h"
 #include "log.h"
 
 QueueModel::QueueModel(Type type)
@@ -30,6 +31,10 @@ QueueModel::create(std::string model_type, UInt64 min_processing_time)
    {
       return new QueueModelHistoryTree(min_processing_time);
    }
+   else if (model_type == "history_btree")
+   {
+      return new QueueModelHistoryBTree(min_processing_time);
+   }
    else
    {
       LOG_PRINT_ERROR("Unrecognized Queue Model Type(%s)", model_type.c_str());
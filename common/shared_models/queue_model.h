@@ -11,7 +11,8 @@ public:
    {
       BASIC = 0,
       HISTORY_LIST,
-      HISTORY_TREE
+      HISTORY_TREE,
+      HISTORY_BTREE
    };
 
    QueueModel(Type type);
@@ -0,0 +1,463 @@
+#define __STDC_LIMIT_MACROS
+#include <stdint.h>
+#include <cstring>
+
+#include "simulator.h"
+#include "config.h"
+#include "queue_model_history_btree.h"
+#include "log.h"
+
+QueueModelHistoryBTree::QueueModelHistoryBTree(UInt64 min_processing_time)
+   : QueueModel(HISTORY_BTREE)
+   , _min_processing_time(min_processing_time)
+{
+   try
+   {
+      _max_free_interval_list_size = Sim()->getCfg()->getInt("queue_model/history_btree/max_list_size");
+      _analytical_model_enabled = Sim()->getCfg()->getBool("queue_model/history_btree/analytical_model_enabled");
+   }
+   catch(...)
+   {
+      LOG_PRINT_ERROR("Could not read queue_model/history_btree parameters from the cfg file");
+   }
+
+   initialize();
+}
+
+QueueModelHistoryBTree::QueueModelHistoryBTree(UInt64 min_processing_time, UInt32 max_list_size, bool analytical_model_enabled)
+   : QueueModel(HISTORY_BTREE)
+   , _analytical_model_enabled(analytical_model_enabled)
+   , _min_processing_time(min_processing_time)
+   , _max_free_interval_list_size(max_list_size)
+{
+   initialize();
+}
+
+QueueModelHistoryBTree::~QueueModelHistoryBTree()
+{
+   delete _queue_model_m_g_1;
+}
+
+void
+QueueModelHistoryBTree::initialize()
+{
+   LOG_ASSERT_ERROR(_max_free_interval_list_size >= 1,
+         "max_list_size(%u) must be at least 1", _max_free_interval_list_size);
+
+   // Nodes are at least a quarter full, so the pool does not have to grow
+   // once the history reaches its maximum size
+   _nodes.reserve(2 * (_max_free_interval_list_size / MIN_ENTRIES) + 4);
+
+   _root = allocateNode(true);
+   _num_intervals = 0;
+   insertInterval(0, UINT64_MAX);
+
+   _queue_model_m_g_1 = new QueueModelMG1();
+
+   _total_requests_using_analytical_model = 0;
+}
+
+UInt64
+QueueModelHistoryBTree::computeQueueDelay(UInt64 pkt_time, UInt64 processing_time, tile_id_t requester)
+{
+   LOG_ASSERT_ERROR(_num_intervals >= 1, "Free interval history is empty");
+
+   UInt64 queue_delay;
+
+   // Check if it is an old packet
+   // If yes, use analytical model
+   // If not, use the free interval history
+   std::pair<UInt64,UInt64> oldest_interval = getFirstInterval();
+   if (_analytical_model_enabled && ((pkt_time + processing_time) < oldest_interval.first))
+   {
+      _total_requests_using_analytical_model ++;
+      queue_delay = _queue_model_m_g_1->computeQueueDelay(pkt_time, processing_time, requester);
+   }
+   else
+   {
+      queue_delay = computeUsingHistory(pkt_time, processing_time);
+   }
+
+   _queue_model_m_g_1->updateQueue(pkt_time, processing_time, queue_delay);
+
+   // Update Utilization Counters
+   updateQueueUtilizationCounters(pkt_time, processing_time, queue_delay);
+
+   return queue_delay;
+}
+
+UInt64
+QueueModelHistoryBTree::computeUsingHistory(UInt64 pkt_time, UInt64 processing_time)
+{
+   UInt64 queue_delay = 0;
+   std::pair<UInt64,UInt64> interval;
+
+   // Intervals are disjoint, so the only one that can hold the packet without
+   // delaying it is the last one starting at or before pkt_time. Every other
+   // candidate starts later, and the earliest of them that is long enough wins.
+   if (findContainingInterval(pkt_time, interval) && ((pkt_time + processing_time) <= interval.second))
+   {
+      // No additional queue delay
+      bool keep_before = ((pkt_time - interval.first) >= _min_processing_time);
+      bool keep_after = ((interval.second - (pkt_time + processing_time)) >= _min_processing_time);
+      if (keep_before)
+      {
+         replaceInterval(interval.first, interval.first, pkt_time);
+         if (keep_after)
+            insertInterval(pkt_time + processing_time, interval.second);
+      }
+      else if (keep_after)
+      {
+         replaceInterval(interval.first, pkt_time + processing_time, interval.second);
+      }
+      else
+      {
+         eraseInterval(interval.first);
+      }
+   }
+   else if (findIntervalAfter(_root, pkt_time, processing_time, interval))
+   {
+      queue_delay = interval.first - pkt_time;
+      if ((interval.second - (interval.first + processing_time)) >= _min_processing_time)
+         replaceInterval(interval.first, interval.first + processing_time, interval.second);
+      else
+         eraseInterval(interval.first);
+   }
+
+   if (_num_intervals > _max_free_interval_list_size)
+      eraseInterval(getFirstInterval().first);
+
+   LOG_PRINT("HistoryBTree: pkt_time(%llu), processing_time(%llu), queue_delay(%llu)", pkt_time, processing_time, queue_delay);
+
+   return queue_delay;
+}
+
+void
+QueueModelHistoryBTree::insertInterval(UInt64 start, UInt64 end)
+{
+   UInt32 split_index = insertInto(_root, start, end);
+   if (split_index != INVALID_NODE)
+   {
+      UInt32 root_index = allocateNode(false);
+      insertEntry(root_index, 0, _nodes[_root]._start[0], getMaxLength(_root), _root);
+      insertEntry(root_index, 1, _nodes[split_index]._start[0], getMaxLength(split_index), split_index);
+      _root = root_index;
+   }
+   _num_intervals ++;
+}
+
+void
+QueueModelHistoryBTree::eraseInterval(UInt64 start)
+{
+   eraseFrom(_root, start);
+   _num_intervals --;
+
+   if (!_nodes[_root]._is_leaf && (_nodes[_root]._num_entries == 1))
+   {
+      UInt32 root_index = _root;
+      _root = _nodes[root_index]._child[0];
+      releaseNode(root_index);
+   }
+}
+
+void
+QueueModelHistoryBTree::replaceInterval(UInt64 start, UInt64 new_start, UInt64 new_end)
+{
+   replaceIn(_root, start, new_start, new_end);
+}
+
+std::pair<UInt64,UInt64>
+QueueModelHistoryBTree::getFirstInterval()
+{
+   UInt32 node_index = _root;
+   while (!_nodes[node_index]._is_leaf)
+      node_index = _nodes[node_index]._child[0];
+   return std::make_pair(_nodes[node_index]._start[0], _nodes[node_index]._value[0]);
+}
+
+bool
+QueueModelHistoryBTree::findContainingInterval(UInt64 time, std::pair<UInt64,UInt64>& interval)
+{
+   UInt32 node_index = _root;
+   if (_nodes[node_index]._start[0] > time)
+      return false;
+
+   while (!_nodes[node_index]._is_leaf)
+      node_index = _nodes[node_index]._child[findChild(node_index, time)];
+
+   UInt32 pos = findChild(node_index, time);
+   interval = std::make_pair(_nodes[node_index]._start[pos], _nodes[node_index]._value[pos]);
+   return true;
+}
+
+bool
+QueueModelHistoryBTree::findIntervalAfter(UInt32 node_index, UInt64 time, UInt64 length, std::pair<UInt64,UInt64>& interval)
+{
+   const Node& node = _nodes[node_index];
+
+   if (node._is_leaf)
+   {
+      for (UInt32 i = 0; i < node._num_entries; i++)
+      {
+         if ((node._start[i] > time) && ((node._value[i] - node._start[i]) >= length))
+         {
+            interval = std::make_pair(node._start[i], node._value[i]);
+            return true;
+         }
+      }
+      return false;
+   }
+
+   // At most one child straddles 'time'; past it, the first child that is
+   // long enough is guaranteed to hold the answer
+   for (UInt32 i = 0; i < node._num_entries; i++)
+   {
+      if ((i + 1 < node._num_entries) && (node._start[i+1] <= time))
+         continue;
+      if (node._value[i] < length)
+         continue;
+      if (findIntervalAfter(node._child[i], time, length, interval))
+         return true;
+   }
+   return false;
+}
+
+UInt32
+QueueModelHistoryBTree::allocateNode(bool is_leaf)
+{
+   UInt32 node_index;
+   if (!_free_nodes.empty())
+   {
+      node_index = _free_nodes.back();
+      _free_nodes.pop_back();
+   }
+   else
+   {
+      node_index = _nodes.size();
+      _nodes.push_back(Node());
+   }
+
+   _nodes[node_index]._num_entries = 0;
+   _nodes[node_index]._is_leaf = is_leaf;
+   return node_index;
+}
+
+void
+QueueModelHistoryBTree::releaseNode(UInt32 node_index)
+{
+   _free_nodes.push_back(node_index);
+}
+
+UInt64
+QueueModelHistoryBTree::getMaxLength(UInt32 node_index)
+{
+   const Node& node = _nodes[node_index];
+   UInt64 max_length = 0;
+   for (UInt32 i = 0; i < node._num_entries; i++)
+   {
+      UInt64 length = node._is_leaf ? (node._value[i] - node._start[i]) : node._value[i];
+      if (length > max_length)
+         max_length = length;
+   }
+   return max_length;
+}
+
+void
+QueueModelHistoryBTree::updateEntry(UInt32 parent_index, UInt32 pos)
+{
+   UInt32 child_index = _nodes[parent_index]._child[pos];
+   _nodes[parent_index]._start[pos] = _nodes[child_index]._start[0];
+   _nodes[parent_index]._value[pos] = getMaxLength(child_index);
+}
+
+void
+QueueModelHistoryBTree::insertEntry(UInt32 node_index, UInt32 pos, UInt64 start, UInt64 value, UInt32 child)
+{
+   Node& node = _nodes[node_index];
+   LOG_ASSERT_ERROR(node._num_entries < FANOUT, "Inserting into a full node");
+
+   UInt32 num_moved = node._num_entries - pos;
+   memmove(&node._start[pos+1], &node._start[pos], num_moved * sizeof(UInt64));
+   memmove(&node._value[pos+1], &node._value[pos], num_moved * sizeof(UInt64));
+   memmove(&node._child[pos+1], &node._child[pos], num_moved * sizeof(UInt32));
+
+   node._start[pos] = start;
+   node._value[pos] = value;
+   node._child[pos] = child;
+   node._num_entries ++;
+}
+
+void
+QueueModelHistoryBTree::removeEntry(UInt32 node_index, UInt32 pos)
+{
+   Node& node = _nodes[node_index];
+
+   UInt32 num_moved = node._num_entries - pos - 1;
+   memmove(&node._start[pos], &node._start[pos+1], num_moved * sizeof(UInt64));
+   memmove(&node._value[pos], &node._value[pos+1], num_moved * sizeof(UInt64));
+   memmove(&node._child[pos], &node._child[pos+1], num_moved * sizeof(UInt32));
+   node._num_entries --;
+}
+
+void
+QueueModelHistoryBTree::moveEntries(UInt32 dst_index, UInt32 dst_pos, UInt32 src_index, UInt32 src_pos, UInt32 num_entries)
+{
+   Node& dst = _nodes[dst_index];
+   Node& src = _nodes[src_index];
+   LOG_ASSERT_ERROR(dst._num_entries + num_entries <= FANOUT, "Moving too many entries");
+
+   // Open a gap in the destination
+   UInt32 num_moved = dst._num_entries - dst_pos;
+   memmove(&dst._start[dst_pos + num_entries], &dst._start[dst_pos], num_moved * sizeof(UInt64));
+   memmove(&dst._value[dst_pos + num_entries], &dst._value[dst_pos], num_moved * sizeof(UInt64));
+   memmove(&dst._child[dst_pos + num_entries], &dst._child[dst_pos], num_moved * sizeof(UInt32));
+
+   memcpy(&dst._start[dst_pos], &src._start[src_pos], num_entries * sizeof(UInt64));
+   memcpy(&dst._value[dst_pos], &src._value[src_pos], num_entries * sizeof(UInt64));
+   memcpy(&dst._child[dst_pos], &src._child[src_pos], num_entries * sizeof(UInt32));
+   dst._num_entries += num_entries;
+
+   // Close the gap in the source
+   num_moved = src._num_entries - src_pos - num_entries;
+   memmove(&src._start[src_pos], &src._start[src_pos + num_entries], num_moved * sizeof(UInt64));
+   memmove(&src._value[src_pos], &src._value[src_pos + num_entries], num_moved * sizeof(UInt64));
+   memmove(&src._child[src_pos], &src._child[src_pos + num_entries], num_moved * sizeof(UInt32));
+   src._num_entries -= num_entries;
+}
+
+UInt32
+QueueModelHistoryBTree::findChild(UInt32 node_index, UInt64 start)
+{
+   // Last entry starting at or before 'start' (or the first entry, if none)
+   const Node& node = _nodes[node_index];
+   UInt32 lo = 0, hi = node._num_entries;
+   while (hi - lo > 1)
+   {
+      UInt32 mid = (lo + hi) / 2;
+      if (node._start[mid] <= start)
+         lo = mid;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+UInt32
+QueueModelHistoryBTree::insertInto(UInt32 node_index, UInt64 start, UInt64 end)
+{
+   UInt64 value = end;
+   UInt32 child_index = INVALID_NODE;
+   UInt32 pos;
+
+   if (_nodes[node_index]._is_leaf)
+   {
+      pos = findChild(node_index, start);
+      if ((_nodes[node_index]._num_entries > 0) && (_nodes[node_index]._start[pos] < start))
+         pos ++;
+   }
+   else
+   {
+      pos = findChild(node_index, start);
+      child_index = insertInto(_nodes[node_index]._child[pos], start, end);
+      updateEntry(node_index, pos);
+      if (child_index == INVALID_NODE)
+         return INVALID_NODE;
+
+      // The child split, its new right half goes right after it
+      value = getMaxLength(child_index);
+      start = _nodes[child_index]._start[0];
+      pos ++;
+   }
+
+   UInt32 split_index = INVALID_NODE;
+   UInt32 target_index = node_index;
+   if (_nodes[node_index]._num_entries == FANOUT)
+   {
+      split_index = allocateNode(_nodes[node_index]._is_leaf);
+      moveEntries(split_index, 0, node_index, FANOUT / 2, FANOUT / 2);
+      if (pos > FANOUT / 2)
+      {
+         target_index = split_index;
+         pos -= FANOUT / 2;
+      }
+   }
+
+   insertEntry(target_index, pos, start, value, child_index);
+   return split_index;
+}
+
+void
+QueueModelHistoryBTree::eraseFrom(UInt32 node_index, UInt64 start)
+{
+   UInt32 pos = findChild(node_index, start);
+
+   if (_nodes[node_index]._is_leaf)
+   {
+      LOG_ASSERT_ERROR(_nodes[node_index]._start[pos] == start,
+            "Free interval starting at %llu not found", start);
+      removeEntry(node_index, pos);
+      return;
+   }
+
+   UInt32 child_index = _nodes[node_index]._child[pos];
+   eraseFrom(child_index, start);
+   if (_nodes[child_index]._num_entries < MIN_ENTRIES)
+      rebalance(node_index, pos);
+   else
+      updateEntry(node_index, pos);
+}
+
+void
+QueueModelHistoryBTree::replaceIn(UInt32 node_index, UInt64 start, UInt64 new_start, UInt64 new_end)
+{
+   UInt32 pos = findChild(node_index, start);
+
+   if (_nodes[node_index]._is_leaf)
+   {
+      LOG_ASSERT_ERROR(_nodes[node_index]._start[pos] == start,
+            "Free interval starting at %llu not found", start);
+      _nodes[node_index]._start[pos] = new_start;
+      _nodes[node_index]._value[pos] = new_end;
+      return;
+   }
+
+   replaceIn(_nodes[node_index]._child[pos], start, new_start, new_end);
+   updateEntry(node_index, pos);
+}
+
+void
+QueueModelHistoryBTree::rebalance(UInt32 parent_index, UInt32 pos)
+{
+   // Only the root may be left with a single child, eraseInterval() collapses it
+   if (_nodes[parent_index]._num_entries == 1)
+   {
+      updateEntry(parent_index, pos);
+      return;
+   }
+
+   UInt32 left_pos = (pos + 1 < _nodes[parent_index]._num_entries) ? pos : (pos - 1);
+   UInt32 left_index = _nodes[parent_index]._child[left_pos];
+   UInt32 right_index = _nodes[parent_index]._child[left_pos + 1];
+   UInt32 num_left = _nodes[left_index]._num_entries;
+   UInt32 num_right = _nodes[right_index]._num_entries;
+
+   if (num_left + num_right <= FANOUT)
+   {
+      // Merge the right sibling into the left one
+      moveEntries(left_index, num_left, right_index, 0, num_right);
+      releaseNode(right_index);
+      removeEntry(parent_index, left_pos + 1);
+      updateEntry(parent_index, left_pos);
+   }
+   else
+   {
+      // Split the entries evenly between the two
+      UInt32 half = (num_left + num_right) / 2;
+      if (num_left < half)
+         moveEntries(left_index, num_left, right_index, 0, half - num_left);
+      else
+         moveEntries(right_index, 0, left_index, half, num_left - half);
+      updateEntry(parent_index, left_pos);
+      updateEntry(parent_index, left_pos + 1);
+   }
+}
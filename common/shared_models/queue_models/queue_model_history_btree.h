@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+
+#include "fixed_types.h"
+#include "queue_model.h"
+#include "queue_model_m_g_1.h"
+
+// Same model as QueueModelHistoryList (with interleaving disabled): the queue
+// keeps a bounded history of free intervals and a packet is scheduled in the
+// first interval it fits in. The free intervals live in a B+-tree whose nodes
+// are allocated from a flat array. Internal nodes keep the smallest start
+// and the largest length of the intervals under each child, so that both the
+// interval containing the packet and the first later interval that is long
+// enough to hold it are found in O(log n) instead of walking the list.
+
+class QueueModelHistoryBTree : public QueueModel
+{
+public:
+   QueueModelHistoryBTree(UInt64 min_processing_time);
+   QueueModelHistoryBTree(UInt64 min_processing_time, UInt32 max_list_size, bool analytical_model_enabled);
+   ~QueueModelHistoryBTree();
+
+   UInt64 computeQueueDelay(UInt64 pkt_time, UInt64 processing_time, tile_id_t requester = INVALID_TILE_ID);
+   UInt64 getTotalRequestsUsingAnalyticalModel() { return _total_requests_using_analytical_model; }
+
+private:
+   static const UInt32 FANOUT = 16;
+   static const UInt32 MIN_ENTRIES = FANOUT / 4;
+   static const UInt32 INVALID_NODE = ~0U;
+
+   // In a leaf, entry i is the free interval [_start[i], _value[i]).
+   // In an internal node, entry i is the subtree _child[i], with _start[i] the
+   // smallest start and _value[i] the largest interval length in it.
+   struct Node
+   {
+      UInt32 _num_entries;
+      bool _is_leaf;
+      UInt64 _start[FANOUT];
+      UInt64 _value[FANOUT];
+      UInt32 _child[FANOUT];
+   };
+
+   QueueModelMG1* _queue_model_m_g_1;
+
+   std::vector<Node> _nodes;
+   std::vector<UInt32> _free_nodes;
+   UInt32 _root;
+   UInt32 _num_intervals;
+
+   // Is analytical model used ?
+   bool _analytical_model_enabled;
+
+   UInt64 _min_processing_time;
+   UInt32 _max_free_interval_list_size;
+
+   UInt64 _total_requests_using_analytical_model;
+
+   void initialize();
+   UInt64 computeUsingHistory(UInt64 pkt_time, UInt64 processing_time);
+
+   // Free interval index
+   void insertInterval(UInt64 start, UInt64 end);
+   void eraseInterval(UInt64 start);
+   // Shrinks an interval, which keeps its place in the order of the intervals
+   void replaceInterval(UInt64 start, UInt64 new_start, UInt64 new_end);
+   std::pair<UInt64,UInt64> getFirstInterval();
+   bool findContainingInterval(UInt64 time, std::pair<UInt64,UInt64>& interval);
+   bool findIntervalAfter(UInt32 node_index, UInt64 time, UInt64 length, std::pair<UInt64,UInt64>& interval);
+
+   // Node management
+   UInt32 allocateNode(bool is_leaf);
+   void releaseNode(UInt32 node_index);
+   UInt64 getMaxLength(UInt32 node_index);
+   void updateEntry(UInt32 parent_index, UInt32 pos);
+   void insertEntry(UInt32 node_index, UInt32 pos, UInt64 start, UInt64 value, UInt32 child);
+   void removeEntry(UInt32 node_index, UInt32 pos);
+   void moveEntries(UInt32 dst_index, UInt32 dst_pos, UInt32 src_index, UInt32 src_pos, UInt32 num_entries);
+   UInt32 findChild(UInt32 node_index, UInt64 start);
+   UInt32 insertInto(UInt32 node_index, UInt64 start, UInt64 end);
+   void eraseFrom(UInt32 node_index, UInt64 start);
+   void replaceIn(UInt32 node_index, UInt64 start, UInt64 new_start, UInt64 new_end);
+   void rebalance(UInt32 parent_index, UInt32 pos);
+};
@@ -24,7 +24,24 @@ QueueModelHistoryList::QueueModelHistoryList(UInt64 min_processing_time)
    {
       LOG_PRINT_ERROR("Could not read parameters from cfg");
    }
-   
+
+   initialize();
+}
+
+QueueModelHistoryList::QueueModelHistoryList(UInt64 min_processing_time, UInt32 max_list_size,
+                                             bool analytical_model_enabled, bool interleaving_enabled)
+   : QueueModel(HISTORY_LIST)
+   , _analytical_model_enabled(analytical_model_enabled)
+   , _min_processing_time(min_processing_time)
+   , _max_free_interval_list_size(max_list_size)
+   , _interleaving_enabled(interleaving_enabled)
+{
+   initialize();
+}
+
+void
+QueueModelHistoryList::initialize()
+{
    _free_interval_list.push_back(std::make_pair<UInt64,UInt64>(0, UINT64_MAX));
    _queue_model_m_g_1 = new QueueModelMG1();
 
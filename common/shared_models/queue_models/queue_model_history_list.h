@@ -11,6 +11,8 @@ class QueueModelHistoryList : public QueueModel
 {
 public:
    QueueModelHistoryList(UInt64 min_processing_time);
+   QueueModelHistoryList(UInt64 min_processing_time, UInt32 max_list_size,
+                         bool analytical_model_enabled, bool interleaving_enabled);
    ~QueueModelHistoryList();
 
    UInt64 computeQueueDelay(UInt64 pkt_time, UInt64 processing_time, tile_id_t requester = INVALID_TILE_ID);
@@ -35,6 +37,7 @@ private:
    UInt64 _total_requests;
    UInt64 _total_requests_using_analytical_model;
 
+   void initialize();
    UInt64 computeUsingHistoryList(UInt64 pkt_time, UInt64 processing_time);
    void insertInHistoryList(UInt64 pkt_time, UInt64 processing_time);
 };
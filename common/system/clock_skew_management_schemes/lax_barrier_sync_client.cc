@@ -54,7 +54,7 @@ LaxBarrierSyncClient::synchronize(Time time)
       assert(recv_pkt.length == sizeof(int));
 
       unsigned int dummy;
-      m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+      m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
       m_recv_buff >> dummy;
       assert(dummy == BARRIER_RELEASE);
 
@@ -61,7 +61,7 @@ LaxBarrierSyncServer::barrierWait(core_id_t core_id)
 
    LOG_PRINT("Received 'SIM_BARRIER_WAIT' from Core(%i, %i), Time(%llu)", core_id.tile_id, core_id.core_type, time_ns);
 
-   LOG_ASSERT_ERROR(m_thread_manager->isCoreRunning(core_id) != INVALID_THREAD_ID || m_thread_manager->isCoreInitializing(core_id) != INVALID_THREAD_ID, "Thread on core(%i) is not running or initializing at time(%llu)", core_id, time_ns);
+   LOG_ASSERT_ERROR(m_thread_manager->isCoreRunning(core_id) != INVALID_THREAD_ID || m_thread_manager->isCoreInitializing(core_id), "Thread on core(%i) is not running or initializing at time(%llu)", core_id, time_ns);
 
    if (time_ns < m_next_barrier_time)
    {
@@ -104,7 +104,7 @@ LaxBarrierSyncServer::isBarrierReached()
       }
       else
       {
-         LOG_ASSERT_ERROR(m_thread_manager->isCoreRunning(tile_id) != INVALID_THREAD_ID  || m_thread_manager->isCoreInitializing(tile_id) != INVALID_THREAD_ID , "Thread on core(%i) is not running or initializing at local_clock(%llu), m_next_barrier_time(%llu)", tile_id, m_local_clock_list[tile_id], m_next_barrier_time);
+         LOG_ASSERT_ERROR(m_thread_manager->isCoreRunning(tile_id) != INVALID_THREAD_ID || m_thread_manager->isCoreInitializing(tile_id), "Thread on core(%i) is not running or initializing at local_clock(%llu), m_next_barrier_time(%llu)", tile_id, m_local_clock_list[tile_id], m_next_barrier_time);
 
          // At least one thread has reached the barrier
          single_thread_barrier_reached = true;
@@ -140,7 +140,7 @@ LaxBarrierSyncServer::barrierRelease()
             // Check if this core was running. If yes, send a message to that core
             if (m_barrier_acquire_list[tile_id] == true)
             {
-               LOG_ASSERT_ERROR(m_thread_manager->isCoreRunning(tile_id) != INVALID_THREAD_ID || m_thread_manager->isCoreInitializing(tile_id) != INVALID_THREAD_ID, "(%i) has acquired barrier, local_clock(%i), m_next_barrier_time(%llu), but not initializing or running", tile_id, m_local_clock_list[tile_id], m_next_barrier_time);
+               LOG_ASSERT_ERROR(m_thread_manager->isCoreRunning(tile_id) != INVALID_THREAD_ID || m_thread_manager->isCoreInitializing(tile_id), "(%i) has acquired barrier, local_clock(%i), m_next_barrier_time(%llu), but not initializing or running", tile_id, m_local_clock_list[tile_id], m_next_barrier_time);
 
                unsigned int reply = LaxBarrierSyncClient::BARRIER_RELEASE;
 
@@ -66,7 +66,7 @@ LaxP2PSyncClient::netProcessSyncMsg(const NetPacket& recv_pkt)
    UInt64 time;
 
    UnstructuredBuffer recv_buf;
-   recv_buf << make_pair(recv_pkt.data, recv_pkt.length);
+   recv_buf.wrap(recv_pkt.data, recv_pkt.length);
    
    recv_buf >> msg_type >> time;
    SyncMsg sync_msg(recv_pkt.sender, (SyncMsg::MsgType) msg_type, time);
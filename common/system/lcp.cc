@@ -87,7 +87,7 @@ void LCP::processPacket()
       break;
    }
 
-   delete [] pkt;
+   m_transport->releaseBuffer(pkt);
 }
 
 void LCP::finish()
@@ -11,6 +11,7 @@
 #include "syscall.h"
 #include "thread_manager.h"
 #include "thread_scheduler.h"
+#include "utils.h"
 
 using namespace std;
 
@@ -21,8 +22,11 @@ MCP::MCP(Network & network)
    , m_scratch(new char[m_MCP_SERVER_MAX_BUFF])
    , m_vm_manager()
    , m_syscall_server(m_network, m_send_buff, m_recv_buff, m_MCP_SERVER_MAX_BUFF, m_scratch)
-   , m_sync_server(m_network, m_recv_buff)
+   , m_sync_server(m_network, m_recv_buff, m_thread_state_lock)
    , m_clock_skew_management_server(NULL)
+   , m_total_messages(0)
+   , m_total_sync_messages(0)
+   , m_total_busy_time(0)
 {
    m_clock_skew_management_server = ClockSkewManagementServer::create(Sim()->getCfg()->getString("clock_skew_management/scheme"), m_network, m_recv_buff);
 }
@@ -46,7 +50,7 @@ void MCP::processPacket()
    match.types.push_back(MCP_SYSTEM_TYPE);
    recv_pkt = m_network.netRecv(match);
 
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    int msg_type;
 
@@ -54,6 +58,17 @@ void MCP::processPacket()
 
    LOG_PRINT("MCP message type(%i), sender(%i,%i)", (SInt32) msg_type, recv_pkt.sender.tile_id, recv_pkt.sender.core_type);
 
+   UInt64 start_time = getWallClockTime();
+
+   bool is_sync_message = isSyncMessage(msg_type);
+   if (!is_sync_message)
+   {
+      // The sync server shards may still be working on earlier requests of
+      // the sender (e.g., a barrier wait followed by a yield)
+      m_sync_server.waitForPendingRequests(recv_pkt.sender.tile_id);
+      m_thread_state_lock.acquire();
+   }
+
    switch (msg_type)
    {
    case MCP_MESSAGE_SYS_CALL:
@@ -61,37 +76,21 @@ void MCP::processPacket()
       break;
    case MCP_MESSAGE_QUIT:
       LOG_PRINT("Quit message received.");
+      m_sync_server.finish();
       m_finished = true;
       break;
 
    case MCP_MESSAGE_MUTEX_INIT:
-      m_sync_server.mutexInit(recv_pkt.sender);
-      break;
    case MCP_MESSAGE_MUTEX_LOCK:
-      m_sync_server.mutexLock(recv_pkt.sender);
-      break;
    case MCP_MESSAGE_MUTEX_UNLOCK:
-      m_sync_server.mutexUnlock(recv_pkt.sender);
-      break;
-
    case MCP_MESSAGE_COND_INIT:
-      m_sync_server.condInit(recv_pkt.sender);
-      break;
    case MCP_MESSAGE_COND_WAIT:
-      m_sync_server.condWait(recv_pkt.sender);
-      break;
    case MCP_MESSAGE_COND_SIGNAL:
-      m_sync_server.condSignal(recv_pkt.sender);
-      break;
    case MCP_MESSAGE_COND_BROADCAST:
-      m_sync_server.condBroadcast(recv_pkt.sender);
-      break;
-
    case MCP_MESSAGE_BARRIER_INIT:
-      m_sync_server.barrierInit(recv_pkt.sender);
-      break;
    case MCP_MESSAGE_BARRIER_WAIT:
-      m_sync_server.barrierWait(recv_pkt.sender);
+      m_sync_server.processRequest(msg_type, recv_pkt.sender);
+      m_total_sync_messages ++;
       break;
 
    case MCP_MESSAGE_THREAD_SPAWN_REQUEST_FROM_REQUESTER:
@@ -152,11 +151,36 @@ void MCP::processPacket()
       LOG_PRINT_ERROR("Unhandled MCP message type: %i from %i", msg_type, recv_pkt.sender);
    }
 
+   if (!is_sync_message)
+      m_thread_state_lock.release();
+
+   m_total_messages ++;
+   m_total_busy_time += (getWallClockTime() - start_time);
+
    delete [](Byte*)recv_pkt.data;
 
    LOG_PRINT("Finished processing message -- type : %d", (int)msg_type);
 }
 
+bool MCP::isSyncMessage(SInt32 msg_type)
+{
+   switch (msg_type)
+   {
+   case MCP_MESSAGE_MUTEX_INIT:
+   case MCP_MESSAGE_MUTEX_LOCK:
+   case MCP_MESSAGE_MUTEX_UNLOCK:
+   case MCP_MESSAGE_COND_INIT:
+   case MCP_MESSAGE_COND_WAIT:
+   case MCP_MESSAGE_COND_SIGNAL:
+   case MCP_MESSAGE_COND_BROADCAST:
+   case MCP_MESSAGE_BARRIER_INIT:
+   case MCP_MESSAGE_BARRIER_WAIT:
+      return true;
+   default:
+      return false;
+   }
+}
+
 void MCP::finish()
 {
    LOG_PRINT("Send MCP quit message");
@@ -187,3 +211,16 @@ void MCP::run()
    }
 }
 
+
+void MCP::outputSummary(ostream &os)
+{
+   // Messages per second of host time spent handling them
+   UInt64 throughput = (m_total_busy_time > 0) ? (m_total_messages * 1000000 / m_total_busy_time) : 0;
+
+   os << "MCP Summary:" << endl
+      << "    Total Messages: " << m_total_messages << endl
+      << "    Sync Server Messages: " << m_total_sync_messages << endl
+      << "    Sync Server Shards: " << m_sync_server.getNumShards() << endl
+      << "    Busy Time (in microseconds): " << m_total_busy_time << endl
+      << "    Throughput (messages/sec): " << throughput << endl;
+}
@@ -1,6 +1,8 @@
 #ifndef MCP_H
 #define MCP_H
 
+#include <iostream>
+
 #include "message_types.h"
 #include "packetize.h"
 #include "network.h"
@@ -10,6 +12,7 @@
 #include "clock_skew_management_object.h"
 #include "fixed_types.h"
 #include "thread.h"
+#include "lock.h"
 
 class MCP : public Runnable
 {
@@ -22,10 +25,14 @@ class MCP : public Runnable
       void finish();
       Boolean finished() { return m_finished; };
 
+      void outputSummary(std::ostream &os);
+
       VMManager* getVMManager() { return &m_vm_manager; }
       ClockSkewManagementServer* getClockSkewManagementServer() { return m_clock_skew_management_server; }
 
    private:
+      static bool isSyncMessage(SInt32 msg_type);
+
       Boolean m_finished;
       Network & m_network;
       UnstructuredBuffer m_send_buff;
@@ -33,10 +40,19 @@ class MCP : public Runnable
       const UInt32 m_MCP_SERVER_MAX_BUFF;
       char *m_scratch;
 
+      // Held while handling requests that change the state of the threads,
+      // so that the sync server shards can stall and resume threads safely
+      Lock m_thread_state_lock;
+
       VMManager m_vm_manager;
       SyscallServer m_syscall_server;
       SyncServer m_sync_server;
       ClockSkewManagementServer* m_clock_skew_management_server;
+
+      // Statistics
+      UInt64 m_total_messages;
+      UInt64 m_total_sync_messages;
+      UInt64 m_total_busy_time;   // in microseconds
 };
 
 #endif
@@ -18,20 +18,14 @@
 #include "clock_skew_management_object.h"
 #include "statistics_manager.h"
 #include "statistics_thread.h"
+#include "event_tracer.h"
+#include "utils.h"
 #include "contrib/dsent/dsent_contrib.h"
 #include "contrib/mcpat/cacti/io.h"
 
 Simulator *Simulator::m_singleton;
 config::Config *Simulator::m_config_file;
 
-static UInt64 getTime()
-{
-   timeval t;
-   gettimeofday(&t, NULL);
-   UInt64 time = (((UInt64)t.tv_sec) * 1000000 + t.tv_usec);
-   return time;
-}
-
 void Simulator::allocate()
 {
    assert(m_singleton == NULL);
@@ -71,8 +65,9 @@ Simulator::Simulator()
    , m_clock_skew_management_manager(NULL)
    , m_statistics_manager(NULL)
    , m_statistics_thread(NULL)
+   , m_event_tracer(NULL)
    , m_finished(false)
-   , m_boot_time(getTime())
+   , m_boot_time(getWallClockTime())
    , m_start_time(0)
    , m_stop_time(0)
    , m_shutdown_time(0)
@@ -123,6 +118,13 @@ void Simulator::start()
       m_statistics_thread->start();
    }
 
+   // Binary event trace
+   if (getCfg()->getBool("trace/enabled", false))
+   {
+      m_event_tracer = new EventTracer();
+      m_event_tracer->start();
+   }
+
    startMCP();
 
    m_sim_thread_manager->spawnSimThreads();
@@ -134,7 +136,7 @@ void Simulator::start()
 
 Simulator::~Simulator()
 {
-   m_shutdown_time = getTime();
+   m_shutdown_time = getWallClockTime();
 
    LOG_PRINT("Simulator dtor starting...");
 
@@ -145,6 +147,9 @@ Simulator::~Simulator()
    if (m_statistics_thread)
       m_statistics_thread->finish();
 
+   if (m_event_tracer)
+      m_event_tracer->finish();
+
    m_lcp->finish();
 
    m_transport->barrier();
@@ -160,6 +165,8 @@ Simulator::~Simulator()
          << setw(35) << "Shutdown Time (in microseconds)" << (m_shutdown_time - m_boot_time) << endl;
 
       m_tile_manager->outputSummary(os);
+      if (m_mcp)
+         m_mcp->outputSummary(os);
       os.close();
    }
    else
@@ -184,6 +191,9 @@ Simulator::~Simulator()
       delete m_statistics_thread;
       delete m_statistics_manager;
    }
+
+   if (m_event_tracer)
+      delete m_event_tracer;
   
    // Clock Skew Manager 
    if (m_clock_skew_management_manager)
@@ -204,12 +214,12 @@ Simulator::~Simulator()
 
 void Simulator::startTimer()
 {
-   m_start_time = getTime();
+   m_start_time = getWallClockTime();
 }
 
 void Simulator::stopTimer()
 {
-   m_stop_time = getTime();
+   m_stop_time = getWallClockTime();
 }
 
 void Simulator::broadcastFinish()
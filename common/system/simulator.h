@@ -17,6 +17,7 @@ class SimThreadManager;
 class ClockSkewManagementManager;
 class StatisticsManager;
 class StatisticsThread;
+class EventTracer;
 
 class Simulator
 {
@@ -86,6 +87,7 @@ private:
    ClockSkewManagementManager *m_clock_skew_management_manager;
    StatisticsManager *m_statistics_manager;
    StatisticsThread *m_statistics_thread;
+   EventTracer *m_event_tracer;
 
    static Simulator *m_singleton;
 
@@ -5,6 +5,7 @@
 #include "tile.h"
 #include "packetize.h"
 #include "mcp.h"
+#include "event_tracer.h"
 
 #include "simulator.h"
 #include "thread_scheduler.h"
@@ -57,7 +58,7 @@ void SyncClient::mutexLock(carbon_mutex_t *mux)
 
    m_send_buff << msg_type << *mux << start_time;
 
-   LOG_PRINT("mutexLock(): mux(%u), start_time(%llu ps)", *mux, start_time);
+   TRACE_EVENT(SYSTEM_MUTEX_LOCK, m_core->getTile()->getId(), Time(start_time).toNanosec(), *mux, 0, 0);
    m_network->netSend(Config::getSingleton()->getMCPCoreId(), MCP_REQUEST_TYPE, m_send_buff.getBuffer(), m_send_buff.size());
 
    // Set the CoreState to 'STALLED'
@@ -72,7 +73,7 @@ void SyncClient::mutexLock(carbon_mutex_t *mux)
 
    unsigned int dummy;
    UInt64 time;
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
    m_recv_buff >> dummy;
    assert(dummy == MUTEX_LOCK_RESPONSE);
 
@@ -102,7 +103,7 @@ void SyncClient::mutexUnlock(carbon_mutex_t *mux)
 
    m_send_buff << msg_type << *mux << start_time;
 
-   LOG_PRINT("mutexUnlock(): mux(%u), start_time(%llu ps)", *mux, start_time);
+   TRACE_EVENT(SYSTEM_MUTEX_UNLOCK, m_core->getTile()->getId(), Time(start_time).toNanosec(), *mux, 0, 0);
    m_network->netSend(Config::getSingleton()->getMCPCoreId(), MCP_REQUEST_TYPE, m_send_buff.getBuffer(), m_send_buff.size());
 
    NetPacket recv_pkt;
@@ -110,7 +111,7 @@ void SyncClient::mutexUnlock(carbon_mutex_t *mux)
    assert(recv_pkt.length == sizeof(unsigned int));
 
    unsigned int dummy;
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
    m_recv_buff >> dummy;
    assert(dummy == MUTEX_UNLOCK_RESPONSE);
 
@@ -152,7 +153,7 @@ void SyncClient::condWait(carbon_cond_t *cond, carbon_mutex_t *mux)
 
    m_send_buff << msg_type << *cond << *mux << start_time;
 
-   LOG_PRINT("condWait(): cond(%u), mux(%u), start_time(%llu ps)", *cond, *mux, start_time);
+   TRACE_EVENT(SYSTEM_COND_WAIT, m_core->getTile()->getId(), Time(start_time).toNanosec(), *cond, *mux, 0);
    m_network->netSend(Config::getSingleton()->getMCPCoreId(), MCP_REQUEST_TYPE, m_send_buff.getBuffer(), m_send_buff.size());
 
    // Set the CoreState to 'STALLED'
@@ -166,7 +167,7 @@ void SyncClient::condWait(carbon_cond_t *cond, carbon_mutex_t *mux)
    m_core->setState(Core::WAKING_UP);
 
    unsigned int dummy;
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
    m_recv_buff >> dummy;
    assert(dummy == COND_WAIT_RESPONSE);
 
@@ -197,7 +198,7 @@ void SyncClient::condSignal(carbon_cond_t *cond)
 
    m_send_buff << msg_type << *cond << start_time;
 
-   LOG_PRINT("condSignal(): cond(%u), start_time(%llu) ps", *cond, start_time);
+   TRACE_EVENT(SYSTEM_COND_SIGNAL, m_core->getTile()->getId(), Time(start_time).toNanosec(), *cond, 0, 0);
    m_network->netSend(Config::getSingleton()->getMCPCoreId(), MCP_REQUEST_TYPE, m_send_buff.getBuffer(), m_send_buff.size());
 
    NetPacket recv_pkt;
@@ -205,7 +206,7 @@ void SyncClient::condSignal(carbon_cond_t *cond)
    assert(recv_pkt.length == sizeof(unsigned int));
 
    unsigned int dummy;
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
    m_recv_buff >> dummy;
    assert(dummy == COND_SIGNAL_RESPONSE);
 
@@ -224,7 +225,7 @@ void SyncClient::condBroadcast(carbon_cond_t *cond)
 
    m_send_buff << msg_type << *cond << start_time;
 
-   LOG_PRINT("condBroadcast(): cond(%u), start_time(%llu ps)", *cond, start_time);
+   TRACE_EVENT(SYSTEM_COND_BROADCAST, m_core->getTile()->getId(), Time(start_time).toNanosec(), *cond, 0, 0);
    m_network->netSend(Config::getSingleton()->getMCPCoreId(), MCP_REQUEST_TYPE, m_send_buff.getBuffer(), m_send_buff.size());
 
    NetPacket recv_pkt;
@@ -232,7 +233,7 @@ void SyncClient::condBroadcast(carbon_cond_t *cond)
    assert(recv_pkt.length == sizeof(unsigned int));
 
    unsigned int dummy;
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
    m_recv_buff >> dummy;
    assert(dummy == COND_BROADCAST_RESPONSE);
 
@@ -274,7 +275,7 @@ void SyncClient::barrierWait(carbon_barrier_t *barrier)
 
    m_send_buff << msg_type << *barrier << start_time;
 
-   LOG_PRINT("barrierWait(): barrier(%u), start_time(%llu ps)", *barrier, start_time);
+   TRACE_EVENT(SYSTEM_BARRIER_WAIT, m_core->getTile()->getId(), Time(start_time).toNanosec(), *barrier, 0, 0);
    m_network->netSend(Config::getSingleton()->getMCPCoreId(), MCP_REQUEST_TYPE, m_send_buff.getBuffer(), m_send_buff.size());
 
    ThreadScheduler * thread_scheduler = Sim()->getThreadScheduler();
@@ -290,7 +291,8 @@ void SyncClient::barrierWait(carbon_barrier_t *barrier)
    assert(recv_pkt.length == sizeof(unsigned int) + sizeof(UInt64));
 
 
-   LOG_PRINT("barrierResponse!: barrier(%u), start_time(%llu ps)", *barrier, start_time);
+   TRACE_EVENT(SYSTEM_BARRIER_RESPONSE, m_core->getTile()->getId(), m_core->getModel()->getCurrTime().toNanosec(),
+               *barrier, Time(start_time).toNanosec(), 0);
 
    // Set the CoreState to 'RUNNING'
    m_core->setState(Core::WAKING_UP);
@@ -298,7 +300,7 @@ void SyncClient::barrierWait(carbon_barrier_t *barrier)
    thread_scheduler->yieldThread(false);  // False for non-preemptive yield
 
    unsigned int dummy;
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
    m_recv_buff >> dummy;
    assert(dummy == BARRIER_WAIT_RESPONSE);
 
@@ -1,9 +1,14 @@
+#include <sched.h>
+
 #include "sync_server.h"
 #include "sync_client.h"
 #include "simulator.h"
 #include "thread_manager.h"
 #include "tile_manager.h"
 #include "thread_scheduler.h"
+#include "message_types.h"
+#include "config.h"
+#include "log.h"
 
 using namespace std;
 
@@ -33,7 +38,6 @@ bool SimMutex::lock(core_id_t core_id)
    }
    else
    {
-      Sim()->getThreadManager()->stallThread(core_id);
       m_waiting.push(core_id);
       return false;
    }
@@ -51,7 +55,6 @@ core_id_t SimMutex::unlock(core_id_t core_id)
    {
       m_owner =  m_waiting.front();
       m_waiting.pop();
-      Sim()->getThreadManager()->resumeThread(m_owner);
    }
    return m_owner;
 }
@@ -64,57 +67,28 @@ SimCond::~SimCond()
    assert(m_waiting.empty());
 }
 
-core_id_t SimCond::wait(core_id_t core_id, UInt64 time, StableIterator<SimMutex> & simMux)
+void SimCond::wait(core_id_t core_id, carbon_mutex_t mutex, UInt64 time)
 {
-   Sim()->getThreadManager()->stallThread(core_id);
-
    // If we don't have any later signals, then put this request in the queue
-   m_waiting.push_back(CondWaiter(core_id, simMux, time));
-   return simMux->unlock(core_id);
+   m_waiting.push_back(CondWaiter(core_id, mutex, time));
 }
 
-core_id_t SimCond::signal(core_id_t core_id, UInt64 time)
+bool SimCond::signal(core_id_t core_id, UInt64 time, CondWaiter &woken)
 {
-   // If there is a list of threads waiting, wake up one of them
-   if (!m_waiting.empty())
-   {
-      CondWaiter woken = *(m_waiting.begin());
-      m_waiting.erase(m_waiting.begin());
-
-      Sim()->getThreadManager()->resumeThread(woken.m_core_id);
-
-      if (woken.m_mutex->lock(woken.m_core_id))
-      {
-         // Woken up thread is able to grab lock immediately
-         return woken.m_core_id;
-      }
-      else
-      {
-         // Woken up thread is *NOT* able to grab lock immediately
-         return INVALID_CORE_ID;
-      }
-   }
-
    // There are *NO* threads waiting on the condition variable
-   return INVALID_CORE_ID;
+   if (m_waiting.empty())
+      return false;
+
+   // If there is a list of threads waiting, wake up one of them
+   woken = *(m_waiting.begin());
+   m_waiting.erase(m_waiting.begin());
+   return true;
 }
 
 void SimCond::broadcast(core_id_t core_id, UInt64 time, WakeupList &woken_list)
 {
-   for (ThreadQueue::iterator i = m_waiting.begin(); i != m_waiting.end(); i++)
-   {
-      CondWaiter woken = *(i);
-
-      Sim()->getThreadManager()->resumeThread(woken.m_core_id);
-
-      if (woken.m_mutex->lock(woken.m_core_id))
-      {
-         // Woken up thread is able to grab lock immediately
-         woken_list.push_back(woken.m_core_id);
-      }
-   }
-
-   // All waiting threads have been woken up from the CondVar queue
+   // All waiting threads are woken up from the CondVar queue
+   woken_list = m_waiting;
    m_waiting.clear();
 }
 
@@ -134,8 +108,6 @@ void SimBarrier::wait(core_id_t core_id, UInt64 time, WakeupList &woken_list)
 {
    m_waiting.push_back(core_id);
 
-   Sim()->getThreadManager()->stallThread(core_id);
-
    assert(m_waiting.size() <= m_count);
 
    if (m_waiting.size() == 1)
@@ -146,238 +118,453 @@ void SimBarrier::wait(core_id_t core_id, UInt64 time, WakeupList &woken_list)
    // All threads have reached the barrier
    if (m_waiting.size() == m_count)
    {
-      woken_list = m_waiting;
-
-      vector<bool> resumed_tiles(woken_list.size(), false);
-      for (WakeupList::iterator i = woken_list.begin(); i != woken_list.end(); i++)
-      {
-         // Skip duplicates (when more than one thread is on a core, we just resume the first one)
-         // Resuming all the threads stalled at the barrier
-         if (!resumed_tiles[i->tile_id])
-         {
-            resumed_tiles[i->tile_id] = true;
-            Sim()->getThreadManager()->resumeThread(*i);
-         }
-      }
-
-      m_waiting.clear();
+      woken_list.swap(m_waiting);
+      m_waiting.reserve(m_count);
    }
 }
 
 // -- SyncServer -- //
 
-SyncServer::SyncServer(Network &network, UnstructuredBuffer &recv_buffer)
-      : m_network(network),
-      m_recv_buffer(recv_buffer)
-{ }
+SyncServer::SyncServer(Network &network, UnstructuredBuffer &recv_buffer, Lock &thread_state_lock)
+      : m_network(network)
+      , m_recv_buffer(recv_buffer)
+      , m_thread_state_lock(thread_state_lock)
+      , m_next_init_shard(0)
+{
+   UInt32 num_shards = Sim()->getCfg()->getInt("sync_server/num_shards", 1);
+   LOG_ASSERT_ERROR(num_shards >= 1, "sync_server/num_shards(%u) must be at least 1", num_shards);
 
-SyncServer::~SyncServer()
-{ }
+   m_threaded = (num_shards > 1);
 
-void SyncServer::mutexInit(core_id_t core_id)
-{
-   m_mutexes.push_back(SimMutex());
-   UInt32 mux = (UInt32)m_mutexes.size()-1;
+   UInt32 num_tiles = Config::getSingleton()->getTotalTiles();
+   m_num_pending_requests = new SInt32[num_tiles];
+   for (UInt32 i = 0; i < num_tiles; i++)
+      m_num_pending_requests[i] = 0;
+
+   for (UInt32 i = 0; i < num_shards; i++)
+      m_shards.push_back(new Shard(this, i));
 
-   m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&mux, sizeof(mux));
+   if (m_threaded)
+   {
+      for (UInt32 i = 0; i < num_shards; i++)
+         m_shards[i]->start();
+   }
 }
 
-void SyncServer::mutexLock(core_id_t core_id)
+SyncServer::~SyncServer()
 {
-   carbon_mutex_t mux;
-   m_recv_buffer >> mux;
+   for (UInt32 i = 0; i < m_shards.size(); i++)
+      delete m_shards[i];
+   delete [] m_num_pending_requests;
+}
 
-   UInt64 time;
-   m_recv_buffer >> time;
+void SyncServer::finish()
+{
+   if (!m_threaded)
+      return;
 
-   LOG_ASSERT_ERROR((size_t)mux < m_mutexes.size(), "mux(%i), total muxes(%u)", mux, m_mutexes.size());
+   for (UInt32 i = 0; i < m_shards.size(); i++)
+      m_shards[i]->finish();
+}
 
-   SimMutex *psimmux = &m_mutexes[mux];
+void SyncServer::processRequest(SInt32 msg_type, core_id_t core_id)
+{
+   Request req;
+   req.msg_type = msg_type;
+   req.core_id = core_id;
+   req.object = 0;
+   req.mutex = 0;
+   req.time = 0;
+
+   // Remaining parameters are stored in the recv buffer
+   // (see SyncClient for the layout of each request)
+   switch (msg_type)
+   {
+   case MCP_MESSAGE_MUTEX_INIT:
+      break;
+   case MCP_MESSAGE_COND_WAIT:
+      m_recv_buffer >> req.object >> req.mutex >> req.time;
+      break;
+   case MCP_MESSAGE_BARRIER_INIT:
+      {
+         UInt32 count;
+         m_recv_buffer >> count >> req.time;
+         req.object = (SInt32) count;
+      }
+      break;
+   default:
+      m_recv_buffer >> req.object >> req.time;
+      break;
+   }
 
-   if (psimmux->lock(core_id))
+   UInt32 shard_index;
+   if ((msg_type == MCP_MESSAGE_MUTEX_INIT) || (msg_type == MCP_MESSAGE_COND_INIT) ||
+       (msg_type == MCP_MESSAGE_BARRIER_INIT))
    {
-      // notify the owner
-      Reply r;
-      r.dummy = SyncClient::MUTEX_LOCK_RESPONSE;
-      r.time = time;
-      m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&r, sizeof(r));
+      shard_index = m_next_init_shard;
+      m_next_init_shard = (m_next_init_shard + 1) % m_shards.size();
    }
    else
    {
-      // nothing...thread goes to sleep
+      shard_index = ((UInt32) req.object) % m_shards.size();
    }
+
+   dispatch(req, shard_index);
 }
 
-void SyncServer::mutexUnlock(core_id_t core_id)
+void SyncServer::dispatch(const Request &req, UInt32 shard_index)
 {
-   carbon_mutex_t mux;
-   m_recv_buffer >> mux;
+   if (!m_threaded)
+   {
+      m_shards[shard_index]->handleRequest(req);
+      return;
+   }
 
-   UInt64 time;
-   m_recv_buffer >> time;
+   __sync_fetch_and_add(&m_num_pending_requests[req.core_id.tile_id], 1);
+   m_shards[shard_index]->enqueue(req);
+}
 
-   assert((size_t)mux < m_mutexes.size());
+void SyncServer::waitForPendingRequests(tile_id_t tile_id)
+{
+   if (!m_threaded)
+      return;
 
-   SimMutex *psimmux = &m_mutexes[mux];
+   ScopedLock sl(m_pending_lock);
+   while (m_num_pending_requests[tile_id] > 0)
+      m_pending_cond.wait(m_pending_lock);
+}
 
-   core_id_t new_owner = psimmux->unlock(core_id);
+void SyncServer::stallThread(core_id_t core_id)
+{
+   ScopedLock sl(m_thread_state_lock);
+   Sim()->getThreadManager()->stallThread(core_id);
+}
 
-   if (new_owner.tile_id != INVALID_TILE_ID)
+void SyncServer::resumeThread(core_id_t core_id)
+{
+   ScopedLock sl(m_thread_state_lock);
+   Sim()->getThreadManager()->resumeThread(core_id);
+}
+
+void SyncServer::resumeThreads(const vector<core_id_t> &core_ids)
+{
+   ScopedLock sl(m_thread_state_lock);
+
+   vector<bool> resumed_tiles(Config::getSingleton()->getTotalTiles(), false);
+   for (vector<core_id_t>::const_iterator i = core_ids.begin(); i != core_ids.end(); i++)
    {
-      // wake up the new owner
-      Reply r;
-      r.dummy = SyncClient::MUTEX_LOCK_RESPONSE;
-      r.time = time;
-      m_network.netSend(new_owner, MCP_RESPONSE_TYPE, (char*)&r, sizeof(r));
+      // Skip duplicates (when more than one thread is on a core, we just resume the first one)
+      if (!resumed_tiles[i->tile_id])
+      {
+         resumed_tiles[i->tile_id] = true;
+         Sim()->getThreadManager()->resumeThread(*i);
+      }
    }
-   else
+}
+
+void SyncServer::sendReply(core_id_t core_id, UInt32 response, UInt64 time)
+{
+   Reply r;
+   r.dummy = response;
+   r.time = time;
+   m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&r, sizeof(r));
+}
+
+void SyncServer::sendReply(core_id_t core_id, UInt32 response)
+{
+   m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&response, sizeof(response));
+}
+
+// -- SyncServer::Shard -- //
+
+SyncServer::Shard::Shard(SyncServer *server, UInt32 index)
+      : m_server(server)
+      , m_index(index)
+      , m_thread(NULL)
+      , m_finished(false)
+{ }
+
+SyncServer::Shard::~Shard()
+{
+   delete m_thread;
+}
+
+void SyncServer::Shard::start()
+{
+   m_thread = Thread::create(this);
+   m_thread->run();
+}
+
+void SyncServer::Shard::enqueue(const Request &req)
+{
+   ScopedLock sl(m_queue_lock);
+   m_queue.push(req);
+   m_queue_cond.signal();
+}
+
+void SyncServer::Shard::run()
+{
+   LOG_PRINT("SyncServer shard %u started.", m_index);
+
+   while (true)
    {
-      // nothing...
+      m_queue_lock.acquire();
+      while (m_queue.empty())
+         m_queue_cond.wait(m_queue_lock);
+      Request req = m_queue.front();
+      m_queue.pop();
+      m_queue_lock.release();
+
+      if (req.msg_type == SHARD_QUIT)
+         break;
+
+      handleRequest(req);
+      if (__sync_sub_and_fetch(&m_server->m_num_pending_requests[req.core_id.tile_id], 1) == 0)
+      {
+         // The MCP may be waiting for this tile
+         ScopedLock sl(m_server->m_pending_lock);
+         m_server->m_pending_cond.broadcast();
+      }
    }
 
-   UInt32 dummy = SyncClient::MUTEX_UNLOCK_RESPONSE;
-   m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&dummy, sizeof(dummy));
+   m_finished = true;
 }
 
-// -- Condition Variable Stuffs -- //
-void SyncServer::condInit(core_id_t core_id)
+void SyncServer::Shard::finish()
 {
-   m_conds.push_back(SimCond());
-   UInt32 cond = (UInt32)m_conds.size()-1;
+   Request req;
+   req.msg_type = SHARD_QUIT;
+   req.core_id = INVALID_CORE_ID;
+   enqueue(req);
 
-   m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&cond, sizeof(cond));
+   while (!m_finished)
+      sched_yield();
+
+   LOG_PRINT("SyncServer shard %u finished.", m_index);
 }
 
-void SyncServer::condWait(core_id_t core_id)
+void SyncServer::Shard::handleRequest(const Request &req)
 {
-   carbon_cond_t cond;
-   carbon_mutex_t mux;
-   m_recv_buffer >> cond;
-   m_recv_buffer >> mux;
+   switch (req.msg_type)
+   {
+   case MCP_MESSAGE_MUTEX_INIT:
+      mutexInit(req);
+      break;
+   case MCP_MESSAGE_MUTEX_LOCK:
+      mutexLock(req);
+      break;
+   case MCP_MESSAGE_MUTEX_UNLOCK:
+      mutexUnlock(req);
+      break;
+   case MUTEX_RELEASE:
+      mutexRelease(req);
+      break;
+
+   case MCP_MESSAGE_COND_INIT:
+      condInit(req);
+      break;
+   case MCP_MESSAGE_COND_WAIT:
+      condWait(req);
+      break;
+   case MCP_MESSAGE_COND_SIGNAL:
+      condSignal(req);
+      break;
+   case MCP_MESSAGE_COND_BROADCAST:
+      condBroadcast(req);
+      break;
+
+   case MCP_MESSAGE_BARRIER_INIT:
+      barrierInit(req);
+      break;
+   case MCP_MESSAGE_BARRIER_WAIT:
+      barrierWait(req);
+      break;
+
+   default:
+      LOG_PRINT_ERROR("Unhandled sync request type: %i from %i", req.msg_type, req.core_id.tile_id);
+   }
+}
 
-   UInt64 time;
-   m_recv_buffer >> time;
+SInt32 SyncServer::Shard::getGlobalId(UInt32 local_id)
+{
+   return (SInt32) (local_id * m_server->m_shards.size() + m_index);
+}
 
-   assert((size_t)mux < m_mutexes.size());
-   assert((size_t)cond < m_conds.size());
+UInt32 SyncServer::Shard::getLocalId(SInt32 id, size_t num_objects)
+{
+   UInt32 num_shards = m_server->m_shards.size();
+   LOG_ASSERT_ERROR((id >= 0) && (((UInt32) id) % num_shards == m_index) && ((size_t) (id / num_shards) < num_objects),
+                    "id(%i) not in shard(%u), total objects in shard(%u)", id, m_index, (UInt32) num_objects);
+   return ((UInt32) id) / num_shards;
+}
 
-   SimCond *psimcond = &m_conds[cond];
+void SyncServer::Shard::acquireMutex(core_id_t core_id, carbon_mutex_t mux, UInt64 time)
+{
+   SimMutex *psimmux = &m_mutexes[getLocalId(mux, m_mutexes.size())];
 
-   StableIterator<SimMutex> it(m_mutexes, mux);
-   core_id_t new_mutex_owner = psimcond->wait(core_id, time, it);
+   if (psimmux->lock(core_id))
+   {
+      // notify the owner
+      m_server->sendReply(core_id, SyncClient::MUTEX_LOCK_RESPONSE, time);
+   }
+   else
+   {
+      // thread goes to sleep
+      m_server->stallThread(core_id);
+   }
+}
+
+void SyncServer::Shard::releaseMutex(core_id_t core_id, carbon_mutex_t mux, UInt64 time)
+{
+   SimMutex *psimmux = &m_mutexes[getLocalId(mux, m_mutexes.size())];
+
+   core_id_t new_owner = psimmux->unlock(core_id);
 
-   if (new_mutex_owner.tile_id != INVALID_TILE_ID)
+   if (new_owner.tile_id != INVALID_TILE_ID)
    {
       // wake up the new owner
-      Reply r;
-
-      r.dummy = SyncClient::MUTEX_LOCK_RESPONSE;
-      r.time = time;
-      m_network.netSend(new_mutex_owner, MCP_RESPONSE_TYPE, (char*)&r, sizeof(r));
+      m_server->resumeThread(new_owner);
+      m_server->sendReply(new_owner, SyncClient::MUTEX_LOCK_RESPONSE, time);
    }
 }
 
+void SyncServer::Shard::mutexInit(const Request &req)
+{
+   m_mutexes.push_back(SimMutex());
+   UInt32 mux = (UInt32) getGlobalId(m_mutexes.size()-1);
+
+   m_server->sendReply(req.core_id, mux);
+}
 
-void SyncServer::condSignal(core_id_t core_id)
+void SyncServer::Shard::mutexLock(const Request &req)
 {
-   carbon_cond_t cond;
-   m_recv_buffer >> cond;
+   acquireMutex(req.core_id, req.object, req.time);
+}
 
-   UInt64 time;
-   m_recv_buffer >> time;
+void SyncServer::Shard::mutexUnlock(const Request &req)
+{
+   releaseMutex(req.core_id, req.object, req.time);
 
-   assert((size_t)cond < m_conds.size());
+   m_server->sendReply(req.core_id, SyncClient::MUTEX_UNLOCK_RESPONSE);
+}
 
-   SimCond *psimcond = &m_conds[cond];
+void SyncServer::Shard::mutexRelease(const Request &req)
+{
+   releaseMutex(req.core_id, req.object, req.time);
+}
+
+// -- Condition Variable Stuffs -- //
+void SyncServer::Shard::condInit(const Request &req)
+{
+   m_conds.push_back(SimCond());
+   UInt32 cond = (UInt32) getGlobalId(m_conds.size()-1);
+
+   m_server->sendReply(req.core_id, cond);
+}
+
+void SyncServer::Shard::condWait(const Request &req)
+{
+   SimCond *psimcond = &m_conds[getLocalId(req.object, m_conds.size())];
 
-   core_id_t woken = psimcond->signal(core_id, time);
+   m_server->stallThread(req.core_id);
+   psimcond->wait(req.core_id, req.mutex, req.time);
 
-   if (woken.tile_id != INVALID_TILE_ID)
+   // Release the mutex, which may live in another shard
+   UInt32 mutex_shard = ((UInt32) req.mutex) % m_server->m_shards.size();
+   if (mutex_shard == m_index)
    {
-      // wake up the new owner
-      // (note: COND_WAIT_RESPONSE == MUTEX_LOCK_RESPONSE, see header)
-      Reply r;
-      r.dummy = SyncClient::MUTEX_LOCK_RESPONSE;
-      r.time = time;
-      m_network.netSend(woken, MCP_RESPONSE_TYPE, (char*)&r, sizeof(r));
+      releaseMutex(req.core_id, req.mutex, req.time);
    }
    else
    {
-      // nothing...
+      Request release_req = req;
+      release_req.msg_type = MUTEX_RELEASE;
+      release_req.object = req.mutex;
+      m_server->dispatch(release_req, mutex_shard);
    }
-
-   // Alert the signaler
-   UInt32 dummy = SyncClient::COND_SIGNAL_RESPONSE;
-   m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&dummy, sizeof(dummy));
 }
 
-void SyncServer::condBroadcast(core_id_t core_id)
+void SyncServer::Shard::condSignal(const Request &req)
 {
-   carbon_cond_t cond;
-   m_recv_buffer >> cond;
+   SimCond *psimcond = &m_conds[getLocalId(req.object, m_conds.size())];
 
-   UInt64 time;
-   m_recv_buffer >> time;
+   SimCond::CondWaiter woken(INVALID_CORE_ID, 0, 0);
+   if (psimcond->signal(req.core_id, req.time, woken))
+      wakeUpWaiter(woken, req.time);
 
-   assert((size_t)cond < m_conds.size());
+   // Alert the signaler
+   m_server->sendReply(req.core_id, SyncClient::COND_SIGNAL_RESPONSE);
+}
 
-   SimCond *psimcond = &m_conds[cond];
+void SyncServer::Shard::condBroadcast(const Request &req)
+{
+   SimCond *psimcond = &m_conds[getLocalId(req.object, m_conds.size())];
 
    SimCond::WakeupList woken_list;
-   psimcond->broadcast(core_id, time, woken_list);
+   psimcond->broadcast(req.core_id, req.time, woken_list);
 
    for (SimCond::WakeupList::iterator it = woken_list.begin(); it != woken_list.end(); it++)
    {
-      assert((*it).tile_id != INVALID_TILE_ID);
-
-      // wake up the new owner
-      // (note: COND_WAIT_RESPONSE == MUTEX_LOCK_RESPONSE, see header)
-      Reply r;
-      r.dummy = SyncClient::MUTEX_LOCK_RESPONSE;
-      r.time = time;
-      m_network.netSend((*it), MCP_RESPONSE_TYPE, (char*)&r, sizeof(r));
+      assert(it->m_core_id.tile_id != INVALID_TILE_ID);
+      wakeUpWaiter(*it, req.time);
    }
 
    // Alert the signaler
-   UInt32 dummy = SyncClient::COND_BROADCAST_RESPONSE;
-   m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&dummy, sizeof(dummy));
+   m_server->sendReply(req.core_id, SyncClient::COND_BROADCAST_RESPONSE);
 }
 
-void SyncServer::barrierInit(core_id_t core_id)
+void SyncServer::Shard::wakeUpWaiter(const SimCond::CondWaiter &waiter, UInt64 time)
 {
-   UInt32 count;
-   m_recv_buffer >> count;
-
-   m_barriers.push_back(SimBarrier(count));
-   UInt32 barrier = (UInt32)m_barriers.size()-1;
+   m_server->resumeThread(waiter.m_core_id);
 
-   m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&barrier, sizeof(barrier));
+   // The woken up thread has to grab its mutex again. It gets a
+   // MUTEX_LOCK_RESPONSE once it does.
+   // (note: COND_WAIT_RESPONSE == MUTEX_LOCK_RESPONSE, see header)
+   UInt32 mutex_shard = ((UInt32) waiter.m_mutex) % m_server->m_shards.size();
+   if (mutex_shard == m_index)
+   {
+      acquireMutex(waiter.m_core_id, waiter.m_mutex, time);
+   }
+   else
+   {
+      Request lock_req;
+      lock_req.msg_type = MCP_MESSAGE_MUTEX_LOCK;
+      lock_req.core_id = waiter.m_core_id;
+      lock_req.object = waiter.m_mutex;
+      lock_req.mutex = 0;
+      lock_req.time = time;
+      m_server->dispatch(lock_req, mutex_shard);
+   }
 }
 
-void SyncServer::barrierWait(core_id_t core_id)
+void SyncServer::Shard::barrierInit(const Request &req)
 {
-   carbon_barrier_t barrier;
-   m_recv_buffer >> barrier;
+   m_barriers.push_back(SimBarrier((UInt32) req.object));
+   UInt32 barrier = (UInt32) getGlobalId(m_barriers.size()-1);
 
-   UInt64 time;
-   m_recv_buffer >> time;
+   m_server->sendReply(req.core_id, barrier);
+}
 
-   LOG_ASSERT_ERROR(barrier < (carbon_barrier_t) m_barriers.size(), "barrier = %i, m_barriers.size()= %u", barrier, m_barriers.size());
+void SyncServer::Shard::barrierWait(const Request &req)
+{
+   SimBarrier *psimbarrier = &m_barriers[getLocalId(req.object, m_barriers.size())];
 
-   SimBarrier *psimbarrier = &m_barriers[barrier];
+   m_server->stallThread(req.core_id);
 
    SimBarrier::WakeupList woken_list;
-   psimbarrier->wait(core_id, time, woken_list);
+   psimbarrier->wait(req.core_id, req.time, woken_list);
+
+   if (woken_list.empty())
+      return;
+
+   // Resuming all the threads stalled at the barrier
+   m_server->resumeThreads(woken_list);
 
    UInt64 max_time = psimbarrier->getMaxTime();
 
    for (SimBarrier::WakeupList::iterator it = woken_list.begin(); it != woken_list.end(); it++)
    {
       assert((*it).tile_id != INVALID_TILE_ID);
-      Reply r;
-      r.dummy = SyncClient::BARRIER_WAIT_RESPONSE;
-      r.time = max_time;
-      core_id_t core_id = (*it);
-      m_network.netSend(core_id, MCP_RESPONSE_TYPE, (char*)&r, sizeof(r));
+      m_server->sendReply(*it, SyncClient::BARRIER_WAIT_RESPONSE, max_time);
    }
 }
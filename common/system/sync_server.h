@@ -10,7 +10,13 @@
 #include "transport.h"
 #include "network.h"
 #include "packetize.h"
-#include "stable_iterator.h"
+#include "thread.h"
+#include "lock.h"
+#include "cond.h"
+
+// The synchronization objects only keep track of who owns and who waits
+// on them. Stalling and resuming the threads in the ThreadManager is left
+// to the SyncServer.
 
 class SimMutex
 {
@@ -38,27 +44,29 @@ class SimCond
 {
 
    public:
-      typedef std::vector<core_id_t> WakeupList;
-
-      SimCond();
-      ~SimCond();
-
-      // returns the thread that gets woken up when the mux is unlocked
-      core_id_t wait(core_id_t core_id, UInt64 time, StableIterator<SimMutex> & it);
-      core_id_t signal(core_id_t core_id, UInt64 time);
-      void broadcast(core_id_t core_id, UInt64 time, WakeupList &woken);
-
-   private:
       class CondWaiter
       {
          public:
-            CondWaiter(core_id_t core_id, StableIterator<SimMutex> mutex, UInt64 time)
+            CondWaiter(core_id_t core_id, carbon_mutex_t mutex, UInt64 time)
                   : m_core_id(core_id), m_mutex(mutex), m_arrival_time(time) {}
             core_id_t m_core_id;
-            StableIterator<SimMutex> m_mutex;
+            carbon_mutex_t m_mutex;
             UInt64 m_arrival_time;
       };
 
+      typedef std::vector<CondWaiter> WakeupList;
+
+      SimCond();
+      ~SimCond();
+
+      // the caller has to release the mutex on behalf of the waiter
+      void wait(core_id_t core_id, carbon_mutex_t mutex, UInt64 time);
+      // returns false if there was nobody to wake up. The woken up threads
+      // still have to acquire their mutex.
+      bool signal(core_id_t core_id, UInt64 time, CondWaiter &woken);
+      void broadcast(core_id_t core_id, UInt64 time, WakeupList &woken);
+
+   private:
       typedef std::vector< CondWaiter > ThreadQueue;
       ThreadQueue m_waiting;
 };
@@ -83,39 +91,133 @@ class SimBarrier
       UInt64 m_max_time;
 };
 
+// Serves the MCP_MESSAGE_{MUTEX,COND,BARRIER}_* requests.
+//
+// The objects are spread over sync_server/num_shards shards, and an object
+// with ID 'id' lives in shard (id % num_shards). With a single shard, the
+// requests are handled on the MCP thread as they come in. Otherwise, every
+// shard has a thread of its own and the MCP only unpacks the requests and
+// queues them up at the shard that owns the object.
+//
+// A condition variable and its mutex may live in different shards. The
+// shard of the condition variable then asks the shard of the mutex to
+// release it (on wait) or to acquire it (on signal/broadcast) on behalf of
+// the waiter.
+
 class SyncServer
 {
-      typedef std::vector<SimMutex> MutexVector;
-      typedef std::vector<SimCond> CondVector;
-      typedef std::vector<SimBarrier> BarrierVector;
-
-      MutexVector m_mutexes;
-      CondVector m_conds;
-      BarrierVector m_barriers;
-
-      // FIXME: This should be better organized -- too much redundant crap
-
    public:
-      SyncServer(Network &network, UnstructuredBuffer &recv_buffer);
+      // 'thread_state_lock' is held by the MCP whenever it touches the
+      // ThreadManager's view of the threads; the shards take it to stall
+      // and resume threads.
+      SyncServer(Network &network, UnstructuredBuffer &recv_buffer, Lock &thread_state_lock);
       ~SyncServer();
 
-      // Remaining parameters to these functions are stored
-      // in the recv buffer and get unpacked
-      void mutexInit(core_id_t core_id);
-      void mutexLock(core_id_t core_id);
-      void mutexUnlock(core_id_t core_id);
+      // Unpacks the remaining parameters of the request from the recv
+      // buffer, and handles it or hands it to its shard
+      void processRequest(SInt32 msg_type, core_id_t core_id);
+
+      // Waits until all requests from 'tile_id' have been handled, so that
+      // the MCP sees the requests of one tile in the order they were sent
+      void waitForPendingRequests(tile_id_t tile_id);
 
-      void condInit(core_id_t core_id);
-      void condWait(core_id_t core_id);
-      void condSignal(core_id_t core_id);
-      void condBroadcast(core_id_t core_id);
+      void finish();
 
-      void barrierInit(core_id_t);
-      void barrierWait(core_id_t);
+      UInt32 getNumShards() { return m_shards.size(); }
 
    private:
+      // Requests the shards send to each other, on top of the MCP_MESSAGE_* ones
+      enum InternalMessageType
+      {
+         MUTEX_RELEASE = -1,    // Release a mutex for a thread that waits on a condition variable
+         SHARD_QUIT = -2
+      };
+
+      struct Request
+      {
+         SInt32 msg_type;
+         core_id_t core_id;
+         SInt32 object;         // mutex, cond or barrier (or barrier count for BARRIER_INIT)
+         carbon_mutex_t mutex;  // COND_WAIT only
+         UInt64 time;
+      };
+
+      class Shard : public Runnable
+      {
+         public:
+            Shard(SyncServer *server, UInt32 index);
+            ~Shard();
+
+            void handleRequest(const Request &req);
+
+            void start();
+            void enqueue(const Request &req);
+            void run();
+            void finish();
+
+         private:
+            typedef std::vector<SimMutex> MutexVector;
+            typedef std::vector<SimCond> CondVector;
+            typedef std::vector<SimBarrier> BarrierVector;
+
+            SyncServer *m_server;
+            UInt32 m_index;
+
+            MutexVector m_mutexes;
+            CondVector m_conds;
+            BarrierVector m_barriers;
+
+            Thread *m_thread;
+            std::queue<Request> m_queue;
+            Lock m_queue_lock;
+            ConditionVariable m_queue_cond;
+            volatile bool m_finished;
+
+            SInt32 getGlobalId(UInt32 local_id);
+            UInt32 getLocalId(SInt32 id, size_t num_objects);
+
+            void mutexInit(const Request &req);
+            void mutexLock(const Request &req);
+            void mutexUnlock(const Request &req);
+            void mutexRelease(const Request &req);
+
+            void condInit(const Request &req);
+            void condWait(const Request &req);
+            void condSignal(const Request &req);
+            void condBroadcast(const Request &req);
+
+            void barrierInit(const Request &req);
+            void barrierWait(const Request &req);
+
+            // Grants the mutex to the thread if it is free, and queues the
+            // thread up on it otherwise
+            void acquireMutex(core_id_t core_id, carbon_mutex_t mux, UInt64 time);
+            // Hands the mutex to the next thread waiting on it
+            void releaseMutex(core_id_t core_id, carbon_mutex_t mux, UInt64 time);
+            void wakeUpWaiter(const SimCond::CondWaiter &waiter, UInt64 time);
+      };
+
       Network &m_network;
       UnstructuredBuffer &m_recv_buffer;
+      Lock &m_thread_state_lock;
+
+      std::vector<Shard*> m_shards;
+      bool m_threaded;
+      UInt32 m_next_init_shard;
+
+      // Requests per tile that were queued up but not handled yet. The
+      // shards signal m_pending_cond when a tile has none left.
+      volatile SInt32 *m_num_pending_requests;
+      Lock m_pending_lock;
+      ConditionVariable m_pending_cond;
+
+      void dispatch(const Request &req, UInt32 shard_index);
+
+      void stallThread(core_id_t core_id);
+      void resumeThread(core_id_t core_id);
+      void resumeThreads(const std::vector<core_id_t> &core_ids);
+      void sendReply(core_id_t core_id, UInt32 response, UInt64 time);
+      void sendReply(core_id_t core_id, UInt32 response);
 };
 
 #endif // SYNC_SERVER_H
@@ -423,7 +423,7 @@ void SyscallServer::marshallStatCall(IntPtr syscall_number, core_id_t core_id)
 
 void SyscallServer::marshallFstatCall(core_id_t core_id)
 {
-   int fd;
+   int fd = 0;
    struct stat buf;
 
    assert(m_recv_buff.size() == (sizeof(int) + sizeof(struct stat)));
@@ -446,8 +446,8 @@ void SyscallServer::marshallFstatCall(core_id_t core_id)
 
 void SyscallServer::marshallIoctlCall(core_id_t core_id)
 {
-   int fd;
-   int request;
+   int fd = 0;
+   int request = 0;
    struct termios buf;
 
    // unpack the data
@@ -506,12 +506,12 @@ void SyscallServer::marshallPipeCall(core_id_t core_id)
 
 void SyscallServer::marshallMmapCall(core_id_t core_id)
 {
-   void *addr;
-   size_t length;
-   int prot;
-   int flags;
-   int fd;
-   off_t pgoffset;
+   void *addr = NULL;
+   size_t length = 0;
+   int prot = 0;
+   int flags = 0;
+   int fd = 0;
+   off_t pgoffset = 0;
 
    m_recv_buff.get(addr);
    m_recv_buff.get(length);
@@ -530,8 +530,8 @@ void SyscallServer::marshallMmapCall(core_id_t core_id)
 
 void SyscallServer::marshallMunmapCall (core_id_t core_id)
 {
-   void *addr;
-   size_t length;
+   void *addr = NULL;
+   size_t length = 0;
 
    m_recv_buff.get(addr);
    m_recv_buff.get(length);
@@ -546,7 +546,7 @@ void SyscallServer::marshallMunmapCall (core_id_t core_id)
 
 void SyscallServer::marshallBrkCall (core_id_t core_id)
 {
-   void *end_data_segment;
+   void *end_data_segment = NULL;
 
    m_recv_buff.get(end_data_segment);
 
@@ -760,14 +760,14 @@ void SyscallServer::marshallSchedGetAffinityCall(core_id_t core_id)
 
 void SyscallServer::marshallFutexCall(core_id_t core_id)
 {
-   int *addr1;
-   int op;
-   int val1;
-   void *timeout;
-   int *addr2;
-   int val3;
-
-   UInt64 curr_time;
+   int *addr1 = NULL;
+   int op = 0;
+   int val1 = 0;
+   void *timeout = NULL;
+   int *addr2 = NULL;
+   int val3 = 0;
+
+   UInt64 curr_time = 0;
 
    m_recv_buff.get(addr1);
    m_recv_buff.get(op);
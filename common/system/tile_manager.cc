@@ -26,6 +26,7 @@ TileManager::TileManager()
    , m_thread_index_tls(TLS::create())
    , m_thread_type_tls(TLS::create())
    , m_num_registered_sim_threads(0)
+   , m_migration_callback(NULL)
 {
    LOG_PRINT("Starting TileManager Constructor.");
 
@@ -183,6 +184,9 @@ void TileManager::updateTLS(UInt32 tile_index, SInt32 thread_index, thread_id_t
 
     LOG_ASSERT_ERROR(m_tile_tls->get() == (void*)(m_tiles.at(tile_index)),
                      "TLS appears to be broken. %p != %p", m_tile_tls->get(), (void*)(m_tiles.at(tile_index)));
+
+    if (m_migration_callback)
+       m_migration_callback(getCurrentCore());
 }
 
 void TileManager::terminateThread()
@@ -40,6 +40,11 @@ public:
 
    void updateTLS(UInt32 tile_index, SInt32 thread_index, thread_id_t thread_id);
 
+   // Called by a thread that has just migrated, with its new core, so that
+   // the frontend can update the core it has cached for the thread
+   typedef void (*MigrationCallback)(Core* core);
+   void setMigrationCallback(MigrationCallback callback) { m_migration_callback = callback; }
+
    void outputSummary(std::ostream &os);
 
    UInt32 getTileIndexFromID(tile_id_t tile_id);
@@ -77,6 +82,8 @@ private:
 
    std::vector<Tile*> m_tiles;
    UInt32 m_max_threads_per_core;
+
+   MigrationCallback m_migration_callback;
 };
 
 #endif
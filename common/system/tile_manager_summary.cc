@@ -41,11 +41,11 @@ static void gatherSummaries(vector<string> &summaries)
 
          buf = global_node->recv();
          assert(*((tile_id_t*)buf) == tl[t]);
-         delete [] buf;
+         global_node->releaseBuffer(buf);
 
          buf = global_node->recv();
          summaries[tl[t]] = string((char*)buf);
-         delete [] buf;
+         global_node->releaseBuffer(buf);
       }
    }
 
@@ -214,7 +214,7 @@ void TileManager::outputSummary(ostream &os)
    {
       Byte *buf = global_node->recv();
       assert(*((UInt32*)buf) == cfg->getCurrentProcessNum());
-      delete [] buf;
+      global_node->releaseBuffer(buf);
    }
 
    // send each summary
@@ -2,10 +2,60 @@
 #define BASIC_BLOCK_H
 
 #include <vector>
+#include <utility>
 
-class Instruction;
+#include "fixed_types.h"
+#include "instruction.h"
 
+// Run of consecutive instructions of a basic block that do not need any
+// dynamic information (no memory operands, no branch), so that the core
+// model can handle them in one go. The number of instructions of each type
+// is counted when the run is built, so the execution cost of the run is a
+// handful of multiplications.
 class BasicBlock : public std::vector<Instruction*>
-{};
+{
+public:
+   typedef std::vector<std::pair<InstructionType, UInt32> > InstructionTypeCounts;
+
+   BasicBlock()
+      : _num_lfence_instructions(0)
+      , _num_sfence_instructions(0)
+      , _num_mfence_instructions(0)
+   {}
+
+   void addInstruction(Instruction* instruction)
+   {
+      push_back(instruction);
+
+      InstructionType type = instruction->getType();
+      InstructionTypeCounts::iterator it = _instruction_type_counts.begin();
+      while ((it != _instruction_type_counts.end()) && ((*it).first != type))
+         it ++;
+      if (it == _instruction_type_counts.end())
+         _instruction_type_counts.push_back(std::make_pair(type, 1));
+      else
+         (*it).second ++;
+
+      if (type == INST_LFENCE)
+         _num_lfence_instructions ++;
+      else if (type == INST_SFENCE)
+         _num_sfence_instructions ++;
+      else if (type == INST_MFENCE)
+         _num_mfence_instructions ++;
+   }
+
+   const InstructionTypeCounts& getInstructionTypeCounts() const
+   { return _instruction_type_counts; }
+
+   UInt32 getNumLFenceInstructions() const   { return _num_lfence_instructions; }
+   UInt32 getNumSFenceInstructions() const   { return _num_sfence_instructions; }
+   UInt32 getNumMFenceInstructions() const   { return _num_mfence_instructions; }
+
+private:
+   InstructionTypeCounts _instruction_type_counts;
+   UInt32 _num_lfence_instructions;
+   UInt32 _num_sfence_instructions;
+   UInt32 _num_mfence_instructions;
+};
 
 #endif
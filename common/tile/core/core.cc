@@ -12,6 +12,8 @@
 #include "clock_skew_management_object.h"
 #include "config.h"
 #include "log.h"
+#include "event_tracer.h"
+#include "instruction_trace.h"
 #include "dvfs_manager.h"
 
 Core::Core(Tile *tile, core_type_t core_type)
@@ -47,8 +49,7 @@ Core::Core(Tile *tile, core_type_t core_type)
    _asynchronous_map[L1_ICACHE] = Time(0);
    _asynchronous_map[L1_DCACHE] = Time(0);
 
-if (getId().tile_id!=0)
-	   MY_LOG_PRINT("Initialized Core.");
+   TRACE_EVENT(CORE_INITIALIZED, _id.tile_id, 0, 0, 0, 0);
 }
 
 Core::~Core()
@@ -131,8 +132,7 @@ Core::accessMemory(lock_signal_t lock_signal, mem_op_t mem_op_type, IntPtr addre
 Time
 Core::readInstructionMemory(IntPtr address, UInt32 instruction_size)
 {
-if (getId().tile_id!=0)
-   MY_LOG_PRINT("Instruction: Address(%#lx), Size(%u), Start READ", address, instruction_size);
+   TRACE_EVENT(CORE_INSTRUCTION_READ, _id.tile_id, 0, address, instruction_size, 0);
 
    Byte buf[instruction_size];
    return initiateMemoryAccess(MemComponent::L1_ICACHE, Core::NONE, Core::READ, address, buf, instruction_size).second;
@@ -145,6 +145,10 @@ Core::initiateMemoryAccess(MemComponent::Type mem_component, lock_signal_t lock_
 {
    LOG_ASSERT_ERROR(Config::getSingleton()->isSimulatingSharedMemory(), "Shared Memory Disabled");
 
+   // The accesses whose information goes to the core model are replayed by tools/trace_replay
+   if (push_info && _core_model && _core_model->isEnabled() && _core_model->getInstructionTraceWriter())
+      _core_model->getInstructionTraceWriter()->recordMemoryAccess(lock_signal, mem_op_type, address, data_size);
+
    if (data_size == 0)
    {
       if (push_info)
@@ -160,9 +164,7 @@ Core::initiateMemoryAccess(MemComponent::Type mem_component, lock_signal_t lock_
    Time initial_time = (time.getTime() == 0) ? _core_model->getCurrTime() : Time(time);
    Time curr_time = initial_time;
 
-if (getId().tile_id!=0)
-   MY_LOG_PRINT("Time(%llu), %s - ADDR(%#lx), data_size(%u), START",
-             initial_time.toNanosec(), ((mem_op_type == READ) ? "READ" : "WRITE"), address, data_size);
+   TRACE_EVENT(CORE_MEMORY_ACCESS_START, _id.tile_id, initial_time.toNanosec(), mem_op_type, address, data_size);
 
    UInt32 num_misses = 0;
    UInt32 cache_line_size = _tile->getMemoryManager()->getCacheLineSize();
@@ -251,9 +253,7 @@ if (getId().tile_id!=0)
    Time final_time = curr_time;
    LOG_ASSERT_ERROR(final_time >= initial_time, "final_time(%llu) < initial_time(%llu)", final_time.getTime(), initial_time.getTime());
    
-if (getId().tile_id!=0)
-   MY_LOG_PRINT("Time(%llu), %s - ADDR(%#lx), data_size(%u), END", 
-             final_time.toNanosec(), ((mem_op_type == READ) ? "READ" : "WRITE"), address, data_size);
+   TRACE_EVENT(CORE_MEMORY_ACCESS_END, _id.tile_id, final_time.toNanosec(), mem_op_type, address, data_size);
 
    // Calculate the round-trip time
    Time memory_access_time = final_time - initial_time;
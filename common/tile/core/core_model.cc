@@ -11,6 +11,7 @@
 #include "time_types.h"
 #include "mcpat_core_interface.h"
 #include "remote_query_helper.h"
+#include "instruction_trace.h"
 
 CoreModel* CoreModel::create(Core* core)
 {
@@ -41,6 +42,7 @@ CoreModel::CoreModel(Core *core)
    , _dynamic_memory_info_queue(3) // Max 3 dynamic memory info objects
    , _dynamic_branch_info_queue(1) // Max 1 dynamic branch info object
    , _enabled(false)
+   , _instruction_trace_writer(NULL)
 {
    // Create Branch Predictor
    _bp = BranchPredictor::create();
@@ -52,12 +54,25 @@ CoreModel::CoreModel(Core *core)
 
    // Initialize instruction costs
    initializeInstructionCosts(_core->getFrequency());
+
+   // Record the instructions of the application tiles, to replay them with tools/trace_replay
+   tile_id_t tile_id = _core->getTile()->getId();
+   if (Sim()->getCfg()->getBool("instruction_trace/record", false) &&
+       tile_id < (tile_id_t) Config::getSingleton()->getApplicationTiles())
+   {
+      ostringstream filename;
+      filename << "instruction_trace." << tile_id << ".bin";
+      _instruction_trace_writer = new InstructionTraceWriter(tile_id,
+            Sim()->getConfig()->formatOutputFileName(filename.str()),
+            Sim()->getCfg()->getInt("instruction_trace/buffer_size", 1 << 20));
+   }
    
    LOG_PRINT("Initialized CoreModel.");
 }
 
 CoreModel::~CoreModel()
 {
+   delete _instruction_trace_writer;
    delete _mcpat_core_interface;
    delete _bp; _bp = 0;
 }
@@ -87,6 +102,15 @@ const Time& CoreModel::getCost(InstructionType type) const
    return _instruction_costs[type];
 }
 
+Time CoreModel::getCost(const BasicBlock* basic_block) const
+{
+   UInt64 cost = 0;
+   const BasicBlock::InstructionTypeCounts& counts = basic_block->getInstructionTypeCounts();
+   for (BasicBlock::InstructionTypeCounts::const_iterator it = counts.begin(); it != counts.end(); it++)
+      cost += _instruction_costs[(*it).first].getTime() * (*it).second;
+   return Time(cost);
+}
+
 void CoreModel::outputSummary(ostream& os, const Time& target_completion_time)
 {
    os << "Core Summary:" << endl;
@@ -240,6 +264,13 @@ void CoreModel::updateMemoryFenceCounters(const Instruction* instruction)
    }
 }
 
+void CoreModel::updateMemoryFenceCounters(const BasicBlock* basic_block)
+{
+   _total_lfence_instructions += basic_block->getNumLFenceInstructions();
+   _total_sfence_instructions += basic_block->getNumSFenceInstructions();
+   _total_explicit_mfence_instructions += basic_block->getNumMFenceInstructions();
+}
+
 void CoreModel::updateDynamicInstructionCounters(const Instruction* instruction, const Time& cost)
 {
    switch (instruction->getType())
@@ -283,6 +314,8 @@ void CoreModel::queueInstruction(Instruction* instruction)
 {
    if (!_enabled)
       return;
+   if (_instruction_trace_writer)
+      _instruction_trace_writer->recordInstruction(instruction);
    assert(!_instruction_queue.full());
    _instruction_queue.push_back(instruction);
 }
@@ -297,6 +330,36 @@ void CoreModel::iterate()
    }
 }
 
+void CoreModel::processBasicBlock(BasicBlock* basic_block)
+{
+   if (!_enabled)
+      return;
+
+   // Replayed one instruction at a time
+   if (_instruction_trace_writer)
+   {
+      for (BasicBlock::iterator it = basic_block->begin(); it != basic_block->end(); it++)
+         _instruction_trace_writer->recordInstruction(*it);
+   }
+
+   // The queued instructions have all executed before the basic block, so
+   // their dynamic information is complete
+   while (!_instruction_queue.empty())
+   {
+      Instruction* instruction = _instruction_queue.front();
+      handleInstruction(instruction);
+      _instruction_queue.pop_front();
+   }
+
+   handleBasicBlock(basic_block);
+}
+
+void CoreModel::handleBasicBlock(BasicBlock* basic_block)
+{
+   for (BasicBlock::iterator it = basic_block->begin(); it != basic_block->end(); it++)
+      handleInstruction(*it);
+}
+
 void CoreModel::pushDynamicMemoryInfo(const DynamicMemoryInfo& info)
 {
    if (!_enabled)
@@ -321,6 +384,8 @@ void CoreModel::pushDynamicBranchInfo(const DynamicBranchInfo& info)
 {
    if (!_enabled)
       return;
+   if (_instruction_trace_writer)
+      _instruction_trace_writer->recordBranch(info._taken, info._target);
    assert(!_dynamic_branch_info_queue.full());
    _dynamic_branch_info_queue.push_back(info);
 }
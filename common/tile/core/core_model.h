@@ -10,6 +10,7 @@ using std::vector;
 class Core;
 class BranchPredictor;
 class McPATCoreInterface;
+class InstructionTraceWriter;
 
 #include "instruction.h"
 #include "basic_block.h"
@@ -25,6 +26,7 @@ public:
    void processDynamicInstruction(DynamicInstruction* i);
    void queueInstruction(Instruction* instruction);
    void iterate();
+   void processBasicBlock(BasicBlock* basic_block);
 
    void setDVFS(double old_frequency, double new_voltage, double new_frequency, const Time& curr_time);
    void recomputeAverageFrequency(double frequency); 
@@ -57,9 +59,13 @@ public:
    class AbortInstructionException {};
 
    const Time& getCost(InstructionType type) const;
+   Time getCost(const BasicBlock* basic_block) const;
 
    Core* getCore() { return _core; };
 
+   // NULL unless instruction_trace/record is set
+   InstructionTraceWriter* getInstructionTraceWriter() { return _instruction_trace_writer; }
+
 protected:
    enum RegType
    {
@@ -88,6 +94,7 @@ protected:
    
    Time modelICache(const Instruction* instruction);
    void updateMemoryFenceCounters(const Instruction* instruction);
+   void updateMemoryFenceCounters(const BasicBlock* basic_block);
    void updateDynamicInstructionCounters(const Instruction* instruction, const Time& cost);
    void updatePipelineStallCounters(const Time& memory_stall_time, const Time& execution_unit_stall_time);
 
@@ -131,9 +138,13 @@ private:
 
    // Power/Area modeling
    McPATCoreInterface* _mcpat_core_interface;
+
+   InstructionTraceWriter* _instruction_trace_writer;
    
    // Main instruction handling function
    virtual void handleInstruction(Instruction *instruction) = 0;
+   // Handles the instructions one by one, unless the model has a faster way
+   virtual void handleBasicBlock(BasicBlock *basic_block);
 
    // Instruction costs
    void initializeInstructionCosts(double frequency);
@@ -0,0 +1,462 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+
+#include "instruction_trace.h"
+#include "log.h"
+
+using namespace std;
+
+// InstructionTraceWriter
+
+InstructionTraceWriter::InstructionTraceWriter(tile_id_t tile_id, string filename, UInt32 buffer_size)
+   : _tile_id(tile_id)
+   , _filename(filename)
+   , _file(NULL)
+   , _buffer_size(buffer_size)
+   , _buffer_pos(0)
+   , _run_length(0)
+   , _last_instruction_id((UInt32) -1)
+   , _last_instruction_address(0)
+   , _last_memory_address(0)
+{
+   LOG_ASSERT_ERROR(buffer_size >= 1024, "instruction_trace/buffer_size(%u) must be at least 1024", buffer_size);
+   _buffer = new Byte[buffer_size];
+   memset(_id_cache, 0, sizeof(_id_cache));
+}
+
+InstructionTraceWriter::~InstructionTraceWriter()
+{
+   // Nothing was recorded on this tile
+   if (!_file && _buffer_pos == 0 && _run_length == 0)
+   {
+      delete [] _buffer;
+      return;
+   }
+
+   flushRun();
+   reserve(1);
+   putTag(ITRACE_END, 0);
+   writeBuffer();
+   fclose(_file);
+
+   delete [] _buffer;
+}
+
+void
+InstructionTraceWriter::recordInstruction(const Instruction* instruction)
+{
+   UInt32 id = getInstructionId(instruction);
+   UInt32 next_id = _last_instruction_id + 1;
+
+   if (id == next_id)
+   {
+      if (++ _run_length == MAX_RUN_LENGTH)
+         flushRun();
+   }
+   else
+   {
+      flushRun();
+      reserve(MAX_EVENT_SIZE);
+      putTag(ITRACE_INSTRUCTION, 0);
+      putSignedVarint((SInt64) id - (SInt64) next_id);
+   }
+
+   _last_instruction_id = id;
+   _last_instruction_address = instruction->getAddress();
+}
+
+void
+InstructionTraceWriter::recordMemoryAccess(Core::lock_signal_t lock_signal, Core::mem_op_t mem_op_type,
+                                           IntPtr address, UInt32 size)
+{
+   flushRun();
+   reserve(MAX_EVENT_SIZE);
+   putTag(ITRACE_MEMORY_ACCESS, mem_op_type | (lock_signal << 2));
+   putVarint(size);
+   putSignedVarint((SInt64) (address - _last_memory_address));
+
+   _last_memory_address = address;
+}
+
+void
+InstructionTraceWriter::recordBranch(bool taken, IntPtr target)
+{
+   flushRun();
+   reserve(MAX_EVENT_SIZE);
+   putTag(ITRACE_BRANCH, taken ? 1 : 0);
+   putSignedVarint((SInt64) (target - _last_instruction_address));
+}
+
+UInt32
+InstructionTraceWriter::getInstructionId(const Instruction* instruction)
+{
+   IdCacheEntry& entry = _id_cache[((IntPtr) instruction >> 4) & (ID_CACHE_SIZE - 1)];
+   if (entry._instruction == instruction)
+      return entry._id;
+
+   map<const Instruction*, UInt32>::iterator it = _instruction_ids.find(instruction);
+   UInt32 id;
+   if (it != _instruction_ids.end())
+   {
+      id = it->second;
+   }
+   else
+   {
+      // Defining an instruction does not change the position in the stream,
+      // so the pending run does not need to be written out first
+      id = _instruction_ids.size();
+      _instruction_ids.insert(make_pair(instruction, id));
+      defineInstruction(instruction);
+   }
+
+   entry._instruction = instruction;
+   entry._id = id;
+   return id;
+}
+
+void
+InstructionTraceWriter::defineInstruction(const Instruction* instruction)
+{
+   const RegisterOperandList& read_registers = instruction->getReadRegisterOperands();
+   const RegisterOperandList& write_registers = instruction->getWriteRegisterOperands();
+   const ImmediateOperandList& immediates = instruction->getImmediateOperands();
+   const McPATInstruction* mcpat_instruction = instruction->getMcPATInstruction();
+
+   UInt32 num_values = 16 + read_registers.size() + write_registers.size() + immediates.size();
+   if (mcpat_instruction)
+      num_values += mcpat_instruction->getMicroOpList().size() + mcpat_instruction->getExecutionUnitList().size();
+   reserve(1 + 10 * num_values);
+
+   putTag(ITRACE_DEFINE_INSTRUCTION, 0);
+   putVarint(instruction->getType());
+   putVarint(instruction->getOpcode());
+   putVarint(instruction->getAddress());
+   putVarint(instruction->getSize());
+   putVarint(instruction->isAtomic());
+
+   putVarint(read_registers.size());
+   for (UInt32 i = 0; i < read_registers.size(); i++)
+      putVarint(read_registers[i]);
+   putVarint(write_registers.size());
+   for (UInt32 i = 0; i < write_registers.size(); i++)
+      putVarint(write_registers[i]);
+   putVarint(instruction->getNumReadMemoryOperands());
+   putVarint(instruction->getNumWriteMemoryOperands());
+   putVarint(immediates.size());
+   for (UInt32 i = 0; i < immediates.size(); i++)
+      putVarint(immediates[i]);
+
+   putVarint(mcpat_instruction != NULL);
+   if (mcpat_instruction)
+   {
+      const McPATInstruction::MicroOpList& micro_ops = mcpat_instruction->getMicroOpList();
+      const McPATInstruction::RegisterFile& register_file = mcpat_instruction->getRegisterFile();
+      const McPATInstruction::ExecutionUnitList& execution_units = mcpat_instruction->getExecutionUnitList();
+
+      putVarint(micro_ops.size());
+      for (UInt32 i = 0; i < micro_ops.size(); i++)
+         putVarint(micro_ops[i]);
+      putVarint(register_file._num_integer_reads);
+      putVarint(register_file._num_integer_writes);
+      putVarint(register_file._num_floating_point_reads);
+      putVarint(register_file._num_floating_point_writes);
+      putVarint(execution_units.size());
+      for (UInt32 i = 0; i < execution_units.size(); i++)
+         putVarint(execution_units[i]);
+   }
+}
+
+void
+InstructionTraceWriter::flushRun()
+{
+   if (_run_length == 0)
+      return;
+
+   reserve(1);
+   putTag(ITRACE_NEXT_INSTRUCTIONS, _run_length - 1);
+   _run_length = 0;
+}
+
+void
+InstructionTraceWriter::flush()
+{
+   flushRun();
+   writeBuffer();
+}
+
+void
+InstructionTraceWriter::writeBuffer()
+{
+   if (!_file)
+   {
+      _file = fopen(_filename.c_str(), "w");
+      LOG_ASSERT_ERROR(_file, "Could not open %s", _filename.c_str());
+
+      InstructionTraceHeader header;
+      header.magic = InstructionTraceHeader::MAGIC;
+      header.version = InstructionTraceHeader::VERSION;
+      header.tile_id = _tile_id;
+      header.padding = 0;
+      fwrite(&header, sizeof(header), 1, _file);
+   }
+
+   fwrite(_buffer, 1, _buffer_pos, _file);
+   fflush(_file);
+   _buffer_pos = 0;
+}
+
+void
+InstructionTraceWriter::reserve(UInt32 size)
+{
+   LOG_ASSERT_ERROR(size <= _buffer_size, "Event(%u bytes) larger than instruction_trace/buffer_size(%u)",
+                    size, _buffer_size);
+   if (_buffer_pos + size > _buffer_size)
+      writeBuffer();
+}
+
+void
+InstructionTraceWriter::putTag(InstructionTraceTag tag, UInt32 payload)
+{
+   _buffer[_buffer_pos ++] = (Byte) (tag | (payload << 3));
+}
+
+void
+InstructionTraceWriter::putVarint(UInt64 value)
+{
+   while (value >= 0x80)
+   {
+      _buffer[_buffer_pos ++] = (Byte) (value | 0x80);
+      value >>= 7;
+   }
+   _buffer[_buffer_pos ++] = (Byte) value;
+}
+
+void
+InstructionTraceWriter::putSignedVarint(SInt64 value)
+{
+   putVarint(((UInt64) value << 1) ^ (UInt64) (value >> 63));
+}
+
+// InstructionTraceReader
+
+InstructionTraceReader::InstructionTraceReader(string filename)
+   : _filename(filename)
+   , _truncated(false)
+   , _ended(false)
+   , _run_length(0)
+   , _last_instruction_id((UInt32) -1)
+   , _last_instruction_address(0)
+   , _last_memory_address(0)
+{
+   int fd = open(filename.c_str(), O_RDONLY);
+   LOG_ASSERT_ERROR(fd >= 0, "Could not open %s", filename.c_str());
+
+   struct stat file_stat;
+   __attribute__((unused)) int ret = fstat(fd, &file_stat);
+   LOG_ASSERT_ERROR(ret == 0, "Could not stat %s", filename.c_str());
+   _data_size = file_stat.st_size;
+   LOG_ASSERT_ERROR(_data_size >= sizeof(InstructionTraceHeader), "%s is not an instruction trace", filename.c_str());
+
+   // The events are decoded straight from the page cache
+   _data = (Byte*) mmap(NULL, _data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   LOG_ASSERT_ERROR(_data != MAP_FAILED, "Could not map %s", filename.c_str());
+   madvise(_data, _data_size, MADV_SEQUENTIAL);
+   close(fd);
+
+   const InstructionTraceHeader* header = (const InstructionTraceHeader*) _data;
+   LOG_ASSERT_ERROR(header->magic == InstructionTraceHeader::MAGIC, "%s is not an instruction trace", filename.c_str());
+   LOG_ASSERT_ERROR(header->version == InstructionTraceHeader::VERSION,
+                    "%s was written by a different version of the simulator", filename.c_str());
+   _tile_id = header->tile_id;
+
+   _pos = _data + sizeof(InstructionTraceHeader);
+   _end = _data + _data_size;
+}
+
+InstructionTraceReader::~InstructionTraceReader()
+{
+   for (vector<Instruction*>::iterator it = _instructions.begin(); it != _instructions.end(); it++)
+      delete *it;
+   for (vector<McPATInstruction*>::iterator it = _mcpat_instructions.begin(); it != _mcpat_instructions.end(); it++)
+      delete *it;
+
+   munmap(_data, _data_size);
+}
+
+bool
+InstructionTraceReader::next(Event& event)
+{
+   while (_run_length == 0)
+   {
+      if (_pos == _end)
+      {
+         // No END event
+         LOG_ASSERT_WARNING(_ended, "Instruction trace(%s) was cut short", _filename.c_str());
+         _ended = true;
+         return false;
+      }
+
+      Byte tag = getByte();
+      UInt32 payload = tag >> 3;
+
+      switch (tag & 0x7)
+      {
+      case ITRACE_NEXT_INSTRUCTIONS:
+         _run_length = payload + 1;
+         break;
+
+      case ITRACE_INSTRUCTION:
+         {
+            SInt64 delta = getSignedVarint();
+            event._type = Event::INSTRUCTION;
+            event._instruction = getInstruction((UInt32) (_last_instruction_id + 1 + delta));
+         }
+         break;
+
+      case ITRACE_MEMORY_ACCESS:
+         event._type = Event::MEMORY_ACCESS;
+         event._mem_op_type = (Core::mem_op_t) (payload & 0x3);
+         event._lock_signal = (Core::lock_signal_t) (payload >> 2);
+         event._size = getVarint();
+         event._address = _last_memory_address + getSignedVarint();
+         _last_memory_address = event._address;
+         break;
+
+      case ITRACE_BRANCH:
+         event._type = Event::BRANCH;
+         event._taken = (payload & 0x1);
+         event._target = _last_instruction_address + getSignedVarint();
+         break;
+
+      case ITRACE_DEFINE_INSTRUCTION:
+         defineInstruction();
+         break;
+
+      case ITRACE_END:
+         _pos = _end;
+         _ended = true;
+         return false;
+
+      default:
+         LOG_PRINT_ERROR("Instruction trace(%s): unknown event(%u) at offset(%llu)",
+                         _filename.c_str(), tag & 0x7, (long long unsigned int) (_pos - 1 - _data));
+         break;
+      }
+
+      // In the middle of an event
+      if (_truncated)
+      {
+         LOG_PRINT_WARNING("Instruction trace(%s) was cut short", _filename.c_str());
+         _pos = _end;
+         _ended = true;
+         return false;
+      }
+
+      if ((tag & 0x7) != ITRACE_NEXT_INSTRUCTIONS && (tag & 0x7) != ITRACE_DEFINE_INSTRUCTION)
+         return true;
+   }
+
+   _run_length --;
+   event._type = Event::INSTRUCTION;
+   event._instruction = getInstruction(_last_instruction_id + 1);
+   return true;
+}
+
+Instruction*
+InstructionTraceReader::getInstruction(UInt32 id)
+{
+   LOG_ASSERT_ERROR(id < _instructions.size(), "Instruction trace(%s): instruction(%u) used before it is defined",
+                    _filename.c_str(), id);
+
+   Instruction* instruction = _instructions[id];
+   _last_instruction_id = id;
+   _last_instruction_address = instruction->getAddress();
+   return instruction;
+}
+
+void
+InstructionTraceReader::defineInstruction()
+{
+   InstructionType type = (InstructionType) getVarint();
+   UInt64 opcode = getVarint();
+   IntPtr address = getVarint();
+   UInt32 size = getVarint();
+   bool atomic = getVarint();
+
+   RegisterOperandList read_registers(getVarint());
+   for (UInt32 i = 0; i < read_registers.size(); i++)
+      read_registers[i] = getVarint();
+   RegisterOperandList write_registers(getVarint());
+   for (UInt32 i = 0; i < write_registers.size(); i++)
+      write_registers[i] = getVarint();
+   UInt32 num_read_memory_operands = getVarint();
+   UInt32 num_write_memory_operands = getVarint();
+   ImmediateOperandList immediates(getVarint());
+   for (UInt32 i = 0; i < immediates.size(); i++)
+      immediates[i] = getVarint();
+   OperandList operand_list(read_registers, write_registers,
+                            num_read_memory_operands, num_write_memory_operands,
+                            immediates);
+
+   McPATInstruction* mcpat_instruction = NULL;
+   if (getVarint())
+   {
+      McPATInstruction::MicroOpList micro_ops(getVarint());
+      for (UInt32 i = 0; i < micro_ops.size(); i++)
+         micro_ops[i] = (McPATInstruction::MicroOpType) getVarint();
+      McPATInstruction::RegisterFile register_file;
+      register_file._num_integer_reads = getVarint();
+      register_file._num_integer_writes = getVarint();
+      register_file._num_floating_point_reads = getVarint();
+      register_file._num_floating_point_writes = getVarint();
+      McPATInstruction::ExecutionUnitList execution_units(getVarint());
+      for (UInt32 i = 0; i < execution_units.size(); i++)
+         execution_units[i] = (McPATInstruction::ExecutionUnitType) getVarint();
+
+      mcpat_instruction = new McPATInstruction(micro_ops, register_file, execution_units);
+      _mcpat_instructions.push_back(mcpat_instruction);
+   }
+
+   LOG_ASSERT_ERROR(_truncated || type < MAX_INSTRUCTION_COUNT, "Instruction trace(%s): unknown instruction type(%u)",
+                    _filename.c_str(), type);
+
+   if (type == INST_BRANCH)
+      _instructions.push_back(new BranchInstruction(opcode, address, size, atomic, operand_list, mcpat_instruction));
+   else
+      _instructions.push_back(new Instruction(type, opcode, address, size, atomic, operand_list, mcpat_instruction));
+}
+
+Byte
+InstructionTraceReader::getByte()
+{
+   if (_pos == _end)
+   {
+      _truncated = true;
+      return 0;
+   }
+   return *_pos ++;
+}
+
+UInt64
+InstructionTraceReader::getVarint()
+{
+   UInt64 value = 0;
+   for (UInt32 shift = 0; shift < 64; shift += 7)
+   {
+      Byte byte = getByte();
+      value |= ((UInt64) (byte & 0x7f)) << shift;
+      if (!(byte & 0x80))
+         break;
+   }
+   return value;
+}
+
+SInt64
+InstructionTraceReader::getSignedVarint()
+{
+   UInt64 value = getVarint();
+   return (SInt64) (value >> 1) ^ -(SInt64) (value & 1);
+}
@@ -0,0 +1,174 @@
+#ifndef INSTRUCTION_TRACE_H
+#define INSTRUCTION_TRACE_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "fixed_types.h"
+#include "instruction.h"
+#include "core.h"
+
+// Recording of the instruction stream that a core model receives from the
+// frontend (the instructions, and the dynamic information of their memory
+// accesses and branches), so that it can be replayed later on the same tile
+// without re-executing the application (tools/trace_replay).
+//
+// [instruction_trace]
+// record = true      # writes instruction_trace.<tile>.bin to the output directory
+//
+// File: an InstructionTraceHeader, then a stream of events. Each event is a
+// tag byte (the InstructionTraceTag in the low 3 bits, a small payload in the
+// high 5 bits) followed by its arguments, as LEB128 varints (signed values
+// are zigzag-encoded deltas):
+//
+//    NEXT_INSTRUCTIONS    payload+1 instructions, each the one defined right
+//                         after the previous instruction of the stream
+//    INSTRUCTION          id - (id of the previous instruction + 1)
+//    MEMORY_ACCESS        payload = mem_op_t | (lock_signal_t << 2)
+//                         size, address - address of the previous access
+//    BRANCH               payload = taken
+//                         target - address of the previous instruction
+//    DEFINE_INSTRUCTION   the static information of the next instruction ID
+//    END                  the trace is complete
+//
+// An instruction is defined the first time it is seen, so the file can be
+// read as it is written, and a trace that was cut short is still valid up
+// to the last complete event.
+
+enum InstructionTraceTag
+{
+   ITRACE_NEXT_INSTRUCTIONS = 0,
+   ITRACE_INSTRUCTION,
+   ITRACE_MEMORY_ACCESS,
+   ITRACE_BRANCH,
+   ITRACE_DEFINE_INSTRUCTION,
+   ITRACE_END
+};
+
+struct InstructionTraceHeader
+{
+   static const UInt32 MAGIC = 0x43525449;   // "ITRC"
+   static const UInt32 VERSION = 1;
+
+   UInt32 magic;
+   UInt32 version;
+   SInt32 tile_id;
+   UInt32 padding;
+};
+
+class InstructionTraceWriter
+{
+public:
+   InstructionTraceWriter(tile_id_t tile_id, std::string filename, UInt32 buffer_size);
+   ~InstructionTraceWriter();
+
+   void recordInstruction(const Instruction* instruction);
+   void recordMemoryAccess(Core::lock_signal_t lock_signal, Core::mem_op_t mem_op_type, IntPtr address, UInt32 size);
+   void recordBranch(bool taken, IntPtr target);
+
+   // Writes out the buffered events
+   void flush();
+
+private:
+   static const UInt32 MAX_RUN_LENGTH = 32;
+   static const UInt32 MAX_EVENT_SIZE = 32;
+   static const UInt32 ID_CACHE_SIZE = 4096;
+
+   struct IdCacheEntry
+   {
+      const Instruction* _instruction;
+      UInt32 _id;
+   };
+
+   tile_id_t _tile_id;
+   std::string _filename;
+   FILE* _file;
+
+   Byte* _buffer;
+   UInt32 _buffer_size;
+   UInt32 _buffer_pos;
+
+   // Static instruction IDs, in the order the instructions were defined,
+   // with a direct-mapped cache in front of the map
+   std::map<const Instruction*, UInt32> _instruction_ids;
+   IdCacheEntry _id_cache[ID_CACHE_SIZE];
+
+   // NEXT_INSTRUCTIONS not written out yet
+   UInt32 _run_length;
+
+   UInt32 _last_instruction_id;
+   IntPtr _last_instruction_address;
+   IntPtr _last_memory_address;
+
+   UInt32 getInstructionId(const Instruction* instruction);
+   void defineInstruction(const Instruction* instruction);
+   void flushRun();
+   void writeBuffer();
+   void reserve(UInt32 size);
+   void putTag(InstructionTraceTag tag, UInt32 payload);
+   void putVarint(UInt64 value);
+   void putSignedVarint(SInt64 value);
+};
+
+class InstructionTraceReader
+{
+public:
+   struct Event
+   {
+      enum Type
+      {
+         INSTRUCTION,
+         MEMORY_ACCESS,
+         BRANCH
+      };
+
+      Type _type;
+      Instruction* _instruction;          // INSTRUCTION
+      Core::lock_signal_t _lock_signal;   // MEMORY_ACCESS
+      Core::mem_op_t _mem_op_type;
+      IntPtr _address;
+      UInt32 _size;
+      bool _taken;                        // BRANCH
+      IntPtr _target;
+   };
+
+   InstructionTraceReader(std::string filename);
+   ~InstructionTraceReader();
+
+   tile_id_t getTileId() const { return _tile_id; }
+
+   // Returns false at the end of the trace
+   bool next(Event& event);
+
+private:
+   std::string _filename;
+   tile_id_t _tile_id;
+
+   // The whole file is mapped
+   Byte* _data;
+   UInt64 _data_size;
+   const Byte* _pos;
+   const Byte* _end;
+   bool _truncated;     // in the middle of an event
+   bool _ended;
+
+   std::vector<Instruction*> _instructions;
+   std::vector<McPATInstruction*> _mcpat_instructions;
+
+   // NEXT_INSTRUCTIONS not returned yet
+   UInt32 _run_length;
+
+   UInt32 _last_instruction_id;
+   IntPtr _last_instruction_address;
+   IntPtr _last_memory_address;
+
+   Instruction* getInstruction(UInt32 id);
+   void defineInstruction();
+   Byte getByte();
+   UInt64 getVarint();
+   SInt64 getSignedVarint();
+};
+
+#endif // INSTRUCTION_TRACE_H
@@ -95,3 +95,34 @@ void SimpleCoreModel::handleInstruction(Instruction *instruction)
    // Power/Area modeling
    updateMcPATCounters(instruction);
 }
+
+void SimpleCoreModel::handleBasicBlock(BasicBlock *basic_block)
+{
+   // Same as handleInstruction() for all the instructions at once, except
+   // that each instruction is fetched when the fetches before it are done
+   // (and not also the execution of the instructions before it)
+   Time memory_stall_time(0);
+
+   // Instruction Memory Modeling
+   for (BasicBlock::iterator it = basic_block->begin(); it != basic_block->end(); it++)
+   {
+      Time instruction_memory_access_latency = modelICache(*it);
+      memory_stall_time += instruction_memory_access_latency;
+      _curr_time += instruction_memory_access_latency;
+   }
+   _total_l1icache_stall_time += memory_stall_time;
+
+   Time execution_unit_stall_time = getCost(basic_block);
+   _curr_time += execution_unit_stall_time;
+
+   // Update Statistics
+   _instruction_count += basic_block->size();
+
+   // Update memory fence / pipeline stall counters
+   updateMemoryFenceCounters(basic_block);
+   updatePipelineStallCounters(memory_stall_time, execution_unit_stall_time);
+
+   // Power/Area modeling
+   for (BasicBlock::iterator it = basic_block->begin(); it != basic_block->end(); it++)
+      updateMcPATCounters(*it);
+}
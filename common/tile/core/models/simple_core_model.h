@@ -13,6 +13,7 @@ public:
 
 private:
    void handleInstruction(Instruction *instruction);
+   void handleBasicBlock(BasicBlock *basic_block);
    
    void initializePipelineStallCounters();
 
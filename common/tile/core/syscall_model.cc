@@ -297,7 +297,7 @@ IntPtr SyscallMdl::marshallOpenCall(syscall_args_t &args)
    NetPacket recv_pkt;
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
    assert(recv_pkt.length == sizeof(int));
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    int status;
    m_recv_buff >> status;
@@ -346,7 +346,7 @@ IntPtr SyscallMdl::marshallReadCall(syscall_args_t &args)
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
    assert(recv_pkt.length >= sizeof(int));
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    int bytes;
    m_recv_buff >> bytes;
@@ -416,7 +416,7 @@ IntPtr SyscallMdl::marshallWriteCall(syscall_args_t &args)
    NetPacket recv_pkt;
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
    assert(recv_pkt.length == sizeof(int));
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    int status;
    m_recv_buff >> status;
@@ -479,7 +479,7 @@ IntPtr SyscallMdl::marshallWritevCall(syscall_args_t &args)
    NetPacket recv_pkt;
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
    assert(recv_pkt.length == sizeof(IntPtr));
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    IntPtr status;
    m_recv_buff >> status;
@@ -519,7 +519,7 @@ IntPtr SyscallMdl::marshallCloseCall(syscall_args_t &args)
    Core *core = Sim()->getTileManager()->getCurrentCore();
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
    assert(recv_pkt.length == sizeof(int));
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    int status;
    m_recv_buff >> status;
@@ -542,7 +542,7 @@ IntPtr SyscallMdl::marshallLseekCall(syscall_args_t &args)
    Core *core = Sim()->getTileManager()->getCurrentCore();
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
    LOG_ASSERT_ERROR(recv_pkt.length == sizeof(off_t), "Recv Pkt length: expected(%u), got(%u)", sizeof(off_t), recv_pkt.length);
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    off_t ret_val;
    m_recv_buff >> ret_val;
@@ -574,7 +574,7 @@ IntPtr SyscallMdl::marshallAccessCall(syscall_args_t &args)
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
    // Create a buffer out of the result
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    // return the result
    int result;
@@ -611,12 +611,12 @@ IntPtr SyscallMdl::marshallStatCall(syscall_args_t &args)
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
    // Create a buffer out of the result
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    assert(m_recv_buff.size() == (sizeof(int) + sizeof(struct stat)));
    
    // Get the results
-   int result;
+   int result = 0;
    m_recv_buff.get<int>(result);
    m_recv_buff >> make_pair(&stat_buf, sizeof(struct stat));
 
@@ -650,12 +650,12 @@ IntPtr SyscallMdl::marshallFstatCall(syscall_args_t &args)
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
    // Create a buffer out of the result
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
   
    assert(m_recv_buff.size() == (sizeof(int) + sizeof(struct stat)));
 
    // Get the results
-   int result;
+   int result = 0;
    m_recv_buff.get<int>(result);
    m_recv_buff >> make_pair(&buf, sizeof(struct stat));
 
@@ -693,10 +693,10 @@ IntPtr SyscallMdl::marshallIoctlCall(syscall_args_t &args)
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
    // Create a buffer out of the result
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
   
    // Get the results 
-   int result;
+   int result = 0;
    m_recv_buff.get<int>(result);
    m_recv_buff >> make_pair(&buf, sizeof(struct termios));
 
@@ -719,7 +719,7 @@ IntPtr SyscallMdl::marshallGetpidCall (syscall_args_t &args)
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
    // Create a buffer out of the result
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    // return the result
    int result;
@@ -753,7 +753,7 @@ IntPtr SyscallMdl::marshallReadaheadCall(syscall_args_t &args)
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
    // Create a buffer out of the result
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    // return the result
    int result;
@@ -778,7 +778,7 @@ IntPtr SyscallMdl::marshallPipeCall (syscall_args_t &args)
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
    // Create a buffer out of the result
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    // return the result
    int result;
@@ -872,10 +872,10 @@ IntPtr SyscallMdl::marshallMmapCall (syscall_args_t &args)
       recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
       // Create a buffer out of the result
-      m_recv_buff << make_pair (recv_pkt.data, recv_pkt.length);
+      m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
       // Return the result
-      void *addr;
+      void *addr = NULL;
       m_recv_buff.get(addr);
 
       // Delete the data buffer
@@ -930,10 +930,10 @@ IntPtr SyscallMdl::marshallMunmapCall (syscall_args_t &args)
       recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
       // Create a buffer out of the result
-      m_recv_buff << make_pair (recv_pkt.data, recv_pkt.length);
+      m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
       // Return the result
-      int ret_val;
+      int ret_val = 0;
       m_recv_buff.get(ret_val);
 
       // Delete the data buffer
@@ -982,10 +982,10 @@ IntPtr SyscallMdl::marshallBrkCall (syscall_args_t &args)
       recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
       // Create a buffer out of the result
-      m_recv_buff << make_pair (recv_pkt.data, recv_pkt.length);
+      m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
       // Return the result
-      void *new_end_data_segment;
+      void *new_end_data_segment = NULL;
       m_recv_buff.get (new_end_data_segment);
 
       // Delete the data buffer
@@ -1014,7 +1014,7 @@ IntPtr SyscallMdl::marshallFutexCall (syscall_args_t &args)
       LOG_ASSERT_ERROR(core, "Core = ((NULL))");
 
       UInt64 start_time;
-      UInt64 end_time;
+      UInt64 end_time = 0;
 
       start_time = core->getModel()->getCurrTime().getTime();
 
@@ -1042,10 +1042,10 @@ IntPtr SyscallMdl::marshallFutexCall (syscall_args_t &args)
       core->setState(Core::WAKING_UP);
 
       // Create a buffer out of the result
-      m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+      m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
       // Return the result
-      int ret_val;
+      int ret_val = 0;
       m_recv_buff.get(ret_val);
       m_recv_buff.get(end_time);
 
@@ -1107,7 +1107,7 @@ IntPtr SyscallMdl::marshallUnlinkCall(syscall_args_t &args)
    NetPacket recv_pkt;
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
    assert(recv_pkt.length == sizeof(int));
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    int status;
    m_recv_buff >> status;
@@ -1202,7 +1202,7 @@ IntPtr SyscallMdl::marshallGetCwdCall(syscall_args_t &args)
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
    assert(recv_pkt.length >= sizeof(int));
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    int bytes;
    m_recv_buff >> bytes;
@@ -1268,7 +1268,7 @@ IntPtr SyscallMdl::marshallSchedSetAffinityCall(syscall_args_t &args)
    NetPacket recv_pkt;
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
    m_recv_buff >> status;
 
    delete [] (Byte*) recv_pkt.data;
@@ -1311,7 +1311,7 @@ IntPtr SyscallMdl::marshallSchedGetAffinityCall(syscall_args_t &args)
    NetPacket recv_pkt;
    recv_pkt = m_network->netRecv(Config::getSingleton()->getMCPCoreId(), core->getId(), MCP_RESPONSE_TYPE);
 
-   m_recv_buff << make_pair(recv_pkt.data, recv_pkt.length);
+   m_recv_buff.wrap(recv_pkt.data, recv_pkt.length);
 
    m_recv_buff >> status;
 
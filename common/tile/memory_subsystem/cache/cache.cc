@@ -5,6 +5,7 @@
 #include "cache_replacement_policy.h"
 #include "cache_hash_fn.h"
 #include "mcpat_cache_interface.h"
+#include "miss_type_tracker.h"
 #include "utils.h"
 #include "log.h"
 #include "memory_manager.h"
@@ -37,6 +38,7 @@ Cache::Cache(string name,
    , _num_banks(num_banks)
    , _replacement_policy(replacement_policy)
    , _hash_fn(hash_fn)
+   , _miss_type_tracker(NULL)
    , _track_miss_types(track_miss_types)
    , _mcpat_cache_interface(NULL)
    , _shmem_perf_model(shmem_perf_model)
@@ -45,10 +47,21 @@ Cache::Cache(string name,
    _log_line_size = floorLog2(_line_size);
   
    // Instantiate cache sets 
+   // The data array is left to the OS to zero (and back with pages) on first touch
+   _cache_line_info_slab = new CacheLineInfoSlab(caching_protocol_type, cache_level, _num_sets * _associativity);
+   _lines = (char*) calloc(_cache_size, 1);
    _sets = new CacheSet*[_num_sets];
    for (UInt32 i = 0; i < _num_sets; i++)
    {
-      _sets[i] = new CacheSet(i, caching_protocol_type, cache_level, _replacement_policy, _associativity, _line_size);
+      _sets[i] = new CacheSet(i, _cache_line_info_slab, &_lines[i * _associativity * _line_size],
+                              _replacement_policy, _associativity, _line_size);
+   }
+
+   // Miss type tracking, optionally sampled for very large footprints
+   if (_track_miss_types)
+   {
+      UInt32 sampling_rate = Sim()->getCfg()->getInt("caching_protocol/miss_type_sampling_rate", 1);
+      _miss_type_tracker = new MissTypeTracker(_log_line_size, sampling_rate);
    }
 
    // Initialize DVFS variables
@@ -79,6 +92,9 @@ Cache::~Cache()
    for (SInt32 i = 0; i < (SInt32) _num_sets; i++)
       delete _sets[i];
    delete [] _sets;
+   delete _cache_line_info_slab;
+   free(_lines);
+   delete _miss_type_tracker;
 }
 
 void
@@ -133,7 +149,7 @@ Cache::insertCacheLine(IntPtr inserted_address, CacheLineInfo* inserted_cache_li
       assert(*evicted_address != INVALID_ADDRESS);
 
       if (_track_miss_types)
-         _evicted_address_set.insert(*evicted_address);
+         _miss_type_tracker->setFlag(*evicted_address, MissTypeTracker::EVICTED);
 
       // Update exclusive/sharing counters
       updateCacheLineStateCounters(evicted_cache_line_info->getCState(), CacheState::INVALID);
@@ -145,7 +161,7 @@ Cache::insertCacheLine(IntPtr inserted_address, CacheLineInfo* inserted_cache_li
 
    // Add to fetched set for tracking miss type
    if (_track_miss_types)
-      _fetched_address_set.insert(inserted_address);
+      _miss_type_tracker->setFlag(inserted_address, MissTypeTracker::FETCHED);
 
    // Update exclusive/sharing counters
    updateCacheLineStateCounters(CacheState::INVALID, inserted_cache_line_info->getCState());
@@ -219,18 +235,20 @@ void
 Cache::setCacheLineInfo(IntPtr address, CacheLineInfo* updated_cache_line_info)
 {
    LOG_PRINT("setCacheLineInfo: Address(%#lx) start", address);
-   CacheLineInfo* cache_line_info = getCacheLineInfo(address);
+   CacheSet* set = getSet(address);
+   UInt32 line_index = -1;
+   CacheLineInfo* cache_line_info = set->find(getTag(address), &line_index);
    LOG_ASSERT_ERROR(cache_line_info, "Address(%#lx)", address);
 
    // Update exclusive/shared counters
    updateCacheLineStateCounters(cache_line_info->getCState(), updated_cache_line_info->getCState());
   
-   // Update _invalidated_address_set
+   // Remember the invalidation for tracking miss types
    if ( (updated_cache_line_info->getCState() == CacheState::INVALID) && (_track_miss_types) )
-      _invalidated_address_set.insert(address);
+      _miss_type_tracker->setFlag(address, MissTypeTracker::INVALIDATED);
 
    // Update the cache line info   
-   cache_line_info->assign(updated_cache_line_info);
+   set->assign(line_index, updated_cache_line_info);
    
    if (_enabled)
    {
@@ -349,7 +367,7 @@ Cache::updateMissCounters(IntPtr address, Core::mem_op_t mem_op_type, bool cache
             _total_write_misses ++;
          
          // Compute the miss type counters for the inserted line
-         if (_track_miss_types)
+         if (_track_miss_types && _miss_type_tracker->isSampled(address))
          {
             miss_type = getMissType(address);
             updateMissTypeCounters(address, miss_type);
@@ -363,12 +381,13 @@ Cache::updateMissCounters(IntPtr address, Core::mem_op_t mem_op_type, bool cache
 Cache::MissType
 Cache::getMissType(IntPtr address) const
 {
-   // We maintain three address sets to keep track of miss types
-   if (_evicted_address_set.find(address) != _evicted_address_set.end())
+   // We keep three flags per line address to keep track of miss types
+   UInt32 flags = _miss_type_tracker->getFlags(address);
+   if (flags & MissTypeTracker::EVICTED)
       return CAPACITY_MISS;
-   else if (_invalidated_address_set.find(address) != _invalidated_address_set.end())
+   else if (flags & MissTypeTracker::INVALIDATED)
       return SHARING_MISS;
-   else if (_fetched_address_set.find(address) != _fetched_address_set.end())
+   else if (flags & MissTypeTracker::FETCHED)
       return SHARING_MISS;
    else
       return COLD_MISS;
@@ -398,9 +417,14 @@ Cache::updateMissTypeCounters(IntPtr address, MissType miss_type)
 void
 Cache::clearMissTypeTrackingSets(IntPtr address)
 {
-   if (_evicted_address_set.erase(address));
-   else if (_invalidated_address_set.erase(address));
-   else if (_fetched_address_set.erase(address));
+   // Only the first flag that is set gets cleared
+   UInt32 flags = _miss_type_tracker->getFlags(address);
+   if (flags & MissTypeTracker::EVICTED)
+      _miss_type_tracker->clearFlag(address, MissTypeTracker::EVICTED);
+   else if (flags & MissTypeTracker::INVALIDATED)
+      _miss_type_tracker->clearFlag(address, MissTypeTracker::INVALIDATED);
+   else if (flags & MissTypeTracker::FETCHED)
+      _miss_type_tracker->clearFlag(address, MissTypeTracker::FETCHED);
 }
 
 void
@@ -459,10 +483,25 @@ Cache::outputSummary(ostream& out, const Time& target_completion_time)
    // Track miss types
    if (_track_miss_types)
    {
-      out << "    Miss Types:" << endl;
-      out << "      Cold Misses: " << _total_cold_misses << endl;
-      out << "      Capacity Misses: " << _total_capacity_misses << endl;
-      out << "      Sharing Misses: " << _total_sharing_misses << endl;
+      UInt32 sampling_rate = _miss_type_tracker->getSamplingRate();
+      if (sampling_rate == 1)
+      {
+         out << "    Miss Types:" << endl;
+         out << "      Cold Misses: " << _total_cold_misses << endl;
+         out << "      Capacity Misses: " << _total_capacity_misses << endl;
+         out << "      Sharing Misses: " << _total_sharing_misses << endl;
+      }
+      else
+      {
+         // Scale the misses classified in sampled pages up to all misses
+         UInt64 sampled_misses = _total_cold_misses + _total_capacity_misses + _total_sharing_misses;
+         double scale = (sampled_misses > 0) ? ((double) _total_cache_misses) / sampled_misses : 0.0;
+         out << "    Miss Types (sampled 1 in " << sampling_rate << " pages):" << endl;
+         out << "      Sampled Misses: " << sampled_misses << endl;
+         out << "      Cold Misses: " << (UInt64) (_total_cold_misses * scale + 0.5) << endl;
+         out << "      Capacity Misses: " << (UInt64) (_total_capacity_misses * scale + 0.5) << endl;
+         out << "      Sharing Misses: " << (UInt64) (_total_sharing_misses * scale + 0.5) << endl;
+      }
    }
 
    // Cache Access Counters Summary
@@ -1,10 +1,8 @@
 #pragma once
 
 #include <string>
-#include <set>
 #include <cassert>
 using std::string;
-using std::set;
 
 #include "core.h"
 #include "cache_state.h"
@@ -19,9 +17,11 @@ using std::set;
 // Forwards Decls
 class CacheSet;
 class CacheLineInfo;
+class CacheLineInfoSlab;
 class CacheReplacementPolicy;
 class CacheHashFn;
 class McPATCacheInterface;
+class MissTypeTracker;
 
 class Cache
 {
@@ -90,6 +90,9 @@ public:
                         bool* eviction, IntPtr* evicted_address, CacheLineInfo* evicted_cache_line_info, Byte* writeback_buf);
    void getCacheLineInfo(IntPtr address, CacheLineInfo* cache_line_info);
    void setCacheLineInfo(IntPtr address, CacheLineInfo* updated_cache_line_info);
+   // Meta-data of a line without counting a tag array read (NULL if not present)
+   CacheLineInfo* peekCacheLineInfo(IntPtr address)
+   { return getCacheLineInfo(address); }
 
    // Get the tag associated with an address
    IntPtr getTag(IntPtr address) const;
@@ -141,6 +144,8 @@ private:
    CacheCategory _cache_category;
    WritePolicy _write_policy;
    CacheSet** _sets;
+   CacheLineInfoSlab* _cache_line_info_slab;
+   char* _lines;
 
    // Cache params
    UInt32 _cache_size;
@@ -170,9 +175,7 @@ private:
    UInt64 _total_capacity_misses;
    UInt64 _total_sharing_misses;
    // State for tracking type of cache misses
-   set<IntPtr> _fetched_address_set;
-   set<IntPtr> _evicted_address_set;
-   set<IntPtr> _invalidated_address_set;
+   MissTypeTracker* _miss_type_tracker;
 
    // Evictions
    UInt64 _total_evictions;
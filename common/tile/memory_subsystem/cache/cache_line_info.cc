@@ -1,3 +1,5 @@
+#include <cstdlib>
+
 #include "cache_line_info.h"
 #include "pr_l1_pr_l2_dram_directory_msi/cache_line_info.h"
 #include "pr_l1_pr_l2_dram_directory_mosi/cache_line_info.h"
@@ -14,21 +16,21 @@ CacheLineInfo::~CacheLineInfo()
 {}
 
 CacheLineInfo*
-CacheLineInfo::create(CachingProtocolType caching_protocol_type, SInt32 cache_level)
+CacheLineInfo::create(CachingProtocolType caching_protocol_type, SInt32 cache_level, void* storage)
 {
    switch (caching_protocol_type)
    {
    case PR_L1_PR_L2_DRAM_DIRECTORY_MSI:
-      return PrL1PrL2DramDirectoryMSI::createCacheLineInfo(cache_level);
+      return PrL1PrL2DramDirectoryMSI::createCacheLineInfo(cache_level, storage);
 
    case PR_L1_PR_L2_DRAM_DIRECTORY_MOSI:
-      return PrL1PrL2DramDirectoryMOSI::createCacheLineInfo(cache_level);
+      return PrL1PrL2DramDirectoryMOSI::createCacheLineInfo(cache_level, storage);
 
    case PR_L1_SH_L2_MSI:
-      return PrL1ShL2MSI::createCacheLineInfo(cache_level);
+      return PrL1ShL2MSI::createCacheLineInfo(cache_level, storage);
 
    case PR_L1_SH_L2_MESI:
-      return PrL1ShL2MESI::createCacheLineInfo(cache_level);
+      return PrL1ShL2MESI::createCacheLineInfo(cache_level, storage);
 
    default:
       LOG_PRINT_ERROR("Unrecognized caching protocol type(%u)", caching_protocol_type);
@@ -36,6 +38,29 @@ CacheLineInfo::create(CachingProtocolType caching_protocol_type, SInt32 cache_le
    }
 }
 
+UInt32
+CacheLineInfo::getSize(CachingProtocolType caching_protocol_type, SInt32 cache_level)
+{
+   switch (caching_protocol_type)
+   {
+   case PR_L1_PR_L2_DRAM_DIRECTORY_MSI:
+      return PrL1PrL2DramDirectoryMSI::getCacheLineInfoSize(cache_level);
+
+   case PR_L1_PR_L2_DRAM_DIRECTORY_MOSI:
+      return PrL1PrL2DramDirectoryMOSI::getCacheLineInfoSize(cache_level);
+
+   case PR_L1_SH_L2_MSI:
+      return PrL1ShL2MSI::getCacheLineInfoSize(cache_level);
+
+   case PR_L1_SH_L2_MESI:
+      return PrL1ShL2MESI::getCacheLineInfoSize(cache_level);
+
+   default:
+      LOG_PRINT_ERROR("Unrecognized caching protocol type(%u)", caching_protocol_type);
+      return 0;
+   }
+}
+
 void
 CacheLineInfo::invalidate()
 {
@@ -49,3 +74,26 @@ CacheLineInfo::assign(CacheLineInfo* cache_line_info)
    _tag = cache_line_info->getTag();
    _cstate = cache_line_info->getCState();
 }
+
+// CacheLineInfoSlab
+
+CacheLineInfoSlab::CacheLineInfoSlab(CachingProtocolType caching_protocol_type, SInt32 cache_level, UInt32 num_lines)
+   : _num_lines(num_lines)
+{
+   // Keep every line info pointer-aligned
+   UInt32 size = CacheLineInfo::getSize(caching_protocol_type, cache_level);
+   _stride = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+   __attribute__((unused)) int status = posix_memalign((void**) &_storage, 64, (size_t) _stride * _num_lines);
+   LOG_ASSERT_ERROR(status == 0, "Could not allocate %u line infos", _num_lines);
+
+   for (UInt32 i = 0; i < _num_lines; i++)
+      CacheLineInfo::create(caching_protocol_type, cache_level, get(i));
+}
+
+CacheLineInfoSlab::~CacheLineInfoSlab()
+{
+   for (UInt32 i = 0; i < _num_lines; i++)
+      get(i)->~CacheLineInfo();
+   free(_storage);
+}
@@ -13,7 +13,9 @@ public:
    CacheLineInfo(IntPtr tag = ~0, CacheState::Type cstate = CacheState::INVALID);
    virtual ~CacheLineInfo();
 
-   static CacheLineInfo* create(CachingProtocolType caching_protocol_type, SInt32 cache_level);
+   // Constructs the line info in 'storage' (of at least getSize() bytes) if given
+   static CacheLineInfo* create(CachingProtocolType caching_protocol_type, SInt32 cache_level, void* storage = NULL);
+   static UInt32 getSize(CachingProtocolType caching_protocol_type, SInt32 cache_level);
 
    virtual void invalidate();
    virtual void assign(CacheLineInfo* cache_line_info);
@@ -34,3 +36,20 @@ protected:
    IntPtr _tag;
    CacheState::Type _cstate;
 };
+
+// The line infos of a whole cache, constructed back to back in a single
+// cache-line-aligned block instead of one heap object per way
+class CacheLineInfoSlab
+{
+public:
+   CacheLineInfoSlab(CachingProtocolType caching_protocol_type, SInt32 cache_level, UInt32 num_lines);
+   ~CacheLineInfoSlab();
+
+   CacheLineInfo* get(UInt32 index) const
+   { return (CacheLineInfo*) (_storage + index * _stride); }
+
+private:
+   Byte* _storage;
+   UInt32 _stride;
+   UInt32 _num_lines;
+};
@@ -1,6 +1,9 @@
 #include "cache_replacement_policy.h"
 #include "round_robin_replacement_policy.h"
 #include "lru_replacement_policy.h"
+#include "matrix_lru_replacement_policy.h"
+#include "plru_replacement_policy.h"
+#include "rrip_replacement_policy.h"
 #include "cache_line_info.h"
 #include "log.h"
 
@@ -24,6 +27,14 @@ CacheReplacementPolicy::create(string policy_str, UInt32 cache_size, UInt32 asso
       return new RoundRobinReplacementPolicy(cache_size, associativity, cache_line_size);
    case LRU:
       return new LRUReplacementPolicy(cache_size, associativity, cache_line_size);
+   case MATRIX_LRU:
+      return new MatrixLRUReplacementPolicy(cache_size, associativity, cache_line_size);
+   case PLRU:
+      return new PLRUReplacementPolicy(cache_size, associativity, cache_line_size);
+   case SRRIP:
+      return new RRIPReplacementPolicy(cache_size, associativity, cache_line_size, RRIPReplacementPolicy::STATIC);
+   case BRRIP:
+      return new RRIPReplacementPolicy(cache_size, associativity, cache_line_size, RRIPReplacementPolicy::BIMODAL);
    default:
       LOG_PRINT_ERROR("Unrecognized Replacement Policy(%u)", policy);
       return (CacheReplacementPolicy*) NULL;
@@ -37,6 +48,14 @@ CacheReplacementPolicy::parse(string policy_str)
       return ROUND_ROBIN;
    if (policy_str == "lru")
       return LRU;
+   if (policy_str == "matrix_lru")
+      return MATRIX_LRU;
+   if (policy_str == "plru")
+      return PLRU;
+   if (policy_str == "srrip")
+      return SRRIP;
+   if (policy_str == "brrip")
+      return BRRIP;
    else
    {
       LOG_PRINT_ERROR("Unrecognized Cache Replacement Policy(%s)", policy_str.c_str());
@@ -44,3 +63,134 @@ CacheReplacementPolicy::parse(string policy_str)
    }
 }
 
+
+#ifdef BENCHMARK_REPLACEMENT_POLICY
+
+// Runs synthetic line-address streams through CacheSets with every
+// replacement policy and reports the simulated miss rate next to the host
+// time per access (lookup included). Link with cache_set.cc,
+// cache_line_info.cc, the *_replacement_policy.cc files, the protocols'
+// cache_line_info.cc, misc/utils.cc and a Log.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <vector>
+#include "cache_set.h"
+
+static double getTime()
+{
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+enum Workload
+{
+   RANDOM = 0,       // uniform over twice the cache
+   LOOP,             // cyclic scan over 1.5x the cache
+   HOT_AND_SCAN,     // 75% to a hot half-cache region, 25% streaming
+   NUM_WORKLOADS
+};
+
+static const char* workload_names[NUM_WORKLOADS] = { "random", "loop", "hot+scan" };
+
+static void generate(Workload workload, UInt32 num_lines, std::vector<IntPtr>& addresses)
+{
+   IntPtr scan_address = num_lines;
+   for (UInt32 i = 0; i < addresses.size(); i++)
+   {
+      switch (workload)
+      {
+      case RANDOM:
+         addresses[i] = rand() % (2 * num_lines);
+         break;
+      case LOOP:
+         addresses[i] = i % (num_lines + num_lines / 2);
+         break;
+      case HOT_AND_SCAN:
+         addresses[i] = (rand() % 4) ? (rand() % (num_lines / 2)) : (scan_address ++);
+         break;
+      default:
+         assert(false);
+      }
+   }
+}
+
+static void benchmark(UInt32 cache_size, UInt32 associativity, UInt32 line_size)
+{
+   const char* policies[] = { "round_robin", "lru", "matrix_lru", "plru", "srrip", "brrip" };
+   const UInt32 num_policies = sizeof(policies) / sizeof(policies[0]);
+   const UInt32 num_sets = cache_size * k_KILO / (associativity * line_size);
+   const UInt32 num_lines = num_sets * associativity;
+   const UInt32 num_accesses = 1 << 22;
+   // The cache level only selects the CacheLineInfo type
+   const SInt32 cache_level = 1;
+
+   printf("%u kB, %u-way, %u sets\n", cache_size, associativity, num_sets);
+
+   std::vector<IntPtr> addresses(num_accesses);
+   for (UInt32 w = 0; w < NUM_WORKLOADS; w++)
+   {
+      srand(42);
+      generate((Workload) w, num_lines, addresses);
+
+      printf("  %-9s", workload_names[w]);
+      for (UInt32 p = 0; p < num_policies; p++)
+      {
+         CacheReplacementPolicy* policy = CacheReplacementPolicy::create(policies[p], cache_size, associativity, line_size);
+         CacheLineInfoSlab cache_line_info_slab(PR_L1_PR_L2_DRAM_DIRECTORY_MSI, cache_level, num_lines);
+         std::vector<char> lines(num_lines * line_size);
+         std::vector<CacheSet*> sets(num_sets);
+         for (UInt32 set_num = 0; set_num < num_sets; set_num++)
+         {
+            sets[set_num] = new CacheSet(set_num, &cache_line_info_slab, &lines[set_num * associativity * line_size],
+                                         policy, associativity, line_size);
+         }
+
+         CacheLineInfo* inserted_line_info = CacheLineInfo::create(PR_L1_PR_L2_DRAM_DIRECTORY_MSI, cache_level);
+         CacheLineInfo* evicted_line_info = CacheLineInfo::create(PR_L1_PR_L2_DRAM_DIRECTORY_MSI, cache_level);
+         inserted_line_info->setCState(CacheState::SHARED);
+
+         UInt64 num_misses = 0;
+         double start = getTime();
+         for (UInt32 i = 0; i < num_accesses; i++)
+         {
+            CacheSet* set = sets[addresses[i] % num_sets];
+            IntPtr tag = addresses[i] / num_sets;
+            UInt32 line_index;
+            if (set->find(tag, &line_index))
+            {
+               set->read_line(line_index, 0, NULL, 0);
+            }
+            else
+            {
+               num_misses ++;
+               bool eviction;
+               inserted_line_info->setTag(tag);
+               set->insert(inserted_line_info, NULL, &eviction, evicted_line_info, NULL);
+            }
+         }
+         double elapsed = getTime() - start;
+
+         printf("  %s %5.1f%% %5.1fns", policies[p], 100.0 * num_misses / num_accesses, elapsed * 1e9 / num_accesses);
+
+         for (UInt32 set_num = 0; set_num < num_sets; set_num++)
+            delete sets[set_num];
+         delete inserted_line_info;
+         delete evicted_line_info;
+         delete policy;
+      }
+      printf("\n");
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   benchmark(512, 8, 64);
+   benchmark(2048, 16, 64);
+   benchmark(2048, 32, 64);
+   return 0;
+}
+
+#endif
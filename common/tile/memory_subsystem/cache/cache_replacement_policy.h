@@ -15,6 +15,10 @@ public:
    {
       ROUND_ROBIN = 0,
       LRU,
+      MATRIX_LRU,
+      PLRU,
+      SRRIP,
+      BRRIP,
       NUM_TYPES
    };
 
@@ -26,6 +30,11 @@ public:
    
    virtual UInt32 getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num) = 0;
    virtual void update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way) = 0;
+   // A line was filled into 'inserted_way'. Policies that tell fills from hits override this.
+   virtual void insert(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 inserted_way)
+   { update(cache_line_info_array, set_num, inserted_way); }
+   // The line in 'way' was invalidated (e.g., by the coherence protocol)
+   virtual void invalidate(UInt32 set_num, UInt32 way) {}
 
 protected:
    UInt32 _num_sets;
@@ -1,31 +1,35 @@
 #include <cstring>
+#include <climits>
+#if defined(__x86_64__) && defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__x86_64__) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include "cache_set.h"
 #include "cache.h"
 #include "log.h"
 
-CacheSet::CacheSet(UInt32 set_num, CachingProtocolType caching_protocol_type, SInt32 cache_level,
+CacheSet::CacheSet(UInt32 set_num, CacheLineInfoSlab* cache_line_info_slab, char* lines,
                    CacheReplacementPolicy* replacement_policy, UInt32 associativity, UInt32 line_size)
-   : _set_num(set_num)
+   : _lines(lines)
+   , _set_num(set_num)
    , _replacement_policy(replacement_policy)
    , _associativity(associativity)
    , _line_size(line_size)
 {
    _cache_line_info_array = new CacheLineInfo*[_associativity];
+   _tags = new IntPtr[_associativity];
    for (UInt32 i = 0; i < _associativity; i++)
    {
-      _cache_line_info_array[i] = CacheLineInfo::create(caching_protocol_type, cache_level);
+      _cache_line_info_array[i] = cache_line_info_slab->get(_set_num * _associativity + i);
+      _tags[i] = _cache_line_info_array[i]->getTag();
    }
-   _lines = new char[_associativity * _line_size];
-   
-   memset(_lines, 0x00, _associativity * _line_size);
 }
 
 CacheSet::~CacheSet()
 {
-   for (UInt32 i = 0; i < _associativity; i++)
-      delete _cache_line_info_array[i];
    delete [] _cache_line_info_array;
-   delete [] _lines;
+   delete [] _tags;
 }
 
 void 
@@ -57,16 +61,87 @@ CacheSet::write_line(UInt32 line_index, UInt32 offset, Byte *in_buf, UInt32 byte
 CacheLineInfo* 
 CacheSet::find(IntPtr tag, UInt32* line_index)
 {
-   for (SInt32 index = _associativity-1; index >= 0; index--)
+   SInt32 index = findTag(tag);
+   if (index < 0)
+      return NULL;
+
+   if (line_index != NULL)
+      *line_index = index;
+   return (_cache_line_info_array[index]);
+}
+
+// Below 16 ways the vector compare loses to the early-exit scan on both
+// SSE2 and AVX2 (see BENCHMARK_CACHE_SET below)
+#if defined(__x86_64__) && defined(__SSE2__)
+static const UInt32 MIN_VECTOR_ASSOCIATIVITY = 16;
+#else
+static const UInt32 MIN_VECTOR_ASSOCIATIVITY = UINT_MAX;
+#endif
+
+// Returns a mask with bit i set if tags[i] == tag (num_tags <= 64)
+static inline UInt64 matchTags(const IntPtr* tags, UInt32 num_tags, IntPtr tag)
+{
+   UInt64 mask = 0;
+   UInt32 i = 0;
+
+#if defined(__x86_64__) && defined(__AVX2__)
+   __m256i key = _mm256_set1_epi64x(tag);
+   for ( ; i + 4 <= num_tags; i += 4)
+   {
+      __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*) &tags[i]), key);
+      mask |= ((UInt64) _mm256_movemask_pd(_mm256_castsi256_pd(eq))) << i;
+   }
+#elif defined(__x86_64__) && defined(__SSE2__)
+   // SSE2 has no 64-bit compare: a 64-bit lane matches if both its halves do
+   __m128i key = _mm_set1_epi64x(tag);
+   for ( ; i + 2 <= num_tags; i += 2)
+   {
+      __m128i eq32 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*) &tags[i]), key);
+      __m128i eq64 = _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2,3,0,1)));
+      mask |= ((UInt64) _mm_movemask_pd(_mm_castsi128_pd(eq64))) << i;
+   }
+#endif
+
+   for ( ; i < num_tags; i++)
+      mask |= ((UInt64) (tags[i] == tag)) << i;
+
+   return mask;
+}
+
+SInt32
+CacheSet::findTag(IntPtr tag) const
+{
+   // At low associativity an early-exit scan of the packed tags is faster
+   // than comparing every way
+   if (_associativity < MIN_VECTOR_ASSOCIATIVITY)
    {
-      if (_cache_line_info_array[index]->getTag() == tag)
+      for (SInt32 index = _associativity-1; index >= 0; index--)
       {
-         if (line_index != NULL)
-            *line_index = index;
-         return (_cache_line_info_array[index]);
+         if (_tags[index] == tag)
+            return index;
       }
+      return -1;
    }
-   return NULL;
+
+   // Otherwise all the ways are compared without branching, 64 at a time
+   // starting from the top. The highest matching way wins, as it always has.
+   for (SInt32 base = (_associativity - 1) & ~63; base >= 0; base -= 64)
+   {
+      UInt64 mask = matchTags(&_tags[base], min<UInt32>(_associativity - base, 64), tag);
+      if (mask)
+         return base + 63 - __builtin_clzll(mask);
+   }
+   return -1;
+}
+
+void
+CacheSet::assign(UInt32 line_index, CacheLineInfo* cache_line_info)
+{
+   assert(line_index < _associativity);
+   _cache_line_info_array[line_index]->assign(cache_line_info);
+   _tags[line_index] = _cache_line_info_array[line_index]->getTag();
+   if (!_cache_line_info_array[line_index]->isValid())
+      _replacement_policy->invalidate(_set_num, line_index);
 }
 
 void 
@@ -95,9 +170,141 @@ CacheSet::insert(CacheLineInfo* inserted_cache_line_info, Byte* fill_buf,
    }
 
    _cache_line_info_array[index]->assign(inserted_cache_line_info);
+   _tags[index] = _cache_line_info_array[index]->getTag();
    if (fill_buf != NULL)
       memcpy(&_lines[index * _line_size], (void*) fill_buf, _line_size);
 
    // Update replacement policy
-   _replacement_policy->update(_cache_line_info_array, _set_num, index);
+   _replacement_policy->insert(_cache_line_info_array, _set_num, index);
+}
+
+#ifdef BENCHMARK_CACHE_SET
+
+// Lookups per second of CacheSet::find() on L1 and L2 geometries, next to
+// the loop it replaced, which read the tag out of every CacheLineInfo.
+// Half of the lookups hit (in a random way), half miss.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <vector>
+#include "lru_replacement_policy.h"
+
+// CacheSet as it was laid out, and the lookup it used to do
+struct OldCacheSet
+{
+   CacheLineInfo** _cache_line_info_array;
+   char* _lines;
+   UInt32 _associativity;
+};
+
+static __attribute__((noinline)) CacheLineInfo* oldFind(const OldCacheSet* set, IntPtr tag)
+{
+   for (SInt32 index = set->_associativity-1; index >= 0; index--)
+   {
+      if (set->_cache_line_info_array[index]->getTag() == tag)
+         return set->_cache_line_info_array[index];
+   }
+   return NULL;
+}
+
+static double getTime()
+{
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return tv.tv_sec + tv.tv_usec * 1e-6;
 }
+
+static void benchmark(const char* name, UInt32 cache_size, UInt32 associativity, UInt32 line_size)
+{
+   const UInt32 num_sets = cache_size * k_KILO / (associativity * line_size);
+   const UInt32 num_lookups = 1 << 16;
+   const UInt32 num_rounds = 256;
+
+   LRUReplacementPolicy replacement_policy(cache_size, associativity, line_size);
+   CacheLineInfoSlab cache_line_info_slab(PR_L1_PR_L2_DRAM_DIRECTORY_MSI, 1, num_sets * associativity);
+   std::vector<char> lines(num_sets * associativity * line_size);
+   std::vector<CacheSet*> sets(num_sets);
+   std::vector<OldCacheSet*> old_sets(num_sets);
+
+   CacheLineInfo* inserted_line_info = CacheLineInfo::create(PR_L1_PR_L2_DRAM_DIRECTORY_MSI, 1);
+   CacheLineInfo* evicted_line_info = CacheLineInfo::create(PR_L1_PR_L2_DRAM_DIRECTORY_MSI, 1);
+   for (UInt32 set_num = 0; set_num < num_sets; set_num++)
+   {
+      sets[set_num] = new CacheSet(set_num, &cache_line_info_slab, &lines[set_num * associativity * line_size], &replacement_policy, associativity, line_size);
+      old_sets[set_num] = new OldCacheSet;
+      old_sets[set_num]->_cache_line_info_array = new CacheLineInfo*[associativity];
+      old_sets[set_num]->_lines = new char[associativity * line_size];
+      old_sets[set_num]->_associativity = associativity;
+      for (UInt32 way = 0; way < associativity; way++)
+      {
+         IntPtr tag = way * num_sets + set_num;
+         inserted_line_info->setTag(tag);
+         inserted_line_info->setCState(CacheState::SHARED);
+         bool eviction;
+         sets[set_num]->insert(inserted_line_info, NULL, &eviction, evicted_line_info, NULL);
+
+         CacheLineInfo* old_line_info = CacheLineInfo::create(PR_L1_PR_L2_DRAM_DIRECTORY_MSI, 1);
+         old_line_info->assign(inserted_line_info);
+         old_sets[set_num]->_cache_line_info_array[way] = old_line_info;
+      }
+   }
+
+   std::vector<UInt32> lookup_sets(num_lookups);
+   std::vector<IntPtr> lookup_tags(num_lookups);
+   srand(42);
+   for (UInt32 i = 0; i < num_lookups; i++)
+   {
+      lookup_sets[i] = rand() % num_sets;
+      IntPtr way = (rand() % 2) ? (rand() % associativity) : (associativity + rand() % associativity);
+      lookup_tags[i] = way * num_sets + lookup_sets[i];
+   }
+
+   UInt64 new_hits = 0;
+   double start = getTime();
+   for (UInt32 round = 0; round < num_rounds; round++)
+   {
+      for (UInt32 i = 0; i < num_lookups; i++)
+         new_hits += (sets[lookup_sets[i]]->find(lookup_tags[i]) != NULL);
+   }
+   double new_time = getTime() - start;
+
+   UInt64 old_hits = 0;
+   start = getTime();
+   for (UInt32 round = 0; round < num_rounds; round++)
+   {
+      for (UInt32 i = 0; i < num_lookups; i++)
+         old_hits += (oldFind(old_sets[lookup_sets[i]], lookup_tags[i]) != NULL);
+   }
+   double old_time = getTime() - start;
+
+   assert(new_hits == old_hits);
+
+   double total_lookups = (double) num_lookups * num_rounds;
+   printf("%-4s %5u kB, %2u-way, %4u sets: packed %7.1f M lookups/s, CacheLineInfo %7.1f M lookups/s\n",
+          name, cache_size, associativity, num_sets,
+          total_lookups / new_time / 1e6, total_lookups / old_time / 1e6);
+
+   for (UInt32 set_num = 0; set_num < num_sets; set_num++)
+   {
+      delete sets[set_num];
+      for (UInt32 way = 0; way < associativity; way++)
+         delete old_sets[set_num]->_cache_line_info_array[way];
+      delete [] old_sets[set_num]->_cache_line_info_array;
+      delete [] old_sets[set_num]->_lines;
+      delete old_sets[set_num];
+   }
+   delete inserted_line_info;
+   delete evicted_line_info;
+}
+
+int main(int argc, char *argv[])
+{
+   benchmark("L1", 32, 4, 64);
+   benchmark("L1", 32, 8, 64);
+   benchmark("L2", 512, 8, 64);
+   benchmark("L2", 2048, 16, 64);
+   return 0;
+}
+
+#endif // BENCHMARK_CACHE_SET
@@ -4,11 +4,16 @@
 #include "cache_line_info.h"
 #include "cache_replacement_policy.h"
 
+//#define BENCHMARK_CACHE_SET
+
 // Everything related to cache sets
 class CacheSet
 {
 public:
-   CacheSet(UInt32 set_num, CachingProtocolType caching_protocol_type, SInt32 cache_level,
+   // Sets do not own their storage: the line infos of set 'set_num' are
+   // entries [set_num * associativity, (set_num + 1) * associativity) of the
+   // slab, and 'lines' holds associativity * line_size bytes of data
+   CacheSet(UInt32 set_num, CacheLineInfoSlab* cache_line_info_slab, char* lines,
             CacheReplacementPolicy* replacement_policy, UInt32 associativity, UInt32 line_size);
    ~CacheSet();
 
@@ -17,12 +22,19 @@ public:
    CacheLineInfo* find(IntPtr tag, UInt32* line_index = NULL);
    void insert(CacheLineInfo* inserted_cache_line_info, Byte* fill_buf,
                bool* eviction, CacheLineInfo* evicted_cache_line_info, Byte* writeback_buf);
+   // Line infos must be modified through assign() so that _tags stays in sync
+   void assign(UInt32 line_index, CacheLineInfo* cache_line_info);
 
 private:
    CacheLineInfo** _cache_line_info_array;
+   // Copy of the tag of every way, packed so that a lookup compares them
+   // with a few vector instructions instead of visiting every CacheLineInfo
+   IntPtr* _tags;
    char* _lines;
    UInt32 _set_num;
    CacheReplacementPolicy* _replacement_policy;
    UInt32 _associativity;
    UInt32 _line_size;
+
+   SInt32 findTag(IntPtr tag) const;
 };
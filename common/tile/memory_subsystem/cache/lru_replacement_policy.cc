@@ -5,11 +5,12 @@
 LRUReplacementPolicy::LRUReplacementPolicy(UInt32 cache_size, UInt32 associativity, UInt32 cache_line_size)
    : CacheReplacementPolicy(cache_size, associativity, cache_line_size)
 {
-   _lru_bits_vec.resize(_num_sets);
+   LOG_ASSERT_ERROR(_associativity <= 256, "Associativity(%u) too large for LRU bits", _associativity);
+
+   _lru_bits = new UInt8[_num_sets * _associativity];
    for (UInt32 set_num = 0; set_num < _num_sets; set_num ++)
    {
-      vector<UInt8>& lru_bits = _lru_bits_vec[set_num];
-      lru_bits.resize(_associativity);
+      UInt8* lru_bits = &_lru_bits[set_num * _associativity];
       for (UInt32 way_num = 0; way_num < _associativity; way_num ++)
       {
          lru_bits[way_num] = way_num;
@@ -18,12 +19,14 @@ LRUReplacementPolicy::LRUReplacementPolicy(UInt32 cache_size, UInt32 associativi
 }
 
 LRUReplacementPolicy::~LRUReplacementPolicy()
-{}
+{
+   delete [] _lru_bits;
+}
 
 UInt32 
 LRUReplacementPolicy::getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num)
 {
-   const vector<UInt8>& lru_bits = _lru_bits_vec[set_num];
+   const UInt8* lru_bits = &_lru_bits[set_num * _associativity];
    // Invalidations may mess up the LRU bits
    UInt32 way = _associativity;
    for (UInt32 i = 0; i < _associativity; i++)
@@ -40,10 +43,11 @@ LRUReplacementPolicy::getReplacementWay(CacheLineInfo** cache_line_info_array, U
 void
 LRUReplacementPolicy::update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way)
 {
-   vector<UInt8>& lru_bits = _lru_bits_vec[set_num];
+   UInt8* lru_bits = &_lru_bits[set_num * _associativity];
+   UInt8 accessed_lru_bits = lru_bits[accessed_way];
    for (UInt32 i = 0; i < _associativity; i++)
    {
-      if (lru_bits[i] < lru_bits[accessed_way])
+      if (lru_bits[i] < accessed_lru_bits)
          lru_bits[i] ++;
    }
    lru_bits[accessed_way] = 0;
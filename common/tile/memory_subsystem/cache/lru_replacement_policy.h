@@ -1,8 +1,5 @@
 #pragma once
 
-#include <vector>
-using std::vector;
-
 #include "cache_replacement_policy.h"
 
 class LRUReplacementPolicy : public CacheReplacementPolicy
@@ -15,5 +12,6 @@ public:
    void update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way);
   
 private: 
-   vector<vector<UInt8> > _lru_bits_vec;
+   // LRU ages of all the sets, one contiguous row of _associativity bytes per set
+   UInt8* _lru_bits;
 };
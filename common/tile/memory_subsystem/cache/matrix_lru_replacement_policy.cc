@@ -0,0 +1,69 @@
+#include "matrix_lru_replacement_policy.h"
+#include "log.h"
+
+MatrixLRUReplacementPolicy::MatrixLRUReplacementPolicy(UInt32 cache_size, UInt32 associativity, UInt32 cache_line_size)
+   : CacheReplacementPolicy(cache_size, associativity, cache_line_size)
+{
+   LOG_ASSERT_ERROR(_associativity <= 64, "Associativity(%u) too large for matrix LRU", _associativity);
+
+   _all_ways = (_associativity == 64) ? ~((UInt64) 0) : ((((UInt64) 1) << _associativity) - 1);
+
+   _rows = new UInt64[_num_sets * _associativity];
+   _lru_way = new UInt8[_num_sets];
+   _invalid_ways = new UInt64[_num_sets];
+   for (UInt32 set_num = 0; set_num < _num_sets; set_num ++)
+   {
+      // Same initial order as LRUReplacementPolicy: way 0 is the MRU way
+      UInt64* rows = &_rows[set_num * _associativity];
+      for (UInt32 way_num = 0; way_num < _associativity; way_num ++)
+         rows[way_num] = _all_ways & ~((((UInt64) 2) << way_num) - 1);
+      _lru_way[set_num] = _associativity - 1;
+      _invalid_ways[set_num] = _all_ways;
+   }
+}
+
+MatrixLRUReplacementPolicy::~MatrixLRUReplacementPolicy()
+{
+   delete [] _rows;
+   delete [] _lru_way;
+   delete [] _invalid_ways;
+}
+
+UInt32
+MatrixLRUReplacementPolicy::getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num)
+{
+   UInt64 invalid_ways = _invalid_ways[set_num];
+   if (invalid_ways)
+      return __builtin_ctzll(invalid_ways);
+   return _lru_way[set_num];
+}
+
+void
+MatrixLRUReplacementPolicy::update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way)
+{
+   UInt64* rows = &_rows[set_num * _associativity];
+   UInt64 accessed_bit = ((UInt64) 1) << accessed_way;
+
+   // Exactly one of the other rows is empty afterwards; that is the new LRU way
+   UInt32 lru_way = accessed_way;
+   for (UInt32 i = 0; i < _associativity; i++)
+   {
+      rows[i] &= ~accessed_bit;
+      lru_way = (rows[i] == 0 && i != accessed_way) ? i : lru_way;
+   }
+   rows[accessed_way] = _all_ways & ~accessed_bit;
+   _lru_way[set_num] = lru_way;
+}
+
+void
+MatrixLRUReplacementPolicy::insert(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 inserted_way)
+{
+   _invalid_ways[set_num] &= ~(((UInt64) 1) << inserted_way);
+   update(cache_line_info_array, set_num, inserted_way);
+}
+
+void
+MatrixLRUReplacementPolicy::invalidate(UInt32 set_num, UInt32 way)
+{
+   _invalid_ways[set_num] |= ((UInt64) 1) << way;
+}
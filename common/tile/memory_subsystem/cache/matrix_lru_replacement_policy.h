@@ -0,0 +1,25 @@
+#pragma once
+
+#include "cache_replacement_policy.h"
+
+// True LRU kept as an age matrix: bit j of row i is set if way i was accessed
+// more recently than way j. An access sets its row and clears its column, and
+// the LRU way is the one whose row is empty. Supports up to 64 ways.
+class MatrixLRUReplacementPolicy : public CacheReplacementPolicy
+{
+public:
+   MatrixLRUReplacementPolicy(UInt32 cache_size, UInt32 associativity, UInt32 cache_line_size);
+   ~MatrixLRUReplacementPolicy();
+
+   UInt32 getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num);
+   void update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way);
+   void insert(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 inserted_way);
+   void invalidate(UInt32 set_num, UInt32 way);
+
+private:
+   // _associativity rows per set
+   UInt64* _rows;
+   UInt8* _lru_way;
+   UInt64* _invalid_ways;
+   UInt64 _all_ways;
+};
@@ -0,0 +1,118 @@
+#include "miss_type_tracker.h"
+#include "log.h"
+
+MissTypeTracker::MissTypeTracker(UInt32 log_line_size, UInt32 sampling_rate)
+   : _log_line_size(log_line_size)
+   , _sampling_rate(sampling_rate)
+   , _num_entries(INITIAL_NUM_ENTRIES)
+   , _num_pages(0)
+{
+   LOG_ASSERT_ERROR(_sampling_rate >= 1, "Miss type sampling rate(%u) must be at least 1", _sampling_rate);
+
+   _pages = new Page[_num_entries];
+   for (UInt64 i = 0; i < _num_entries; i++)
+      _pages[i].page_num = INVALID_PAGE;
+}
+
+MissTypeTracker::~MissTypeTracker()
+{
+   delete [] _pages;
+}
+
+bool
+MissTypeTracker::isSampled(IntPtr address) const
+{
+   // Use the high bits of the hash, which the table index does not
+   return (_sampling_rate == 1) || ((hash(getPageNum(address)) >> 40) % _sampling_rate == 0);
+}
+
+UInt32
+MissTypeTracker::getFlags(IntPtr address) const
+{
+   Page* page = lookup(getPageNum(address));
+   if (page == NULL)
+      return 0;
+
+   UInt32 line_num = getLineNum(address);
+   return (((page->flags[0] >> line_num) & 1) * FETCHED) |
+          (((page->flags[1] >> line_num) & 1) * EVICTED) |
+          (((page->flags[2] >> line_num) & 1) * INVALIDATED);
+}
+
+void
+MissTypeTracker::setFlag(IntPtr address, Flag flag)
+{
+   if (!isSampled(address))
+      return;
+
+   Page* page = lookupOrInsert(getPageNum(address));
+   page->flags[getFlagIndex(flag)] |= ((UInt64) 1) << getLineNum(address);
+}
+
+void
+MissTypeTracker::clearFlag(IntPtr address, Flag flag)
+{
+   Page* page = lookup(getPageNum(address));
+   if (page)
+      page->flags[getFlagIndex(flag)] &= ~(((UInt64) 1) << getLineNum(address));
+}
+
+MissTypeTracker::Page*
+MissTypeTracker::lookup(IntPtr page_num) const
+{
+   UInt64 mask = _num_entries - 1;
+   for (UInt64 index = hash(page_num) & mask; ; index = (index + 1) & mask)
+   {
+      if (_pages[index].page_num == page_num)
+         return &_pages[index];
+      if (_pages[index].page_num == INVALID_PAGE)
+         return NULL;
+   }
+}
+
+MissTypeTracker::Page*
+MissTypeTracker::lookupOrInsert(IntPtr page_num)
+{
+   Page* page = lookup(page_num);
+   if (page)
+      return page;
+
+   // Keep the table at most half full
+   if (2 * (_num_pages + 1) > _num_entries)
+      grow();
+
+   UInt64 mask = _num_entries - 1;
+   UInt64 index = hash(page_num) & mask;
+   while (_pages[index].page_num != INVALID_PAGE)
+      index = (index + 1) & mask;
+
+   page = &_pages[index];
+   page->page_num = page_num;
+   page->flags[0] = page->flags[1] = page->flags[2] = 0;
+   _num_pages ++;
+   return page;
+}
+
+void
+MissTypeTracker::grow()
+{
+   Page* old_pages = _pages;
+   UInt64 old_num_entries = _num_entries;
+
+   _num_entries *= 2;
+   _pages = new Page[_num_entries];
+   for (UInt64 i = 0; i < _num_entries; i++)
+      _pages[i].page_num = INVALID_PAGE;
+
+   UInt64 mask = _num_entries - 1;
+   for (UInt64 i = 0; i < old_num_entries; i++)
+   {
+      if (old_pages[i].page_num == INVALID_PAGE)
+         continue;
+      UInt64 index = hash(old_pages[i].page_num) & mask;
+      while (_pages[index].page_num != INVALID_PAGE)
+         index = (index + 1) & mask;
+      _pages[index] = old_pages[i];
+   }
+   delete [] old_pages;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "fixed_types.h"
+
+// Remembers, for every line a cache has seen, whether it was fetched, evicted
+// and/or invalidated; Cache uses this to classify misses. Lines are grouped
+// by page (64 lines), and a page keeps one bitmap per flag in an
+// open-addressing hash table, so memory grows with the number of pages
+// touched (32 bytes each) rather than with a tree node per line and flag.
+//
+// With a sampling rate of N > 1, only lines in about 1 of N pages (picked by
+// a hash of the page) are tracked; flags of other lines are dropped and
+// read back as 0.
+class MissTypeTracker
+{
+public:
+   enum Flag
+   {
+      FETCHED = 1,
+      EVICTED = 2,
+      INVALIDATED = 4
+   };
+
+   MissTypeTracker(UInt32 log_line_size, UInt32 sampling_rate);
+   ~MissTypeTracker();
+
+   bool isSampled(IntPtr address) const;
+
+   UInt32 getFlags(IntPtr address) const;
+   void setFlag(IntPtr address, Flag flag);
+   void clearFlag(IntPtr address, Flag flag);
+
+   UInt64 getNumPages() const       { return _num_pages; }
+   UInt32 getSamplingRate() const   { return _sampling_rate; }
+
+private:
+   static const UInt32 LOG_LINES_PER_PAGE = 6;
+   static const UInt32 INITIAL_NUM_ENTRIES = 1024;
+   static const IntPtr INVALID_PAGE = ~((IntPtr) 0);
+
+   struct Page
+   {
+      IntPtr page_num;
+      UInt64 flags[3];
+   };
+
+   UInt32 _log_line_size;
+   UInt32 _sampling_rate;
+   Page* _pages;
+   UInt64 _num_entries;
+   UInt64 _num_pages;
+
+   Page* lookup(IntPtr page_num) const;
+   Page* lookupOrInsert(IntPtr page_num);
+   void grow();
+
+   IntPtr getPageNum(IntPtr address) const
+   { return address >> (_log_line_size + LOG_LINES_PER_PAGE); }
+   UInt32 getLineNum(IntPtr address) const
+   { return (address >> _log_line_size) & ((1 << LOG_LINES_PER_PAGE) - 1); }
+   static UInt64 hash(IntPtr page_num)
+   {
+      UInt64 h = ((UInt64) page_num) * 0x9E3779B97F4A7C15ULL;
+      return h ^ (h >> 29);
+   }
+   // FETCHED -> 0, EVICTED -> 1, INVALIDATED -> 2
+   static UInt32 getFlagIndex(Flag flag)
+   { return flag >> 1; }
+};
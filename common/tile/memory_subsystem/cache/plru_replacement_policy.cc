@@ -0,0 +1,77 @@
+#include "plru_replacement_policy.h"
+#include "utils.h"
+#include "log.h"
+
+PLRUReplacementPolicy::PLRUReplacementPolicy(UInt32 cache_size, UInt32 associativity, UInt32 cache_line_size)
+   : CacheReplacementPolicy(cache_size, associativity, cache_line_size)
+{
+   LOG_ASSERT_ERROR(isPower2(_associativity) && _associativity <= 64,
+                    "Associativity(%u) must be a power of 2 and at most 64 for PLRU", _associativity);
+
+   _num_levels = floorLog2(_associativity);
+
+   // Walk up from the leaf of every way and make each node on the path
+   // point away from it
+   for (UInt32 way = 0; way < _associativity; way++)
+   {
+      _path_mask[way] = 0;
+      _path_bits[way] = 0;
+      UInt32 node = way + _associativity - 1;
+      while (node > 0)
+      {
+         UInt32 parent = (node - 1) / 2;
+         _path_mask[way] |= ((UInt64) 1) << parent;
+         if (node == 2 * parent + 1)
+            _path_bits[way] |= ((UInt64) 1) << parent;
+         node = parent;
+      }
+   }
+
+   _tree_bits = new UInt64[_num_sets];
+   _invalid_ways = new UInt64[_num_sets];
+   UInt64 all_ways = (_associativity == 64) ? ~((UInt64) 0) : ((((UInt64) 1) << _associativity) - 1);
+   for (UInt32 set_num = 0; set_num < _num_sets; set_num ++)
+   {
+      _tree_bits[set_num] = 0;
+      _invalid_ways[set_num] = all_ways;
+   }
+}
+
+PLRUReplacementPolicy::~PLRUReplacementPolicy()
+{
+   delete [] _tree_bits;
+   delete [] _invalid_ways;
+}
+
+UInt32
+PLRUReplacementPolicy::getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num)
+{
+   UInt64 invalid_ways = _invalid_ways[set_num];
+   if (invalid_ways)
+      return __builtin_ctzll(invalid_ways);
+
+   UInt64 tree_bits = _tree_bits[set_num];
+   UInt32 node = 0;
+   for (UInt32 level = 0; level < _num_levels; level++)
+      node = 2 * node + 1 + ((tree_bits >> node) & 1);
+   return node - (_associativity - 1);
+}
+
+void
+PLRUReplacementPolicy::update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way)
+{
+   _tree_bits[set_num] = (_tree_bits[set_num] & ~_path_mask[accessed_way]) | _path_bits[accessed_way];
+}
+
+void
+PLRUReplacementPolicy::insert(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 inserted_way)
+{
+   _invalid_ways[set_num] &= ~(((UInt64) 1) << inserted_way);
+   update(cache_line_info_array, set_num, inserted_way);
+}
+
+void
+PLRUReplacementPolicy::invalidate(UInt32 set_num, UInt32 way)
+{
+   _invalid_ways[set_num] |= ((UInt64) 1) << way;
+}
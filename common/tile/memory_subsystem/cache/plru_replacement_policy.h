@@ -0,0 +1,27 @@
+#pragma once
+
+#include "cache_replacement_policy.h"
+
+// Tree pseudo-LRU. The (associativity - 1) nodes of the binary tree over the
+// ways of a set are the bits of one word; every node points towards the half
+// that was used less recently. Needs a power-of-2 associativity of at most 64.
+class PLRUReplacementPolicy : public CacheReplacementPolicy
+{
+public:
+   PLRUReplacementPolicy(UInt32 cache_size, UInt32 associativity, UInt32 cache_line_size);
+   ~PLRUReplacementPolicy();
+
+   UInt32 getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num);
+   void update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way);
+   void insert(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 inserted_way);
+   void invalidate(UInt32 set_num, UInt32 way);
+
+private:
+   // Node n has children 2n+1 and 2n+2; a set bit points right
+   UInt64* _tree_bits;
+   UInt64* _invalid_ways;
+   // An access to way w rewrites the nodes in _path_mask[w] to _path_bits[w]
+   UInt64 _path_mask[64];
+   UInt64 _path_bits[64];
+   UInt32 _num_levels;
+};
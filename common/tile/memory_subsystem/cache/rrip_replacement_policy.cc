@@ -0,0 +1,83 @@
+#include "rrip_replacement_policy.h"
+#include "log.h"
+
+RRIPReplacementPolicy::RRIPReplacementPolicy(UInt32 cache_size, UInt32 associativity, UInt32 cache_line_size,
+                                             InsertionPolicy insertion_policy)
+   : CacheReplacementPolicy(cache_size, associativity, cache_line_size)
+   , _insertion_policy(insertion_policy)
+   , _num_fills(0)
+{
+   LOG_ASSERT_ERROR(_associativity <= 64, "Associativity(%u) too large for RRIP", _associativity);
+
+   _all_ways = (_associativity == 64) ? ~((UInt64) 0) : ((((UInt64) 1) << _associativity) - 1);
+
+   _rrpvs = new RRPVs[_num_sets];
+   _invalid_ways = new UInt64[_num_sets];
+   for (UInt32 set_num = 0; set_num < _num_sets; set_num ++)
+   {
+      _rrpvs[set_num].high = _all_ways;
+      _rrpvs[set_num].low = _all_ways;
+      _invalid_ways[set_num] = _all_ways;
+   }
+}
+
+RRIPReplacementPolicy::~RRIPReplacementPolicy()
+{
+   delete [] _rrpvs;
+   delete [] _invalid_ways;
+}
+
+UInt32
+RRIPReplacementPolicy::getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num)
+{
+   UInt64 invalid_ways = _invalid_ways[set_num];
+   if (invalid_ways)
+      return __builtin_ctzll(invalid_ways);
+
+   // Age every way until one has a distant prediction. No RRPV is 3 when
+   // we age, so incrementing all of them cannot overflow; it takes at most 3 rounds.
+   RRPVs& rrpvs = _rrpvs[set_num];
+   UInt64 distant_ways;
+   while ((distant_ways = rrpvs.high & rrpvs.low) == 0)
+   {
+      rrpvs.high |= rrpvs.low;
+      rrpvs.low = ~rrpvs.low & _all_ways;
+   }
+   return __builtin_ctzll(distant_ways);
+}
+
+void
+RRIPReplacementPolicy::update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way)
+{
+   setRRPV(set_num, accessed_way, 0);
+}
+
+void
+RRIPReplacementPolicy::insert(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 inserted_way)
+{
+   _invalid_ways[set_num] &= ~(((UInt64) 1) << inserted_way);
+
+   UInt32 rrpv = 2;
+   if (_insertion_policy == BIMODAL)
+   {
+      _num_fills ++;
+      rrpv = (_num_fills % BIMODAL_THROTTLE == 0) ? 2 : 3;
+   }
+   setRRPV(set_num, inserted_way, rrpv);
+}
+
+void
+RRIPReplacementPolicy::invalidate(UInt32 set_num, UInt32 way)
+{
+   _invalid_ways[set_num] |= ((UInt64) 1) << way;
+   setRRPV(set_num, way, 3);
+}
+
+void
+RRIPReplacementPolicy::setRRPV(UInt32 set_num, UInt32 way, UInt32 rrpv)
+{
+   RRPVs& rrpvs = _rrpvs[set_num];
+   UInt64 way_bit = ((UInt64) 1) << way;
+   rrpvs.high = (rrpvs.high & ~way_bit) | ((rrpv & 2) ? way_bit : 0);
+   rrpvs.low = (rrpvs.low & ~way_bit) | ((rrpv & 1) ? way_bit : 0);
+}
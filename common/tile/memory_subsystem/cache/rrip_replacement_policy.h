@@ -0,0 +1,48 @@
+#pragma once
+
+#include "cache_replacement_policy.h"
+
+// Re-reference interval prediction (Jaleel et al., ISCA 2010) with 2-bit
+// re-reference prediction values (RRPVs). Hits predict a near re-reference
+// (RRPV 0), and the victim is a way with a distant prediction (RRPV 3).
+// STATIC (SRRIP) inserts lines with a long prediction (RRPV 2); BIMODAL
+// (BRRIP) inserts them with a distant one, except for one fill in 32.
+//
+// The RRPVs of a set are packed as two bit planes (high and low bits of every
+// way), so that finding and aging the distant ways is a handful of word
+// operations. Supports up to 64 ways.
+class RRIPReplacementPolicy : public CacheReplacementPolicy
+{
+public:
+   enum InsertionPolicy
+   {
+      STATIC = 0,
+      BIMODAL
+   };
+
+   RRIPReplacementPolicy(UInt32 cache_size, UInt32 associativity, UInt32 cache_line_size,
+                         InsertionPolicy insertion_policy);
+   ~RRIPReplacementPolicy();
+
+   UInt32 getReplacementWay(CacheLineInfo** cache_line_info_array, UInt32 set_num);
+   void update(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 accessed_way);
+   void insert(CacheLineInfo** cache_line_info_array, UInt32 set_num, UInt32 inserted_way);
+   void invalidate(UInt32 set_num, UInt32 way);
+
+private:
+   static const UInt32 BIMODAL_THROTTLE = 32;
+
+   struct RRPVs
+   {
+      UInt64 high;
+      UInt64 low;
+   };
+
+   InsertionPolicy _insertion_policy;
+   RRPVs* _rrpvs;
+   UInt64* _invalid_ways;
+   UInt64 _all_ways;
+   UInt32 _num_fills;
+
+   void setRRPV(UInt32 set_num, UInt32 way, UInt32 rrpv);
+};
@@ -0,0 +1,83 @@
+#include <sys/mman.h>
+
+#include "dram_backing_store.h"
+#include "log.h"
+
+DramBackingStore::DramBackingStore()
+   : _num_pages(0)
+{
+   for (UInt32 i = 0; i < DIRECTORY_SIZE; i++)
+      _directory[i] = NULL;
+}
+
+DramBackingStore::~DramBackingStore()
+{
+   for (UInt32 i = 0; i < DIRECTORY_SIZE; i++)
+   {
+      Byte** table = _directory[i];
+      if (!table)
+         continue;
+
+      for (UInt32 j = 0; j < TABLE_SIZE; j++)
+      {
+         if (table[j])
+            unmap(table[j], PAGE_SIZE);
+      }
+      unmap(table, TABLE_SIZE * sizeof(Byte*));
+   }
+}
+
+Byte*
+DramBackingStore::allocateLine(IntPtr address)
+{
+   UInt64 directory_index = address >> (PAGE_SHIFT + TABLE_SHIFT);
+   LOG_ASSERT_ERROR(directory_index < DIRECTORY_SIZE, "Address(%#lx) out of range", address);
+
+   // DRAM controllers on different threads may race to allocate the same
+   // table or page; the loser unmaps its copy
+   Byte** table = _directory[directory_index];
+   if (!table)
+   {
+      Byte** new_table = (Byte**) mapZeroed(TABLE_SIZE * sizeof(Byte*));
+      if (__sync_bool_compare_and_swap(&_directory[directory_index], (Byte**) NULL, new_table))
+         table = new_table;
+      else
+      {
+         unmap(new_table, TABLE_SIZE * sizeof(Byte*));
+         table = _directory[directory_index];
+      }
+   }
+
+   UInt32 table_index = (address >> PAGE_SHIFT) & (TABLE_SIZE - 1);
+   Byte* page = table[table_index];
+   if (!page)
+   {
+      Byte* new_page = (Byte*) mapZeroed(PAGE_SIZE);
+      if (__sync_bool_compare_and_swap(&table[table_index], (Byte*) NULL, new_page))
+      {
+         page = new_page;
+         __sync_fetch_and_add(&_num_pages, 1);
+      }
+      else
+      {
+         unmap(new_page, PAGE_SIZE);
+         page = table[table_index];
+      }
+   }
+
+   return page + (address & PAGE_MASK);
+}
+
+void*
+DramBackingStore::mapZeroed(size_t size)
+{
+   void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+   LOG_ASSERT_ERROR(addr != MAP_FAILED, "Could not map %lu bytes of DRAM backing store", size);
+   return addr;
+}
+
+void
+DramBackingStore::unmap(void* addr, size_t size)
+{
+   munmap(addr, size);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+
+#include "fixed_types.h"
+
+// Holds the contents of simulated DRAM for all the DRAM controllers of a
+// process (every line is homed at exactly one controller, so they never
+// share a line). The address space is split into 1 MB pages, found through
+// a two-level page table. Page tables and pages are mmap'd on first touch
+// and the OS hands out their zeroed memory lazily, so lines that were never
+// written read as zeros and untouched parts of a page take no space.
+
+class DramBackingStore
+{
+public:
+   DramBackingStore();
+   ~DramBackingStore();
+
+   // Storage for the line at 'address' (allocated if needed)
+   Byte* getLine(IntPtr address)
+   {
+      Byte* page = getPage(address);
+      return page ? (page + (address & PAGE_MASK)) : allocateLine(address);
+   }
+
+   // Storage for the line at 'address', or NULL if it was never allocated
+   Byte* lookupLine(IntPtr address)
+   {
+      Byte* page = getPage(address);
+      return page ? (page + (address & PAGE_MASK)) : NULL;
+   }
+
+   UInt64 getNumPages() { return _num_pages; }
+
+private:
+   static const UInt32 ADDRESS_BITS = 48;
+   static const UInt32 PAGE_SHIFT = 20;
+   static const UInt32 TABLE_SHIFT = 14;
+   static const UInt32 DIRECTORY_SHIFT = ADDRESS_BITS - PAGE_SHIFT - TABLE_SHIFT;
+
+   static const UInt64 PAGE_SIZE = 1ULL << PAGE_SHIFT;
+   static const UInt64 PAGE_MASK = PAGE_SIZE - 1;
+   static const UInt32 TABLE_SIZE = 1 << TABLE_SHIFT;
+   static const UInt32 DIRECTORY_SIZE = 1 << DIRECTORY_SHIFT;
+
+   // _directory[i] is the table of pages for addresses whose top bits are i
+   Byte** volatile _directory[DIRECTORY_SIZE];
+   volatile UInt64 _num_pages;
+
+   Byte* getPage(IntPtr address)
+   {
+      UInt64 directory_index = address >> (PAGE_SHIFT + TABLE_SHIFT);
+      if (directory_index >= DIRECTORY_SIZE)
+         return NULL;
+      Byte** table = _directory[directory_index];
+      return table ? table[(address >> PAGE_SHIFT) & (TABLE_SIZE - 1)] : NULL;
+   }
+
+   Byte* allocateLine(IntPtr address);
+
+   static void* mapZeroed(size_t size);
+   static void unmap(void* addr, size_t size);
+};
@@ -6,6 +6,10 @@
 #include "memory_manager.h"
 #include "log.h"
 #include "constants.h"
+#include "simulator.h"
+
+DramBackingStore* DramCntlr::_backing_store = NULL;
+UInt32 DramCntlr::_num_dram_cntlrs = 0;
 
 DramCntlr::DramCntlr(Tile* tile,
       float dram_access_cost,
@@ -14,6 +18,7 @@ DramCntlr::DramCntlr(Tile* tile,
       string dram_queue_model_type,
       UInt32 cache_line_size)
    : _tile(tile)
+   , _num_untracked_accesses(0)
    , _cache_line_size(cache_line_size)
 {
    _dram_perf_model = new DramPerfModel(dram_access_cost, 
@@ -22,26 +27,37 @@ DramCntlr::DramCntlr(Tile* tile,
                                         dram_queue_model_type,
                                         cache_line_size);
 
-   _dram_access_count = new AccessCountMap[NUM_ACCESS_TYPES];
+   UInt32 access_count_table_size = Sim()->getCfg()->getInt("dram/access_count_table_size", 0);
+   LOG_ASSERT_ERROR((access_count_table_size & (access_count_table_size - 1)) == 0,
+                    "dram/access_count_table_size(%u) must be a power of 2", access_count_table_size);
+   AccessCount empty_entry;
+   empty_entry._address = INVALID_ADDRESS;
+   for (UInt32 k = 0; k < NUM_ACCESS_TYPES; k++)
+      empty_entry._count[k] = 0;
+   _dram_access_count.resize(access_count_table_size, empty_entry);
+
+   // The DRAM controllers are created one at a time
+   if (_num_dram_cntlrs ++ == 0)
+      _backing_store = new DramBackingStore();
 }
 
 DramCntlr::~DramCntlr()
 {
    printDramAccessCount();
-   delete [] _dram_access_count;
 
    delete _dram_perf_model;
+
+   if (-- _num_dram_cntlrs == 0)
+   {
+      delete _backing_store;
+      _backing_store = NULL;
+   }
 }
 
 void
 DramCntlr::getDataFromDram(IntPtr address, Byte* data_buf, bool modeled)
 {
-   if (_data_map[address] == NULL)
-   {
-      _data_map[address] = new Byte[_cache_line_size];
-      memset((void*) _data_map[address], 0x00, _cache_line_size);
-   }
-   memcpy((void*) data_buf, (void*) _data_map[address], _cache_line_size);
+   memcpy((void*) data_buf, (void*) _backing_store->getLine(address), _cache_line_size);
 
    Latency dram_access_latency = modeled ? runDramPerfModel() : Latency(0,DRAM_FREQUENCY);
    LOG_PRINT("Dram Access Latency(%llu)", dram_access_latency.getCycles());
@@ -53,9 +69,10 @@ DramCntlr::getDataFromDram(IntPtr address, Byte* data_buf, bool modeled)
 void
 DramCntlr::putDataToDram(IntPtr address, Byte* data_buf, bool modeled)
 {
-   LOG_ASSERT_ERROR(_data_map[address] != NULL, "Data Buffer does not exist");
+   Byte* line = _backing_store->lookupLine(address);
+   LOG_ASSERT_ERROR(line != NULL, "Data Buffer does not exist");
    
-   memcpy((void*) _data_map[address], (void*) data_buf, _cache_line_size);
+   memcpy((void*) line, (void*) data_buf, _cache_line_size);
 
    __attribute__((unused)) Latency dram_access_latency = modeled ? runDramPerfModel() : Latency(0,DRAM_FREQUENCY);
    
@@ -76,7 +93,24 @@ DramCntlr::runDramPerfModel()
 void
 DramCntlr::addToDramAccessCount(IntPtr address, AccessType access_type)
 {
-   _dram_access_count[access_type][address] = _dram_access_count[access_type][address] + 1;
+   if (_dram_access_count.empty())
+      return;
+
+   UInt32 mask = _dram_access_count.size() - 1;
+   UInt32 index = (address / _cache_line_size) & mask;
+   for (UInt32 i = 0; i < MAX_ACCESS_COUNT_PROBES; i++, index = (index + 1) & mask)
+   {
+      AccessCount& entry = _dram_access_count[index];
+      if (entry._address == INVALID_ADDRESS)
+         entry._address = address;
+      if (entry._address == address)
+      {
+         entry._count[access_type] ++;
+         return;
+      }
+   }
+
+   _num_untracked_accesses ++;
 }
 
 void
@@ -84,16 +118,17 @@ DramCntlr::printDramAccessCount()
 {
    for (UInt32 k = 0; k < NUM_ACCESS_TYPES; k++)
    {
-      for (AccessCountMap::iterator i = _dram_access_count[k].begin(); i != _dram_access_count[k].end(); i++)
+      for (std::vector<AccessCount>::iterator i = _dram_access_count.begin(); i != _dram_access_count.end(); i++)
       {
-         if ((*i).second > 100)
+         if ((*i)._count[k] > 100)
          {
             LOG_PRINT("Dram Cntlr(%i), Address(0x%x), Access Count(%llu), Access Type(%s)", 
-                  _tile->getId(), (*i).first, (*i).second,
+                  _tile->getId(), (*i)._address, (*i)._count[k],
                   (k == READ)? "READ" : "WRITE");
          }
       }
    }
+   LOG_PRINT("Dram Cntlr(%i), Untracked Accesses(%llu)", _tile->getId(), _num_untracked_accesses);
 }
 
 ShmemPerfModel*
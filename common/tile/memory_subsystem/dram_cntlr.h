@@ -1,11 +1,11 @@
 #pragma once
 
-#include <map>
-using std::map;
+#include <vector>
 
 #include "tile.h"
 #include "dram_perf_model.h"
 #include "shmem_perf_model.h"
+#include "dram_backing_store.h"
 #include "fixed_types.h"
 #include "time_types.h"
 
@@ -34,11 +34,22 @@ public:
    
 private:
    Tile* _tile;
-   map<IntPtr, Byte*> _data_map;
    DramPerfModel* _dram_perf_model;
 
-   typedef std::map<IntPtr,UInt64> AccessCountMap;
-   AccessCountMap* _dram_access_count;
+   // Shared by all the DRAM controllers of the process
+   static DramBackingStore* _backing_store;
+   static UInt32 _num_dram_cntlrs;
+
+   // Access counts of the lines (dram/access_count_table_size lines at
+   // most; disabled if 0). Lines that do not fit are not counted.
+   struct AccessCount
+   {
+      IntPtr _address;
+      UInt64 _count[NUM_ACCESS_TYPES];
+   };
+   static const UInt32 MAX_ACCESS_COUNT_PROBES = 8;
+   std::vector<AccessCount> _dram_access_count;
+   UInt64 _num_untracked_accesses;
 
    ShmemPerfModel* getShmemPerfModel();
    Latency runDramPerfModel();
@@ -13,10 +13,18 @@ CachingProtocolType MemoryManager::_caching_protocol_type;
 
 MemoryManager::MemoryManager(Tile* tile)
    : _tile(tile)
+   , _handoff_lock(1)
+   , _lock_handed_off(false)
    , _enabled(false)
 {
    _network = _tile->getNetwork();
    _shmem_perf_model = new ShmemPerfModel();
+
+   // The app thread completes the misses that the L2 cache of its own tile can answer right
+   // away itself (if the protocol supports it). For the other misses, the sim thread passes
+   // the lock on to the app thread when the reply arrives and goes back to the network,
+   // instead of sleeping till the app thread has re-accessed the L1 cache.
+   _direct_execution = Sim()->getCfg()->getBool("caching_protocol/direct_execution", false);
    
    // Register call-backs
    _network->registerCallback(SHARED_MEM, MemoryManagerNetworkCallback, this);
@@ -83,7 +91,7 @@ MemoryManager::__coreInitiateMemoryAccess(MemComponent::Type mem_component,
                                           Time& curr_time, bool modeled)
 {
    if (lock_signal != Core::UNLOCK)
-      _lock.acquire();
+      acquireLock();
    
    _shmem_perf_model->setCurrTime(curr_time);
 
@@ -93,7 +101,7 @@ MemoryManager::__coreInitiateMemoryAccess(MemComponent::Type mem_component,
    curr_time = _shmem_perf_model->getCurrTime();
 
    if (lock_signal != Core::LOCK)
-      _lock.release();
+      releaseLock();
 
    return ret;
 }
@@ -101,7 +109,7 @@ MemoryManager::__coreInitiateMemoryAccess(MemComponent::Type mem_component,
 void
 MemoryManager::__handleMsgFromNetwork(NetPacket& packet)
 {
-   _lock.acquire();
+   acquireLock();
 
    _shmem_perf_model->setCurrTime(packet.time);
 
@@ -116,7 +124,11 @@ MemoryManager::__handleMsgFromNetwork(NetPacket& packet)
       break;
    }
 
-   _lock.release();
+   // With direct execution, the lock may now belong to the app thread
+   if (_lock_handed_off)
+      _lock_handed_off = false;
+   else
+      releaseLock();
 }
 
 void
@@ -138,9 +150,31 @@ MemoryManager::outputSummary(ostream& out, const Time& target_completion_time)
 {
 }
 
+void
+MemoryManager::acquireLock()
+{
+   if (_direct_execution)
+      _handoff_lock.wait();
+   else
+      _lock.acquire();
+}
+
+void
+MemoryManager::releaseLock()
+{
+   if (_direct_execution)
+      _handoff_lock.signal();
+   else
+      _lock.release();
+}
+
 void
 MemoryManager::waitForAppThread()
 {
+   // The app thread releases the lock after its memory operation
+   if (_direct_execution)
+      return;
+
    _sim_thread_sem.wait();
    _lock.acquire();
 }
@@ -148,20 +182,27 @@ MemoryManager::waitForAppThread()
 void
 MemoryManager::wakeUpAppThread()
 {
-   _lock.release();
+   if (_direct_execution)
+      _lock_handed_off = true;
+   else
+      _lock.release();
    _app_thread_sem.signal();
 }
 
 void
 MemoryManager::waitForSimThread()
 {
-   _lock.release();
+   releaseLock();
    _app_thread_sem.wait();
 }
 
 void
 MemoryManager::wakeUpSimThread()
 {
+   // The app thread already holds the lock handed over by the sim thread
+   if (_direct_execution)
+      return;
+
    _lock.acquire();
    _sim_thread_sem.signal();
 }
@@ -36,6 +36,7 @@ public:
    virtual void enableModels();
    virtual void disableModels();
    bool isEnabled()                       { return _enabled;  }
+   bool isDirectExecutionEnabled()        { return _direct_execution; }
   
    // APP + SIM thread synchronization 
    void waitForAppThread();
@@ -83,6 +84,12 @@ private:
    Semaphore _app_thread_sem;
    Semaphore _sim_thread_sem;
 
+   // Direct execution: the lock is a semaphore instead, since the sim thread
+   // hands it over to the app thread, which then releases it
+   bool _direct_execution;
+   Semaphore _handoff_lock;
+   bool _lock_handed_off;     // only accessed by the sim thread
+
    // Enabled
    bool _enabled;
 
@@ -91,6 +98,9 @@ private:
                                          IntPtr address, UInt32 offset, Byte* data_buf, UInt32 data_length,
                                          bool modeled) = 0;
    virtual void handleMsgFromNetwork(NetPacket& packet) = 0;
+
+   void acquireLock();
+   void releaseLock();
    
    void parseMemoryControllerList(string& memory_controller_positions,
                                   vector<tile_id_t>& tile_list_from_cfg_file,
@@ -33,6 +33,9 @@ class DramPerfModel
       
       bool m_enabled;
 
+      // DRAM_FREQUENCY
+      ClockPeriod m_clock_period;
+
       // Performance Counters
       UInt64 m_num_accesses;
       double m_total_access_latency;
@@ -1,3 +1,5 @@
+#include <new>
+
 #include "cache_line_info.h"
 #include "cache_utils.h"
 #include "log.h"
@@ -6,20 +8,35 @@ namespace PrL1PrL2DramDirectoryMOSI
 {
 
 CacheLineInfo*
-createCacheLineInfo(SInt32 cache_level)
+createCacheLineInfo(SInt32 cache_level, void* storage)
 {
    switch (cache_level)
    {
    case L1:
-      return new PrL1CacheLineInfo();
+      return storage ? new (storage) PrL1CacheLineInfo() : new PrL1CacheLineInfo();
    case L2:
-      return new PrL2CacheLineInfo();
+      return storage ? new (storage) PrL2CacheLineInfo() : new PrL2CacheLineInfo();
    default:
       LOG_PRINT_ERROR("Unrecognized Cache Level(%u)", cache_level);
       return (CacheLineInfo*) NULL;
    }
 }
 
+UInt32
+getCacheLineInfoSize(SInt32 cache_level)
+{
+   switch (cache_level)
+   {
+   case L1:
+      return sizeof(PrL1CacheLineInfo);
+   case L2:
+      return sizeof(PrL2CacheLineInfo);
+   default:
+      LOG_PRINT_ERROR("Unrecognized Cache Level(%u)", cache_level);
+      return 0;
+   }
+}
+
 //// PrL2 CacheLineInfo
 
 PrL2CacheLineInfo::PrL2CacheLineInfo(IntPtr tag, CacheState::Type cstate, MemComponent::Type cached_loc)
@@ -70,7 +87,7 @@ void
 PrL2CacheLineInfo::assign(CacheLineInfo* cache_line_info)
 {
    CacheLineInfo::assign(cache_line_info);
-   PrL2CacheLineInfo* L2_cache_line_info = dynamic_cast<PrL2CacheLineInfo*>(cache_line_info);
+   PrL2CacheLineInfo* L2_cache_line_info = static_cast<PrL2CacheLineInfo*>(cache_line_info);
    _cached_loc = L2_cache_line_info->getCachedLoc();
 }
 
@@ -9,7 +9,8 @@
 namespace PrL1PrL2DramDirectoryMOSI
 {
 
-CacheLineInfo* createCacheLineInfo(SInt32 cache_level);
+CacheLineInfo* createCacheLineInfo(SInt32 cache_level, void* storage = NULL);
+UInt32 getCacheLineInfoSize(SInt32 cache_level);
 
 typedef CacheLineInfo PrL1CacheLineInfo;
 
@@ -551,12 +551,9 @@ DramDirectoryCntlr::sendShmemMsg(ShmemMsg::Type requester_msg_type, ShmemMsg::Ty
    else
    {
       // Send Invalidation Request to only a specific set of sharers
-      for (UInt32 i = 0; i < sharers_list.size(); i++)
-      {
-         ShmemMsg shmem_msg(send_msg_type, MemComponent::DRAM_DIRECTORY, MemComponent::L2_CACHE,
-               requester, single_receiver, false, address, msg_modeled);
-         _memory_manager->sendMsg(sharers_list[i], shmem_msg);
-      }
+      ShmemMsg shmem_msg(send_msg_type, MemComponent::DRAM_DIRECTORY, MemComponent::L2_CACHE,
+            requester, single_receiver, false, address, msg_modeled);
+      _memory_manager->multicastMsg(sharers_list, shmem_msg);
    }
 }
 
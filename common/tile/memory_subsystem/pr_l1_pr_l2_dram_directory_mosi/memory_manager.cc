@@ -344,6 +344,42 @@ MemoryManager::broadcastMsg(ShmemMsg& shmem_msg)
    delete [] msg_buf;
 }
 
+void
+MemoryManager::multicastMsg(const vector<tile_id_t>& receivers, ShmemMsg& shmem_msg)
+{
+   assert((shmem_msg.getDataBuf() == NULL) == (shmem_msg.getDataLength() == 0));
+
+   // Messages to this tile do not see a synchronization delay (see sendMsg())
+   vector<tile_id_t> remote_receivers;
+   remote_receivers.reserve(receivers.size());
+   for (UInt32 i = 0; i < receivers.size(); i++)
+   {
+      if (receivers[i] == getTile()->getId())
+         sendMsg(receivers[i], shmem_msg);
+      else
+         remote_receivers.push_back(receivers[i]);
+   }
+   if (remote_receivers.empty())
+      return;
+
+   Byte* msg_buf = shmem_msg.makeMsgBuf();
+   Time msg_time = getShmemPerfModel()->getCurrTime();
+
+   LOG_PRINT("Time(%llu), Multicasting Msg: type(%s), address(%#lx), "
+             "sender_mem_component(%s), receiver_mem_component(%s), requester(%i), sender(%i)",
+             msg_time.toNanosec(), SPELL_SHMSG(shmem_msg.getType()), shmem_msg.getAddress(),
+             SPELL_MEMCOMP(shmem_msg.getSenderMemComponent()), SPELL_MEMCOMP(shmem_msg.getReceiverMemComponent()),
+             shmem_msg.getRequester(), getTile()->getId());
+
+   NetPacket packet(msg_time, SHARED_MEM,
+         getTile()->getId(), NetPacket::MULTICAST,
+         shmem_msg.getMsgLen(), (const void*) msg_buf);
+   getNetwork()->netMulticast(DVFSManager::convertToModule(shmem_msg.getSenderMemComponent()), packet, remote_receivers);
+
+   // Delete the Msg Buf
+   delete [] msg_buf;
+}
+
 void
 MemoryManager::incrCurrTime(MemComponent::Type mem_component, CachePerfModel::AccessType access_type)
 {
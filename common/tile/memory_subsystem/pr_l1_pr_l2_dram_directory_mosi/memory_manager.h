@@ -40,6 +40,7 @@ namespace PrL1PrL2DramDirectoryMOSI
       
       void sendMsg(tile_id_t receiver, ShmemMsg& shmem_msg);
       void broadcastMsg(ShmemMsg& shmem_msg);
+      void multicastMsg(const vector<tile_id_t>& receivers, ShmemMsg& shmem_msg);
     
       void enableModels();
       void disableModels();
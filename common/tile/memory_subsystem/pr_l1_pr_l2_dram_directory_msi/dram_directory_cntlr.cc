@@ -208,12 +208,9 @@ DramDirectoryCntlr::processNullifyReq(ShmemReq* shmem_req)
          else
          {
             // Send Invalidation Request to only a specific set of sharers
-            for (UInt32 i = 0; i < sharers_list.size(); i++)
-            {
-               ShmemMsg msg(ShmemMsg::INV_REQ, MemComponent::DRAM_DIRECTORY, MemComponent::L2_CACHE, requester, address,
-                            msg_modeled);
-               _memory_manager->sendMsg(sharers_list[i], msg);
-            }
+            ShmemMsg msg(ShmemMsg::INV_REQ, MemComponent::DRAM_DIRECTORY, MemComponent::L2_CACHE, requester, address,
+                         msg_modeled);
+            _memory_manager->multicastMsg(sharers_list, msg);
          }
       }
       break;
@@ -279,12 +276,9 @@ DramDirectoryCntlr::processExReqFromL2Cache(ShmemReq* shmem_req, Byte* cached_da
          else
          {
             // Send Invalidation Request to only a specific set of sharers
-            for (UInt32 i = 0; i < sharers_list.size(); i++)
-            {
-               ShmemMsg msg(ShmemMsg::INV_REQ, MemComponent::DRAM_DIRECTORY, MemComponent::L2_CACHE, requester, address,
-                            msg_modeled);
-               _memory_manager->sendMsg(sharers_list[i], msg);
-            }
+            ShmemMsg msg(ShmemMsg::INV_REQ, MemComponent::DRAM_DIRECTORY, MemComponent::L2_CACHE, requester, address,
+                         msg_modeled);
+            _memory_manager->multicastMsg(sharers_list, msg);
          }
       }
       break;
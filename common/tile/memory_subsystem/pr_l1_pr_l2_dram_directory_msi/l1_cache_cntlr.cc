@@ -3,6 +3,7 @@
 #include "memory_manager.h"
 #include "config.h"
 #include "log.h"
+#include "event_tracer.h"
 
 namespace PrL1PrL2DramDirectoryMSI
 {
@@ -94,8 +95,8 @@ L1CacheCntlr::processMemOpFromCore(MemComponent::Type mem_component,
                                    Byte* data_buf, UInt32 data_length,
                                    bool modeled)
 {
-   LOG_PRINT("processMemOpFromCore(), lock_signal(%u), mem_op_type(%u), ca_address(0x%x)",
-         lock_signal, mem_op_type, ca_address);
+   TRACE_EVENT(MEMORY_OP_FROM_CORE, getTileId(), getShmemPerfModel()->getCurrTime().toNanosec(),
+               lock_signal, mem_op_type, ca_address);
 
    bool l1_cache_hit = true;
    UInt32 access_num = 0;
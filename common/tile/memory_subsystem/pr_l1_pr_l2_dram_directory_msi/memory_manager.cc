@@ -4,6 +4,7 @@
 #include "tile_manager.h"
 #include "utils.h"
 #include "log.h"
+#include "event_tracer.h"
 
 namespace PrL1PrL2DramDirectoryMSI
 {
@@ -243,9 +244,8 @@ MemoryManager::handleMsgFromNetwork(NetPacket& packet)
    MemComponent::Type receiver_mem_component = shmem_msg->getReceiverMemComponent();
    MemComponent::Type sender_mem_component = shmem_msg->getSenderMemComponent();
 
-   LOG_PRINT("Got Shmem Msg: type(%i), address(%#lx), sender_mem_component(%u), receiver_mem_component(%u), sender(%i,%i), receiver(%i,%i)", 
-             shmem_msg->getType(), shmem_msg->getAddress(), sender_mem_component, receiver_mem_component,
-             sender.tile_id, sender.core_type, packet.receiver.tile_id, packet.receiver.core_type);    
+   TRACE_EVENT(MEMORY_MSG_RECEIVED, getTile()->getId(), packet.time.toNanosec(),
+               shmem_msg->getType(), shmem_msg->getAddress(), sender.tile_id);
 
    switch (receiver_mem_component)
    {
@@ -311,10 +311,8 @@ MemoryManager::sendMsg(tile_id_t receiver, ShmemMsg& shmem_msg)
    Byte* msg_buf = shmem_msg.makeMsgBuf();
    Time msg_time = getShmemPerfModel()->getCurrTime();
 
-   LOG_PRINT("Sending Msg: type(%u), address(%#lx), sender_mem_component(%u), receiver_mem_component(%u), "
-             "requester(%i), sender(%i), receiver(%i)",
-             shmem_msg.getType(), shmem_msg.getAddress(), shmem_msg.getSenderMemComponent(), shmem_msg.getReceiverMemComponent(),
-             shmem_msg.getRequester(), getTile()->getId(), receiver);
+   TRACE_EVENT(MEMORY_MSG_SENT, getTile()->getId(), msg_time.toNanosec(),
+               shmem_msg.getType(), shmem_msg.getAddress(), receiver);
 
    NetPacket packet(msg_time, SHARED_MEM,
          getTile()->getId(), receiver,
@@ -339,10 +337,8 @@ MemoryManager::broadcastMsg(ShmemMsg& shmem_msg)
    Byte* msg_buf = shmem_msg.makeMsgBuf();
    Time msg_time = getShmemPerfModel()->getCurrTime();
 
-   LOG_PRINT("Broadcasting Msg: type(%u), address(%#lx), sender_mem_component(%u), receiver_mem_component(%u), "
-             "requester(%i), sender(%i)",
-             shmem_msg.getType(), shmem_msg.getAddress(), shmem_msg.getSenderMemComponent(), shmem_msg.getReceiverMemComponent(),
-             shmem_msg.getRequester(), getTile()->getId());
+   TRACE_EVENT(MEMORY_MSG_BROADCAST, getTile()->getId(), msg_time.toNanosec(),
+               shmem_msg.getType(), shmem_msg.getAddress(), 0);
 
    NetPacket packet(msg_time, SHARED_MEM,
          getTile()->getId(), NetPacket::BROADCAST,
@@ -353,6 +349,39 @@ MemoryManager::broadcastMsg(ShmemMsg& shmem_msg)
    delete [] msg_buf;
 }
 
+void
+MemoryManager::multicastMsg(const vector<tile_id_t>& receivers, ShmemMsg& shmem_msg)
+{
+   assert((shmem_msg.getDataBuf() == NULL) == (shmem_msg.getDataLength() == 0));
+
+   // Messages to this tile do not see a synchronization delay (see sendMsg())
+   vector<tile_id_t> remote_receivers;
+   remote_receivers.reserve(receivers.size());
+   for (UInt32 i = 0; i < receivers.size(); i++)
+   {
+      if (receivers[i] == getTile()->getId())
+         sendMsg(receivers[i], shmem_msg);
+      else
+         remote_receivers.push_back(receivers[i]);
+   }
+   if (remote_receivers.empty())
+      return;
+
+   Byte* msg_buf = shmem_msg.makeMsgBuf();
+   Time msg_time = getShmemPerfModel()->getCurrTime();
+
+   TRACE_EVENT(MEMORY_MSG_MULTICAST, getTile()->getId(), msg_time.toNanosec(),
+               shmem_msg.getType(), shmem_msg.getAddress(), remote_receivers.size());
+
+   NetPacket packet(msg_time, SHARED_MEM,
+         getTile()->getId(), NetPacket::MULTICAST,
+         shmem_msg.getMsgLen(), (const void*) msg_buf);
+   getNetwork()->netMulticast(DVFSManager::convertToModule(shmem_msg.getSenderMemComponent()), packet, remote_receivers);
+
+   // Delete the Msg Buf
+   delete [] msg_buf;
+}
+
 void
 MemoryManager::incrCurrTime(MemComponent::Type mem_component, CachePerfModel::AccessType access_type)
 {
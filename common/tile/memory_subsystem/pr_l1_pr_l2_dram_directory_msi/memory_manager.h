@@ -36,6 +36,7 @@ namespace PrL1PrL2DramDirectoryMSI
       // Send/Broadcast msg
       void sendMsg(tile_id_t receiver, ShmemMsg& msg);
       void broadcastMsg(ShmemMsg& msg);
+      void multicastMsg(const vector<tile_id_t>& receivers, ShmemMsg& msg);
      
       void enableModels();
       void disableModels();
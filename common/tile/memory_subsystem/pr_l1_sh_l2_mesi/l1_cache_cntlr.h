@@ -93,7 +93,13 @@ namespace PrL1ShL2MESI
       Cache* getL1Cache(MemComponent::Type mem_component);
       ShmemMsg::Type getShmemMsgType(Core::mem_op_t mem_op_type);
 
+      // Direct execution: passes a request straight to the L2 cache of this tile
+      // if it can answer right away (returns false otherwise)
+      bool processMsgFromCoreInline(ShmemMsg* shmem_msg);
+      CacheState::Type getCacheLineStateWithoutCounters(MemComponent::Type mem_component, IntPtr address);
+
       // Specific msg handling
+      void processMsgFromL2Cache(tile_id_t sender, ShmemMsg* shmem_msg);
       void processExRepFromL2Cache(tile_id_t sender, ShmemMsg* shmem_msg);
       void processShRepFromL2Cache(tile_id_t sender, ShmemMsg* shmem_msg);
       void processUpgradeRepFromL2Cache(tile_id_t sender, ShmemMsg* shmem_msg);
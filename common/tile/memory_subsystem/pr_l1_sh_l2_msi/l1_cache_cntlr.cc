@@ -2,6 +2,7 @@
 #include "memory_manager.h"
 #include "config.h"
 #include "log.h"
+#include "event_tracer.h"
 
 namespace PrL1ShL2MSI
 {
@@ -85,10 +86,11 @@ L1CacheCntlr::processMemOpFromCore(MemComponent::Type mem_component,
                                    Byte* data_buf, UInt32 data_length,
                                    bool modeled)
 {
-   LOG_PRINT("processMemOpFromCore(), lock_signal(%u), mem_op_type(%u), ca_address(%#llx)",
-             lock_signal, mem_op_type, ca_address);
+   TRACE_EVENT(MEMORY_OP_FROM_CORE, getTileId(), getShmemPerfModel()->getCurrTime().toNanosec(),
+               lock_signal, mem_op_type, ca_address);
 
    bool L1_cache_hit = true;
+   bool processed_inline = false;
    UInt32 access_num = 0;
 
    // Core synchronization delay
@@ -100,7 +102,7 @@ L1CacheCntlr::processMemOpFromCore(MemComponent::Type mem_component,
       LOG_ASSERT_ERROR((access_num == 1) || (access_num == 2), "access_num(%u)", access_num);
 
       // Wake up the sim thread after acquiring the lock
-      if (access_num == 2)
+      if ((access_num == 2) && !processed_inline)
       {
          _memory_manager->wakeUpSimThread();
       }
@@ -133,6 +135,14 @@ L1CacheCntlr::processMemOpFromCore(MemComponent::Type mem_component,
       ShmemMsg shmem_msg(shmem_msg_type, MemComponent::CORE, mem_component,
                          getTileId(), false, ca_address,
                          msg_modeled);
+
+      // With direct execution, the L2 cache of this tile may answer on this thread
+      if (_memory_manager->isDirectExecutionEnabled() && processMsgFromCoreInline(&shmem_msg))
+      {
+         processed_inline = true;
+         continue;
+      }
+
       _memory_manager->sendMsg(getTileId(), shmem_msg);
 
       // Wait for the sim thread
@@ -301,8 +311,73 @@ L1CacheCntlr::handleMsgFromCore(ShmemMsg* shmem_msg)
    _memory_manager->sendMsg(receiver, send_shmem_msg);
 }
 
+bool
+L1CacheCntlr::processMsgFromCoreInline(ShmemMsg* shmem_msg)
+{
+   IntPtr address = shmem_msg->getAddress();
+   if (getL2CacheHome(address) != getTileId())
+      return false;
+
+   // The requester is a sharer only on an upgrade miss. Any other copy in the L1 caches
+   // would need a message between them and the L2 cache first.
+   CacheState::Type L1_icache_cstate = getCacheLineStateWithoutCounters(MemComponent::L1_ICACHE, address);
+   CacheState::Type L1_dcache_cstate = getCacheLineStateWithoutCounters(MemComponent::L1_DCACHE, address);
+   bool requester_is_sharer;
+   if ((L1_icache_cstate == CacheState::INVALID) && (L1_dcache_cstate == CacheState::INVALID))
+      requester_is_sharer = false;
+   else if ((shmem_msg->getType() == ShmemMsg::EX_REQ) &&
+            (L1_icache_cstate == CacheState::INVALID) && (L1_dcache_cstate == CacheState::SHARED))
+      requester_is_sharer = true;
+   else
+      return false;
+
+   // The msg handleMsgFromCore() would send to the L2 cache
+   ShmemMsg L2_shmem_msg(shmem_msg->getType(), shmem_msg->getReceiverMemComponent(), MemComponent::L2_CACHE,
+                         shmem_msg->getRequester(), false, address,
+                         shmem_msg->isModeled());
+   L2CacheCntlr* L2_cache_cntlr = _memory_manager->getL2CacheCntlr();
+   if (!L2_cache_cntlr->canProcessReqInline(&L2_shmem_msg, requester_is_sharer))
+      return false;
+
+   _outstanding_shmem_msg = *shmem_msg;
+   _outstanding_shmem_msg_time = getShmemPerfModel()->getCurrTime();
+
+   // Msgs between the caches of one tile have no network latency, so the time
+   // is the same as if they had been handled on the sim thread
+   Time reply_time;
+   ShmemMsg* reply_shmem_msg = L2_cache_cntlr->processReqInline(&L2_shmem_msg, reply_time);
+   getShmemPerfModel()->setCurrTime(reply_time);
+   processMsgFromL2Cache(getTileId(), reply_shmem_msg);
+
+   if (reply_shmem_msg->getDataLength() > 0)
+      delete [] reply_shmem_msg->getDataBuf();
+   delete reply_shmem_msg;
+   return true;
+}
+
+CacheState::Type
+L1CacheCntlr::getCacheLineStateWithoutCounters(MemComponent::Type mem_component, IntPtr address)
+{
+   CacheLineInfo* L1_cache_line_info = getL1Cache(mem_component)->peekCacheLineInfo(address);
+   return L1_cache_line_info ? L1_cache_line_info->getCState() : CacheState::INVALID;
+}
+
 void
 L1CacheCntlr::handleMsgFromL2Cache(tile_id_t sender, ShmemMsg* shmem_msg)
+{
+   processMsgFromL2Cache(sender, shmem_msg);
+
+   ShmemMsg::Type shmem_msg_type = shmem_msg->getType();
+   if ((shmem_msg_type == ShmemMsg::EX_REP) || (shmem_msg_type == ShmemMsg::SH_REP) || (shmem_msg_type == ShmemMsg::UPGRADE_REP))
+   {
+      // Wake up the app thread and wait for it to complete one memory operation 
+      _memory_manager->wakeUpAppThread();
+      _memory_manager->waitForAppThread();
+   }
+}
+
+void
+L1CacheCntlr::processMsgFromL2Cache(tile_id_t sender, ShmemMsg* shmem_msg)
 {
    // L2 Cache synchronization delay 
    if (sender == getTileId())
@@ -354,10 +429,6 @@ L1CacheCntlr::handleMsgFromL2Cache(tile_id_t sender, ShmemMsg* shmem_msg)
 
       // There are no more outstanding memory requests
       _outstanding_shmem_msg = ShmemMsg();
-     
-      // Wake up the app thread and wait for it to complete one memory operation 
-      _memory_manager->wakeUpAppThread();
-      _memory_manager->waitForAppThread();
    }
 }
 
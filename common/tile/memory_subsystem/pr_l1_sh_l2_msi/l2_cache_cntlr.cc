@@ -27,6 +27,8 @@ L2CacheCntlr::L2CacheCntlr(MemoryManager* memory_manager,
    : _memory_manager(memory_manager)
    , _dram_home_lookup(dram_home_lookup)
    , _enabled(false)
+   , _processing_req_inline(false)
+   , _inline_reply(NULL)
 {
    _L2_cache_replacement_policy_obj =
       new L2CacheReplacementPolicy(L2_cache_size, L2_cache_associativity, cache_line_size, _L2_cache_req_queue);
@@ -275,6 +277,72 @@ L2CacheCntlr::handleMsgFromL1Cache(tile_id_t sender, ShmemMsg* shmem_msg)
    }
 }
 
+bool
+L2CacheCntlr::canProcessReqInline(ShmemMsg* shmem_msg, bool requester_is_sharer)
+{
+   IntPtr address = shmem_msg->getAddress();
+   tile_id_t requester = shmem_msg->getRequester();
+   MemComponent::Type requester_mem_component = shmem_msg->getSenderMemComponent();
+
+   // No other request for the line may be in progress
+   if (!_L2_cache_req_queue.empty(address))
+      return false;
+
+   // The line and its data must be in the L2 cache (without updating the cache counters)
+   ShL2CacheLineInfo* L2_cache_line_info = (ShL2CacheLineInfo*) _L2_cache->peekCacheLineInfo(address);
+   if (!L2_cache_line_info ||
+       (L2_cache_line_info->getCState() == CacheState::INVALID) ||
+       (L2_cache_line_info->getCState() == CacheState::DATA_INVALID))
+      return false;
+
+   // The sharers must be tracked exactly, and the directory must agree with the L1 caches
+   // of the requester, i.e., none of their evictions of the line is still on its way here
+   DirectoryEntry* directory_entry = L2_cache_line_info->getDirectoryEntry();
+   if (directory_entry->inBroadcastMode() || (directory_entry->hasSharer(requester) != requester_is_sharer))
+      return false;
+
+   switch (directory_entry->getDirectoryBlockInfo()->getDState())
+   {
+   case DirectoryState::UNCACHED:
+      return true;
+
+   case DirectoryState::SHARED:
+      if (L2_cache_line_info->getCachingComponent() != requester_mem_component)
+         return false;
+      if (shmem_msg->getType() == ShmemMsg::EX_REQ)
+      {
+         // Upgrade miss
+         return requester_is_sharer && (directory_entry->getNumSharers() == 1);
+      }
+      else // (shmem_msg->getType() == ShmemMsg::SH_REQ)
+      {
+         // No sharer has to be invalidated to make room for the requester
+         return (L2DirectoryCfg::getDirectoryType() != LIMITED_NO_BROADCAST) ||
+                (directory_entry->getNumSharers() < L2DirectoryCfg::getMaxHWSharers());
+      }
+
+   default:
+      // The owner has to be flushed first
+      return false;
+   }
+}
+
+ShmemMsg*
+L2CacheCntlr::processReqInline(ShmemMsg* shmem_msg, Time& reply_time)
+{
+   // Exactly as the message would be handled on the sim thread
+   _processing_req_inline = true;
+   handleMsgFromL1Cache(getTileId(), shmem_msg);
+   _processing_req_inline = false;
+
+   LOG_ASSERT_ERROR(_inline_reply, "Request(%u) for address(%#lx) not answered right away",
+                    shmem_msg->getType(), shmem_msg->getAddress());
+   ShmemMsg* reply = _inline_reply;
+   reply_time = _inline_reply_time;
+   _inline_reply = NULL;
+   return reply;
+}
+
 void
 L2CacheCntlr::handleMsgFromDram(tile_id_t sender, ShmemMsg* shmem_msg)
 {
@@ -499,7 +567,7 @@ L2CacheCntlr::processExReqFromL1Cache(ShmemReq* shmem_req, Byte* data_buf, bool
                ShmemMsg shmem_msg(ShmemMsg::UPGRADE_REP, MemComponent::L2_CACHE, MemComponent::L1_DCACHE,
                                   requester, false, address,
                                   msg_modeled);
-               _memory_manager->sendMsg(requester, shmem_msg);
+               sendReplyToL1Cache(requester, shmem_msg);
                
                // Set completed to true
                completed = true;
@@ -865,13 +933,28 @@ L2CacheCntlr::sendInvalidationMsg(ShmemMsg::Type requester_msg_type,
    else // not all tiles are sharers
    {
       // Send Invalidation Request to only a specific set of sharers
-      for (UInt32 i = 0; i < sharers_list.size(); i++)
-      {
-         ShmemMsg shmem_msg(ShmemMsg::INV_REQ, MemComponent::L2_CACHE, receiver_mem_component,
-                            requester, false, address,
-                            msg_modeled);
-         _memory_manager->sendMsg(sharers_list[i], shmem_msg);
-      }
+      ShmemMsg shmem_msg(ShmemMsg::INV_REQ, MemComponent::L2_CACHE, receiver_mem_component,
+                         requester, false, address,
+                         msg_modeled);
+      _memory_manager->multicastMsg(sharers_list, shmem_msg);
+   }
+}
+
+void
+L2CacheCntlr::sendReplyToL1Cache(tile_id_t requester, ShmemMsg& shmem_msg)
+{
+   if (_processing_req_inline)
+   {
+      // Passed to the L1 cache as if it had gone through the network
+      assert(requester == getTileId() && !_inline_reply);
+      Byte* msg_buf = shmem_msg.makeMsgBuf();
+      _inline_reply = ShmemMsg::getShmemMsg(msg_buf);
+      _inline_reply_time = getShmemPerfModel()->getCurrTime();
+      delete [] msg_buf;
+   }
+   else
+   {
+      _memory_manager->sendMsg(requester, shmem_msg);
    }
 }
 
@@ -888,7 +971,7 @@ L2CacheCntlr::readCacheLineAndSendToL1Cache(ShmemMsg::Type reply_msg_type,
                          requester, false, address, 
                          data_buf, getCacheLineSize(),
                          msg_modeled);
-      _memory_manager->sendMsg(requester, shmem_msg);
+      sendReplyToL1Cache(requester, shmem_msg);
    }
    else
    {
@@ -900,7 +983,7 @@ L2CacheCntlr::readCacheLineAndSendToL1Cache(ShmemMsg::Type reply_msg_type,
                          requester, false, address,
                          L2_data_buf, getCacheLineSize(),
                          msg_modeled);
-      _memory_manager->sendMsg(requester, shmem_msg); 
+      sendReplyToL1Cache(requester, shmem_msg);
    }
 }
 
@@ -46,6 +46,12 @@ namespace PrL1ShL2MSI
       void handleMsgFromL1Cache(tile_id_t sender, ShmemMsg* shmem_msg);
       // Handle message from Dram 
       void handleMsgFromDram(tile_id_t sender, ShmemMsg* shmem_msg);
+
+      // Direct execution: a request of the L1 caches of this tile that can be
+      // answered right away is processed on the app thread, and the reply is
+      // returned instead of sent (with the time it would have been sent at)
+      bool canProcessReqInline(ShmemMsg* shmem_msg, bool requester_is_sharer);
+      ShmemMsg* processReqInline(ShmemMsg* shmem_msg, Time& reply_time);
       // Output summary
       void outputSummary(ostream& out);
 
@@ -68,6 +74,11 @@ namespace PrL1ShL2MSI
       // Evicted cache line map
       map<IntPtr,ShL2CacheLineInfo> _evicted_cache_line_map;
 
+      // Reply to the request processed on the app thread
+      bool _processing_req_inline;
+      ShmemMsg* _inline_reply;
+      Time _inline_reply_time;
+
       // L2 cache operations
       void getCacheLineInfo(IntPtr address, ShL2CacheLineInfo* L2_cache_line_info,
                             ShmemMsg::Type shmem_msg_type, bool update_miss_counters = false);
@@ -96,6 +107,8 @@ namespace PrL1ShL2MSI
                                IntPtr address, MemComponent::Type receiver_mem_component,
                                bool all_tiles_sharers, vector<tile_id_t>& sharers_list,
                                tile_id_t requester, bool msg_modeled);
+      // Send a reply to a request of an L1-I/L1-D cache
+      void sendReplyToL1Cache(tile_id_t requester, ShmemMsg& shmem_msg);
       // Read data from L2 cache and send to L1-I/L1-D cache
       void readCacheLineAndSendToL1Cache(ShmemMsg::Type reply_msg_type,
                                          IntPtr address, MemComponent::Type requester_mem_component,
@@ -31,11 +31,13 @@ namespace PrL1ShL2MSI
       Cache* getL1ICache() { return _L1_cache_cntlr->getL1ICache(); }
       Cache* getL1DCache() { return _L1_cache_cntlr->getL1DCache(); }
       Cache* getL2Cache() { return _L2_cache_cntlr->getL2Cache(); }
+      L2CacheCntlr* getL2CacheCntlr() { return _L2_cache_cntlr; }
       DramCntlr* getDramCntlr() { return _dram_cntlr; }
       bool isDramCntlrPresent() { return _dram_cntlr_present; }
       
       void sendMsg(tile_id_t receiver, ShmemMsg& shmem_msg);
       void broadcastMsg(ShmemMsg& shmem_msg);
+      void multicastMsg(const vector<tile_id_t>& receivers, ShmemMsg& shmem_msg);
     
       void enableModels();
       void disableModels();
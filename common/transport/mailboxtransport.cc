@@ -0,0 +1,399 @@
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <limits.h>
+
+#include "mailboxtransport.h"
+#include "simulator.h"
+#include "config.h"
+#include "log.h"
+
+static inline void cpuRelax()
+{
+   __asm__ __volatile__("rep; nop" : : : "memory");
+}
+
+// -- MailboxTransport -- //
+
+MailboxTransport::MailboxTransport()
+{
+   LOG_ASSERT_ERROR(Config::getSingleton()->getProcessCount() == 1,
+                    "Can only use MailboxTransport with a single process.");
+
+   Config::getSingleton()->setProcessNum(0);
+
+   m_ring_size = Sim()->getCfg()->getInt("transport/mailbox_ring_size", DEFAULT_RING_SIZE);
+   LOG_ASSERT_ERROR(m_ring_size > 0 && (m_ring_size & (m_ring_size - 1)) == 0,
+                    "transport/mailbox_ring_size(%u) must be a power of 2", m_ring_size);
+
+   m_num_tiles = Config::getSingleton()->getTotalTiles();
+
+   m_mailboxes = new Mailbox* [m_num_tiles + 1];
+   for (UInt32 i = 0; i < m_num_tiles + 1; i++)
+      m_mailboxes[i] = new Mailbox(m_ring_size);
+   m_pools = new BufferPool[m_num_tiles + 1];
+
+   m_global_node = new MailboxNode(-1, this);
+}
+
+MailboxTransport::~MailboxTransport()
+{
+   // The networks delete the Transport::Nodes of the tiles
+   delete m_global_node;
+
+   for (UInt32 i = 0; i < m_num_tiles + 1; i++)
+      delete m_mailboxes[i];
+   delete [] m_mailboxes;
+   delete [] m_pools;
+}
+
+Transport::Node* MailboxTransport::createNode(tile_id_t tile_id)
+{
+   LOG_ASSERT_ERROR(0 <= tile_id && (UInt32) tile_id < m_num_tiles,
+                    "Request index out of range: %d", tile_id);
+   return new MailboxNode(tile_id, this);
+}
+
+void MailboxTransport::barrier()
+{
+   // We assume a single process, so this is a NOOP
+}
+
+Transport::Node* MailboxTransport::getGlobalNode()
+{
+   return m_global_node;
+}
+
+MailboxTransport::Mailbox* MailboxTransport::getMailbox(tile_id_t tile_id)
+{
+   if (tile_id == -1)
+      return m_mailboxes[m_num_tiles];
+
+   LOG_ASSERT_ERROR(0 <= tile_id && (UInt32) tile_id < m_num_tiles,
+                    "Tile id out of range: %d", tile_id);
+   return m_mailboxes[tile_id];
+}
+
+// -- MailboxTransport::MailboxNode -- //
+
+MailboxTransport::MailboxNode::MailboxNode(tile_id_t tile_id, MailboxTransport *trans)
+   : Node(tile_id)
+   , m_transport(trans)
+   , m_mailbox(trans->getMailbox(tile_id))
+   , m_pool(&trans->m_pools[(tile_id == -1) ? trans->m_num_tiles : (UInt32) tile_id])
+   , m_spin_count(MIN_SPIN_COUNT)
+{
+}
+
+MailboxTransport::MailboxNode::~MailboxNode()
+{
+   LOG_ASSERT_WARNING(m_mailbox->empty(), "Unread messages in mailbox for tile: %d", getTileId());
+}
+
+void MailboxTransport::MailboxNode::globalSend(SInt32 dest_proc, const void *buffer, UInt32 length)
+{
+   LOG_ASSERT_ERROR(dest_proc == 0, "Destination other than zero: %d", dest_proc);
+   send(m_transport->getMailbox(-1), buffer, length);
+}
+
+void MailboxTransport::MailboxNode::send(tile_id_t dest_tile, const void *buffer, UInt32 length)
+{
+   send(m_transport->getMailbox(dest_tile), buffer, length);
+}
+
+void MailboxTransport::MailboxNode::send(Mailbox *mailbox, const void *buffer, UInt32 length)
+{
+   Byte *data = m_pool->allocate(length);
+   memcpy(data, buffer, length);
+
+   LOG_PRINT("sending msg -- size: %i, data: %p, dest: %p", length, data, mailbox);
+
+   mailbox->push(data);
+}
+
+Byte* MailboxTransport::MailboxNode::recv()
+{
+   LOG_PRINT("attempting recv -- this: %p", this);
+
+   Byte *data = m_mailbox->pop(m_spin_count);
+
+   LOG_PRINT("msg recv'd -- data: %p, this: %p", data, this);
+
+   return data;
+}
+
+bool MailboxTransport::MailboxNode::query()
+{
+   return !m_mailbox->empty();
+}
+
+void MailboxTransport::MailboxNode::releaseBuffer(Byte *buffer)
+{
+   BufferPool::release(buffer);
+}
+
+// -- MailboxTransport::Ring -- //
+
+MailboxTransport::Ring::Ring(UInt32 size)
+   : m_cells(new Cell[size])
+   , m_mask(size - 1)
+   , m_enqueue_pos(0)
+   , m_dequeue_pos(0)
+{
+   for (UInt32 i = 0; i < size; i++)
+   {
+      m_cells[i].sequence = i;
+      m_cells[i].buffer = NULL;
+   }
+}
+
+MailboxTransport::Ring::~Ring()
+{
+   delete [] m_cells;
+}
+
+bool MailboxTransport::Ring::push(Byte *buffer)
+{
+   Cell *cell;
+   UInt64 pos = m_enqueue_pos;
+
+   while (true)
+   {
+      cell = &m_cells[pos & m_mask];
+      SInt64 diff = (SInt64) cell->sequence - (SInt64) pos;
+
+      if (diff == 0)
+      {
+         if (__sync_bool_compare_and_swap(&m_enqueue_pos, pos, pos + 1))
+            break;
+         pos = m_enqueue_pos;
+      }
+      else if (diff < 0)
+      {
+         // full
+         return false;
+      }
+      else
+      {
+         pos = m_enqueue_pos;
+      }
+   }
+
+   cell->buffer = buffer;
+   __sync_synchronize();
+   cell->sequence = pos + 1;
+   return true;
+}
+
+Byte* MailboxTransport::Ring::pop()
+{
+   Cell *cell;
+   UInt64 pos = m_dequeue_pos;
+
+   while (true)
+   {
+      cell = &m_cells[pos & m_mask];
+      SInt64 diff = (SInt64) cell->sequence - (SInt64) (pos + 1);
+
+      if (diff == 0)
+      {
+         if (__sync_bool_compare_and_swap(&m_dequeue_pos, pos, pos + 1))
+            break;
+         pos = m_dequeue_pos;
+      }
+      else if (diff < 0)
+      {
+         // empty
+         return NULL;
+      }
+      else
+      {
+         pos = m_dequeue_pos;
+      }
+   }
+
+   Byte *buffer = cell->buffer;
+   __sync_synchronize();
+   cell->sequence = pos + m_mask + 1;
+   return buffer;
+}
+
+bool MailboxTransport::Ring::empty()
+{
+   // The head cell has not been published by a producer yet
+   UInt64 pos = m_dequeue_pos;
+   return (m_cells[pos & m_mask].sequence != pos + 1);
+}
+
+// -- MailboxTransport::Mailbox -- //
+
+MailboxTransport::Mailbox::Mailbox(UInt32 ring_size)
+   : m_ring(ring_size)
+   , m_overflow_count(0)
+   , m_futx(0)
+   , m_num_waiting(0)
+{
+}
+
+MailboxTransport::Mailbox::~Mailbox()
+{
+   Byte *buffer;
+   while ((buffer = tryPop()) != NULL)
+      BufferPool::release(buffer);
+}
+
+void MailboxTransport::Mailbox::push(Byte *buffer)
+{
+   // Once anything has spilled over, keep using the overflow list until it
+   // drains so that packets from one sender stay in order
+   if ((m_overflow_count > 0) || !m_ring.push(buffer))
+   {
+      ScopedLock sl(m_overflow_lock);
+      m_overflow.push_back(buffer);
+      __sync_fetch_and_add(&m_overflow_count, 1);
+   }
+
+   // The push must be visible before we look for sleeping receivers
+   __sync_synchronize();
+
+   if (m_num_waiting > 0)
+   {
+      __sync_fetch_and_add(&m_futx, 1);
+      syscall(SYS_futex, (void*) &m_futx, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+   }
+}
+
+Byte* MailboxTransport::Mailbox::tryPop()
+{
+   Byte *buffer = m_ring.pop();
+   if ((buffer == NULL) && (m_overflow_count > 0))
+   {
+      ScopedLock sl(m_overflow_lock);
+      if (!m_overflow.empty())
+      {
+         buffer = m_overflow.front();
+         m_overflow.pop_front();
+         __sync_fetch_and_sub(&m_overflow_count, 1);
+      }
+   }
+   return buffer;
+}
+
+Byte* MailboxTransport::Mailbox::pop(UInt32 &spin_count)
+{
+   Byte *buffer = tryPop();
+   if (buffer)
+      return buffer;
+
+   // Spin for a while; a packet that shows up in this window saves a pair
+   // of futex calls, so spin longer next time. Otherwise spin less.
+   for (UInt32 i = 0; i < spin_count; i++)
+   {
+      cpuRelax();
+      buffer = tryPop();
+      if (buffer)
+      {
+         spin_count = (spin_count * 2 < MAX_SPIN_COUNT) ? spin_count * 2 : MAX_SPIN_COUNT;
+         return buffer;
+      }
+   }
+   spin_count = (spin_count / 2 > MIN_SPIN_COUNT) ? spin_count / 2 : MIN_SPIN_COUNT;
+
+   while (true)
+   {
+      SInt32 futx = m_futx;
+      __sync_fetch_and_add(&m_num_waiting, 1);
+
+      // Re-check after announcing ourselves, senders only wake us up if
+      // they can see m_num_waiting
+      buffer = tryPop();
+      if (buffer == NULL)
+         syscall(SYS_futex, (void*) &m_futx, FUTEX_WAIT, futx, NULL, NULL, 0);
+
+      __sync_fetch_and_sub(&m_num_waiting, 1);
+
+      if (buffer || (buffer = tryPop()))
+         return buffer;
+   }
+}
+
+bool MailboxTransport::Mailbox::empty()
+{
+   return (m_ring.empty() && (m_overflow_count == 0));
+}
+
+// -- MailboxTransport::BufferPool -- //
+
+MailboxTransport::BufferPool::BufferPool()
+{
+   for (UInt32 i = 0; i < NUM_CLASSES; i++)
+   {
+      m_free_lists[i] = NULL;
+      m_num_free[i] = 0;
+   }
+}
+
+MailboxTransport::BufferPool::~BufferPool()
+{
+   for (UInt32 i = 0; i < NUM_CLASSES; i++)
+   {
+      while (m_free_lists[i])
+      {
+         Header *header = m_free_lists[i];
+         m_free_lists[i] = header->next;
+         delete [] (Byte*) header;
+      }
+   }
+}
+
+Byte* MailboxTransport::BufferPool::allocate(UInt32 length)
+{
+   UInt32 size_class = 0;
+   while ((size_class < NUM_CLASSES) && ((1U << (size_class + MIN_CLASS_SHIFT)) < length))
+      size_class ++;
+
+   Header *header = NULL;
+   if (size_class < NUM_CLASSES)
+   {
+      ScopedLock sl(m_locks[size_class]);
+      header = m_free_lists[size_class];
+      if (header)
+      {
+         m_free_lists[size_class] = header->next;
+         m_num_free[size_class] --;
+      }
+   }
+
+   if (header == NULL)
+   {
+      UInt32 capacity = (size_class < NUM_CLASSES) ? (1U << (size_class + MIN_CLASS_SHIFT)) : length;
+      header = (Header*) new Byte[sizeof(Header) + capacity];
+      header->pool = this;
+      header->size_class = size_class;
+   }
+
+   header->next = NULL;
+   return (Byte*) (header + 1);
+}
+
+void MailboxTransport::BufferPool::release(Byte *buffer)
+{
+   Header *header = ((Header*) buffer) - 1;
+   BufferPool *pool = header->pool;
+   UInt32 size_class = header->size_class;
+
+   if (size_class < NUM_CLASSES)
+   {
+      ScopedLock sl(pool->m_locks[size_class]);
+      if (pool->m_num_free[size_class] < MAX_FREE_BUFFERS)
+      {
+         header->next = pool->m_free_lists[size_class];
+         pool->m_free_lists[size_class] = header;
+         pool->m_num_free[size_class] ++;
+         return;
+      }
+   }
+
+   delete [] (Byte*) header;
+}
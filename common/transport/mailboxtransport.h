@@ -0,0 +1,154 @@
+#ifndef MAILBOX_TRANSPORT_H
+#define MAILBOX_TRANSPORT_H
+
+#include <list>
+
+#include "transport.h"
+#include "lock.h"
+
+// Transport for single-process simulations (transport/type = mailbox).
+//
+// Every tile, and the global node, owns a mailbox: a bounded lock-free
+// multi-producer ring of buffer pointers. When a ring fills up, senders
+// fall back to a locked overflow list instead of blocking, so two tiles
+// that flood each other cannot deadlock. A receiver spins on its mailbox
+// for a while before sleeping on a futex; the spin budget adapts to how
+// often spinning actually paid off.
+//
+// Packet buffers come from per-node pools, and are handed back through
+// Node::releaseBuffer() once the receiver is done with them.
+
+class MailboxTransport : public Transport
+{
+public:
+   MailboxTransport();
+   ~MailboxTransport();
+
+private:
+   class Mailbox;
+   class BufferPool;
+
+public:
+   class MailboxNode : public Node
+   {
+   public:
+      MailboxNode(tile_id_t tile_id, MailboxTransport *trans);
+      ~MailboxNode();
+
+      void globalSend(SInt32 dest_proc, const void *buffer, UInt32 length);
+      void send(tile_id_t dest_tile, const void *buffer, UInt32 length);
+      Byte* recv();
+      bool query();
+      void releaseBuffer(Byte *buffer);
+
+   private:
+      void send(Mailbox *mailbox, const void *buffer, UInt32 length);
+
+      MailboxTransport *m_transport;
+      Mailbox *m_mailbox;
+      BufferPool *m_pool;
+      UInt32 m_spin_count;
+   };
+
+   Node* createNode(tile_id_t tile_id);
+
+   void barrier();
+   Node* getGlobalNode();
+
+private:
+   static const UInt32 DEFAULT_RING_SIZE = 256;
+   static const UInt32 MIN_SPIN_COUNT = 16;
+   static const UInt32 MAX_SPIN_COUNT = 4096;
+
+   // Lock-free ring used by a single mailbox. This is the bounded
+   // multi-producer/multi-consumer queue by D. Vyukov: every cell carries a
+   // sequence number that tells producers and consumers whether it is theirs.
+   class Ring
+   {
+   public:
+      Ring(UInt32 size);
+      ~Ring();
+
+      bool push(Byte *buffer);
+      Byte* pop();
+      bool empty();
+
+   private:
+      struct Cell
+      {
+         volatile UInt64 sequence;
+         Byte *buffer;
+      };
+
+      Cell *m_cells;
+      UInt64 m_mask;
+      // Producers and consumers update these from different threads, so
+      // keep them on separate cache lines
+      volatile UInt64 m_enqueue_pos;
+      char m_padding[64 - sizeof(UInt64)];
+      volatile UInt64 m_dequeue_pos;
+   };
+
+   class Mailbox
+   {
+   public:
+      Mailbox(UInt32 ring_size);
+      ~Mailbox();
+
+      void push(Byte *buffer);
+      Byte* tryPop();
+      Byte* pop(UInt32 &spin_count);
+      bool empty();
+
+   private:
+      Ring m_ring;
+
+      Lock m_overflow_lock;
+      std::list<Byte*> m_overflow;
+      volatile SInt32 m_overflow_count;
+
+      volatile SInt32 m_futx;
+      volatile SInt32 m_num_waiting;
+   };
+
+   class BufferPool
+   {
+   public:
+      BufferPool();
+      ~BufferPool();
+
+      Byte* allocate(UInt32 length);
+      static void release(Byte *buffer);
+
+   private:
+      // Size classes of 64 bytes to 8 kB; larger buffers are not pooled
+      static const UInt32 MIN_CLASS_SHIFT = 6;
+      static const UInt32 NUM_CLASSES = 8;
+      static const UInt32 MAX_FREE_BUFFERS = 1024;
+
+      // Precedes the data of every buffer handed out
+      struct Header
+      {
+         BufferPool *pool;
+         Header *next;
+         UInt32 size_class;
+         UInt32 padding;
+      };
+
+      Lock m_locks[NUM_CLASSES];
+      Header *m_free_lists[NUM_CLASSES];
+      UInt32 m_num_free[NUM_CLASSES];
+   };
+
+   Mailbox* getMailbox(tile_id_t tile_id);
+
+   UInt32 m_num_tiles;
+   UInt32 m_ring_size;
+   // Index m_num_tiles is the global node. Pools belong to the transport
+   // rather than the nodes, since buffers can outlive their sender's node.
+   Mailbox **m_mailboxes;
+   BufferPool *m_pools;
+   Node *m_global_node;
+};
+
+#endif // MAILBOX_TRANSPORT_H
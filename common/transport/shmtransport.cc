@@ -0,0 +1,556 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <limits.h>
+#include <netdb.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <algorithm>
+
+#include "log.h"
+#include "config.h"
+#include "simulator.h" //interface to config file singleton
+#include "shmtransport.h"
+
+using std::string;
+
+ShmTransport::ShmTransport()
+   : m_update_thread_state(RUNNING)
+{
+   getProcInfo();
+   initSegment();
+   initBufferLists();
+
+   m_update_thread = Thread::create(updateThreadFunc, this);
+   m_update_thread->run();
+
+   m_global_node = new ShmNode(GLOBAL_TAG, this);
+}
+
+bool ShmTransport::isSingleHost()
+{
+   SInt32 num_procs = (SInt32) Config::getSingleton()->getProcessCount();
+   string first_addr;
+
+   for (SInt32 proc = 0; proc < num_procs; proc++)
+   {
+      string server_addr = getProcessAddress(proc);
+      struct hostent *host = gethostbyname(server_addr.c_str());
+      if (host == NULL)
+         return false;
+
+      string addr(host->h_addr_list[0], host->h_length);
+      if (proc == 0)
+         first_addr = addr;
+      else if (addr != first_addr)
+         return false;
+   }
+
+   return true;
+}
+
+const char* ShmTransport::getRunId()
+{
+   return getenv("CARBON_RUN_ID");
+}
+
+void ShmTransport::getProcInfo()
+{
+   m_num_procs = (SInt32)Config::getSingleton()->getProcessCount();
+
+   const char *proc_index_str = getenv("CARBON_PROCESS_INDEX");
+   LOG_ASSERT_ERROR(proc_index_str != NULL || m_num_procs == 1,
+                    "Process index undefined with multiple processes.");
+
+   if (proc_index_str)
+      m_proc_index = atoi(proc_index_str);
+   else
+      m_proc_index = 0;
+
+   LOG_ASSERT_ERROR(0 <= m_proc_index && m_proc_index < m_num_procs,
+                    "Invalid process index: %d with num_procs: %d", m_proc_index, m_num_procs);
+
+   Config::getSingleton()->setProcessNum(m_proc_index);
+   LOG_PRINT("Process number set to %i", Config::getSingleton()->getCurrentProcessNum());
+}
+
+void ShmTransport::initSegment()
+{
+   LOG_PRINT("initSegment()");
+
+   m_ring_size = Sim()->getCfg()->getInt("transport/shm_ring_size", DEFAULT_RING_SIZE);
+   LOG_ASSERT_ERROR(m_ring_size >= 4096 && (m_ring_size & (m_ring_size - 1)) == 0,
+                    "transport/shm_ring_size(%u) must be a power of 2, at least 4096", m_ring_size);
+
+   // The segment is named after the run (set by tools/spawn_master.py), so
+   // that a segment left behind by a crashed run is never attached to
+   m_segment_name = string("/carbon_transport_") + getRunId();
+
+   // Layout: SegmentHeader, a Doorbell per process, a RingHeader per pair
+   // of processes, then the data of the rings
+   UInt64 num_rings = m_num_procs * m_num_procs;
+   UInt64 doorbells_offset = sizeof(SegmentHeader);
+   UInt64 ring_headers_offset = doorbells_offset + m_num_procs * sizeof(Doorbell);
+   UInt64 ring_data_offset = ring_headers_offset + num_rings * sizeof(RingHeader);
+   m_segment_size = ring_data_offset + num_rings * m_ring_size;
+
+   // Process 0 creates the segment, the others wait for it to show up with
+   // its final size
+   SInt32 fd;
+   if (m_proc_index == 0)
+   {
+      fd = shm_open(m_segment_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+      LOG_ASSERT_ERROR(fd >= 0, "Failed to create shared memory segment %s: errno(%d)", m_segment_name.c_str(), errno);
+      __attribute__((unused)) SInt32 err = ftruncate(fd, m_segment_size);
+      LOG_ASSERT_ERROR(err >= 0, "Failed to size shared memory segment to %llu bytes: errno(%d)", m_segment_size, errno);
+   }
+   else
+   {
+      while ((fd = shm_open(m_segment_name.c_str(), O_RDWR, 0)) < 0)
+         sched_yield();
+
+      struct stat st;
+      while ((fstat(fd, &st) < 0) || ((UInt64) st.st_size < m_segment_size))
+         sched_yield();
+   }
+
+   void *segment = mmap(NULL, m_segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   LOG_ASSERT_ERROR(segment != MAP_FAILED, "Failed to map shared memory segment: errno(%d)", errno);
+   ::close(fd);
+
+   m_segment = (Byte*) segment;
+   m_segment_header = (SegmentHeader*) m_segment;
+
+   if (m_proc_index == 0)
+   {
+      m_segment_header->m_num_procs = m_num_procs;
+      m_segment_header->m_ring_size = m_ring_size;
+      __sync_synchronize();
+      m_segment_header->m_initialized = 1;
+   }
+   else
+   {
+      while (!m_segment_header->m_initialized)
+         sched_yield();
+      LOG_ASSERT_ERROR(m_segment_header->m_num_procs == (UInt32) m_num_procs && m_segment_header->m_ring_size == m_ring_size,
+                       "Shared memory segment set up for %u processes, %u byte rings",
+                       m_segment_header->m_num_procs, m_segment_header->m_ring_size);
+   }
+
+   // Once everyone is attached, the name can go: the segment is freed when
+   // the last process unmaps it, even if the simulation crashes
+   __sync_fetch_and_add(&m_segment_header->m_num_attached, 1);
+   while (m_segment_header->m_num_attached < (UInt32) m_num_procs)
+      sched_yield();
+   if (m_proc_index == 0)
+      shm_unlink(m_segment_name.c_str());
+
+   m_doorbells = (Doorbell*) (m_segment + doorbells_offset);
+
+   // Ring i * num_procs + j carries the packets from process i to process j
+   RingHeader *ring_headers = (RingHeader*) (m_segment + ring_headers_offset);
+   m_send_rings = new Ring[m_num_procs];
+   m_send_locks = new Lock[m_num_procs];
+   m_recv_rings = new Ring[m_num_procs];
+   m_recv_buffers = new RecvBuffer[m_num_procs];
+
+   for (SInt32 proc = 0; proc < m_num_procs; proc++)
+   {
+      UInt64 send_ring = m_proc_index * m_num_procs + proc;
+      m_send_rings[proc].m_header = &ring_headers[send_ring];
+      m_send_rings[proc].m_data = m_segment + ring_data_offset + send_ring * m_ring_size;
+
+      UInt64 recv_ring = proc * m_num_procs + m_proc_index;
+      m_recv_rings[proc].m_header = &ring_headers[recv_ring];
+      m_recv_rings[proc].m_data = m_segment + ring_data_offset + recv_ring * m_ring_size;
+
+      m_recv_buffers[proc].m_size = RECV_BUFFER_SIZE;
+      m_recv_buffers[proc].m_data = new Byte[RECV_BUFFER_SIZE];
+   }
+}
+
+void ShmTransport::initBufferLists()
+{
+   m_num_lists
+      = Config::getSingleton()->getTotalTiles() // for tiles
+      + 1; // for global node
+
+   m_buffer_lists = new buffer_list[m_num_lists];
+   m_buffer_list_locks = new Lock[m_num_lists];
+   m_buffer_list_sems = new Semaphore[m_num_lists];
+}
+
+void ShmTransport::updateThreadFunc(void *vp)
+{
+   LOG_PRINT("Starting updateThreadFunc");
+
+   ShmTransport *st = (ShmTransport*)vp;
+
+   st->updateBufferLists();
+
+   st->m_update_thread_state = EXITED;
+
+   LOG_PRINT("Leaving updateThreadFunc");
+}
+
+void ShmTransport::updateBufferLists()
+{
+   Doorbell &doorbell = m_doorbells[m_proc_index];
+   UInt32 idle_count = 0;
+
+   while (m_update_thread_state == RUNNING)
+   {
+      bool received = false;
+      for (SInt32 proc = 0; proc < m_num_procs; proc++)
+      {
+         if (proc != m_proc_index)
+            received |= receivePackets(proc);
+      }
+
+      if (received)
+      {
+         idle_count = 0;
+         continue;
+      }
+
+      // Packets often come in bursts, look again for a while before sleeping
+      if (++idle_count < SPIN_COUNT)
+      {
+         sched_yield();
+         continue;
+      }
+
+      // A sender publishes its packet before bumping the sequence, so either
+      // the packet shows up below or the futex does not sleep
+      doorbell.m_waiting = 1;
+      __sync_synchronize();
+      SInt32 sequence = doorbell.m_sequence;
+      if (!hasPendingPackets() && m_update_thread_state == RUNNING)
+         syscall(SYS_futex, (void*) &doorbell.m_sequence, FUTEX_WAIT, sequence, NULL, NULL, 0);
+      doorbell.m_waiting = 0;
+      idle_count = 0;
+   }
+}
+
+bool ShmTransport::hasPendingPackets()
+{
+   for (SInt32 proc = 0; proc < m_num_procs; proc++)
+   {
+      RingHeader *header = m_recv_rings[proc].m_header;
+      if ((proc != m_proc_index) && (header->m_head != header->m_tail))
+         return true;
+   }
+   return false;
+}
+
+bool ShmTransport::receivePackets(SInt32 proc)
+{
+   RingHeader *ring_header = m_recv_rings[proc].m_header;
+   Byte *ring_data = m_recv_rings[proc].m_data;
+   RecvBuffer &recv_buffer = m_recv_buffers[proc];
+
+   UInt64 tail = ring_header->m_tail;
+   UInt64 head = ring_header->m_head;
+   if (head == tail)
+      return false;
+
+   // Read the bytes only after seeing the head that covers them
+   __sync_synchronize();
+
+   while (tail != head)
+   {
+      // Move the partial packet at the end of the buffer to its beginning
+      if (recv_buffer.m_end == recv_buffer.m_size)
+      {
+         memmove(recv_buffer.m_data, recv_buffer.m_data + recv_buffer.m_start, recv_buffer.m_end - recv_buffer.m_start);
+         recv_buffer.m_end -= recv_buffer.m_start;
+         recv_buffer.m_start = 0;
+      }
+
+      // The bytes may wrap around the end of the ring
+      UInt64 offset = tail & (m_ring_size - 1);
+      UInt64 length = head - tail;
+      length = std::min<UInt64>(length, m_ring_size - offset);
+      length = std::min<UInt64>(length, recv_buffer.m_size - recv_buffer.m_end);
+
+      memcpy(recv_buffer.m_data + recv_buffer.m_end, ring_data + offset, length);
+      recv_buffer.m_end += length;
+      tail += length;
+
+      // Hand the space back to the sender only once it has been copied
+      __sync_synchronize();
+      ring_header->m_tail = tail;
+
+      // Hand out all the complete packets
+      while (recv_buffer.m_end - recv_buffer.m_start >= sizeof(PacketHeader))
+      {
+         PacketHeader header;
+         memcpy(&header, recv_buffer.m_data + recv_buffer.m_start, sizeof(header));
+
+         UInt32 pkt_len = sizeof(header) + header.length;
+         if (recv_buffer.m_end - recv_buffer.m_start < pkt_len)
+         {
+            // Wait for the rest, in a buffer large enough to hold it
+            if (pkt_len > recv_buffer.m_size)
+            {
+               Byte *data = new Byte[pkt_len];
+               memcpy(data, recv_buffer.m_data + recv_buffer.m_start, recv_buffer.m_end - recv_buffer.m_start);
+               delete [] recv_buffer.m_data;
+               recv_buffer.m_data = data;
+               recv_buffer.m_size = pkt_len;
+               recv_buffer.m_end -= recv_buffer.m_start;
+               recv_buffer.m_start = 0;
+            }
+            break;
+         }
+
+         Byte *buffer = new Byte[header.length];
+         memcpy(buffer, recv_buffer.m_data + recv_buffer.m_start + sizeof(header), header.length);
+         recv_buffer.m_start += pkt_len;
+
+         insertInBufferList(header.tag, buffer);
+      }
+
+      if (recv_buffer.m_start == recv_buffer.m_end)
+      {
+         recv_buffer.m_start = 0;
+         recv_buffer.m_end = 0;
+      }
+   }
+
+   return true;
+}
+
+void ShmTransport::insertInBufferList(SInt32 tag, Byte *buffer)
+{
+   if (tag == GLOBAL_TAG)
+      tag = m_num_lists - 1;
+
+   LOG_ASSERT_ERROR(0 <= tag && tag < m_num_lists, "Unexpected tag value: %d", tag);
+   m_buffer_list_locks[tag].acquire();
+   m_buffer_lists[tag].push_back(buffer);
+   m_buffer_list_locks[tag].release();
+
+   m_buffer_list_sems[tag].signal();
+}
+
+void ShmTransport::ringDoorbell(SInt32 proc)
+{
+   Doorbell &doorbell = m_doorbells[proc];
+   __sync_fetch_and_add(&doorbell.m_sequence, 1);
+   if (doorbell.m_waiting)
+      syscall(SYS_futex, (void*) &doorbell.m_sequence, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+void ShmTransport::terminateUpdateThread()
+{
+   LOG_PRINT("Stopping update thread.");
+
+   m_update_thread_state = EXITING;
+   ringDoorbell(m_proc_index);
+
+   while (m_update_thread_state != EXITED)
+      sched_yield();
+
+   LOG_PRINT("Quit.");
+}
+
+ShmTransport::~ShmTransport()
+{
+   LOG_PRINT("dtor");
+
+   delete m_global_node;
+
+   terminateUpdateThread();
+   delete m_update_thread;
+
+   delete [] m_buffer_list_sems;
+   delete [] m_buffer_list_locks;
+   delete [] m_buffer_lists;
+
+   for (SInt32 i = 0; i < m_num_procs; i++)
+      delete [] m_recv_buffers[i].m_data;
+
+   delete [] m_recv_buffers;
+   delete [] m_recv_rings;
+   delete [] m_send_locks;
+   delete [] m_send_rings;
+
+   munmap(m_segment, m_segment_size);
+}
+
+Transport::Node* ShmTransport::createNode(tile_id_t tile_id)
+{
+   return new ShmNode(tile_id, this);
+}
+
+void ShmTransport::barrier()
+{
+   LOG_PRINT("Entering transport barrier");
+
+   SegmentHeader *header = m_segment_header;
+
+   // The last process to arrive starts a new generation, which releases
+   // the others
+   SInt32 generation = header->m_barrier_generation;
+   if (__sync_add_and_fetch(&header->m_barrier_count, 1) == (UInt32) m_num_procs)
+   {
+      header->m_barrier_count = 0;
+      __sync_fetch_and_add(&header->m_barrier_generation, 1);
+      syscall(SYS_futex, (void*) &header->m_barrier_generation, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+   }
+   else
+   {
+      while (header->m_barrier_generation == generation)
+         syscall(SYS_futex, (void*) &header->m_barrier_generation, FUTEX_WAIT, generation, NULL, NULL, 0);
+   }
+
+   LOG_PRINT("Exiting transport barrier");
+}
+
+Transport::Node* ShmTransport::getGlobalNode()
+{
+   return m_global_node;
+}
+
+void ShmTransport::sendPacket(SInt32 dest_proc, SInt32 tag, const void *buffer, UInt32 length)
+{
+   PacketHeader header;
+   header.length = length;
+   header.tag = tag;
+
+   // The ring has a single producer: the threads of this process take turns
+   m_send_locks[dest_proc].acquire();
+   writeToRing(dest_proc, &header, sizeof(header));
+   writeToRing(dest_proc, buffer, length);
+   m_send_locks[dest_proc].release();
+
+   ringDoorbell(dest_proc);
+}
+
+void ShmTransport::writeToRing(SInt32 dest_proc, const void *buffer, UInt32 length)
+{
+   Ring &ring = m_send_rings[dest_proc];
+   RingHeader *ring_header = ring.m_header;
+   const Byte *data = (const Byte*) buffer;
+   UInt64 head = ring_header->m_head;
+
+   while (length > 0)
+   {
+      UInt64 space = m_ring_size - (head - ring_header->m_tail);
+      if (space == 0)
+      {
+         // Packets larger than the ring go through in pieces, make sure
+         // the receiver is awake to drain it
+         ringDoorbell(dest_proc);
+         sched_yield();
+         continue;
+      }
+
+      // Fill the space up to the end of the ring, then wrap around
+      UInt64 offset = head & (m_ring_size - 1);
+      UInt64 chunk = std::min<UInt64>(length, std::min<UInt64>(space, m_ring_size - offset));
+      memcpy(ring.m_data + offset, data, chunk);
+      data += chunk;
+      length -= chunk;
+      head += chunk;
+
+      // The bytes have to be in place before the receiver can see them
+      __sync_synchronize();
+      ring_header->m_head = head;
+   }
+}
+
+// -- ShmTransport::ShmNode
+
+ShmTransport::ShmNode::ShmNode(tile_id_t tile_id, ShmTransport *trans)
+   : Node(tile_id)
+   , m_transport(trans)
+{
+}
+
+ShmTransport::ShmNode::~ShmNode()
+{
+}
+
+void ShmTransport::ShmNode::globalSend(SInt32 dest_proc,
+                                       const void *buffer,
+                                       UInt32 length)
+{
+   send(dest_proc, GLOBAL_TAG, buffer, length);
+}
+
+void ShmTransport::ShmNode::send(tile_id_t dest_tile,
+                                 const void *buffer,
+                                 UInt32 length)
+{
+   int dest_proc = Config::getSingleton()->getProcessNumForTile(dest_tile);
+   send(dest_proc, dest_tile, buffer, length);
+}
+
+Byte* ShmTransport::ShmNode::recv()
+{
+   LOG_PRINT("Entering recv");
+
+   tile_id_t tag = getTileId();
+   tag = (tag == GLOBAL_TAG) ? m_transport->m_num_lists - 1 : tag;
+
+   m_transport->m_buffer_list_sems[tag].wait();
+
+   Lock &lock = m_transport->m_buffer_list_locks[tag];
+   lock.acquire();
+
+   buffer_list &list = m_transport->m_buffer_lists[tag];
+   LOG_ASSERT_ERROR(!list.empty(), "Buffer list empty after waiting on semaphore.");
+   Byte* buffer = list.front();
+   list.pop_front();
+
+   lock.release();
+
+   LOG_PRINT("Message recv'd");
+
+   return buffer;
+}
+
+bool ShmTransport::ShmNode::query()
+{
+   tile_id_t tag = getTileId();
+   tag = (tag == GLOBAL_TAG) ? m_transport->m_num_lists - 1 : tag;
+
+   buffer_list &list = m_transport->m_buffer_lists[tag];
+   Lock &lock = m_transport->m_buffer_list_locks[tag];
+
+   lock.acquire();
+   bool result = !list.empty();
+   lock.release();
+   return result;
+}
+
+void ShmTransport::ShmNode::send(SInt32 dest_proc,
+                                 SInt32 tag,
+                                 const void *buffer,
+                                 UInt32 length)
+{
+   // two cases:
+   // (1) remote process, use its ring
+   // (2) same process, put directly in buffer list
+
+   if (dest_proc == m_transport->m_proc_index)
+   {
+      Byte *buff_cpy = new Byte[length];
+      memcpy(buff_cpy, buffer, length);
+      m_transport->insertInBufferList(tag, buff_cpy);
+   }
+   else
+   {
+      m_transport->sendPacket(dest_proc, tag, buffer, length);
+   }
+
+   LOG_PRINT("Message sent.");
+}
@@ -0,0 +1,166 @@
+#ifndef SHM_TRANSPORT_H
+#define SHM_TRANSPORT_H
+
+#include "transport.h"
+#include "thread.h"
+#include "semaphore.h"
+#include "lock.h"
+
+#include <list>
+#include <string>
+
+// Transport for multi-process simulations whose processes all run on one
+// host. Transport::create() picks it instead of SockTransport when all the
+// entries of [process_map] resolve to the same address, and the launcher
+// has given the run an ID (CARBON_RUN_ID) to name the segment after.
+//
+// The processes share one POSIX shared memory segment holding a byte ring
+// for every (sender, receiver) pair of processes. A ring has a single
+// producer (the threads of the sending process take turns on a local lock)
+// and a single consumer (the update thread of the receiving process), so
+// it only needs the head/tail counters. Packets are streamed through it
+// like through a socket: Length, Tag, Data.
+//
+// The update thread of a process polls its incoming rings, and sleeps on
+// the process' doorbell (a futex in the segment) when they stay empty.
+// Senders ring the doorbell after every packet, which costs a syscall only
+// when the receiver is asleep. barrier() is a counting barrier in the
+// segment.
+
+class ShmTransport : public Transport
+{
+public:
+   ShmTransport();
+   ~ShmTransport();
+
+   // Are all the processes on the same host?
+   static bool isSingleHost();
+   // Run the processes share, NULL if they were not started by the launcher
+   static const char* getRunId();
+
+   class ShmNode : public Node
+   {
+   public:
+      ShmNode(tile_id_t tile_id, ShmTransport *trans);
+      ~ShmNode();
+
+      void globalSend(SInt32 dest_proc, const void *buffer, UInt32 length);
+      void send(tile_id_t dest_tile, const void *buffer, UInt32 length);
+      Byte* recv();
+      bool query();
+
+   private:
+      void send(SInt32 dest_proc, SInt32 tag, const void *buffer, UInt32 length);
+
+      ShmTransport *m_transport;
+   };
+
+   Node *createNode(tile_id_t tile_id);
+
+   void barrier();
+   Node *getGlobalNode();
+
+private:
+   struct PacketHeader
+   {
+      UInt32 length;
+      SInt32 tag;
+   } __attribute__((packed));
+
+   // -- In the shared memory segment
+
+   struct SegmentHeader
+   {
+      UInt32 m_num_procs;
+      UInt32 m_ring_size;
+      volatile UInt32 m_initialized;
+      volatile UInt32 m_num_attached;
+      volatile UInt32 m_barrier_count;
+      volatile SInt32 m_barrier_generation;   // futex
+   } __attribute__((aligned(64)));
+
+   struct Doorbell
+   {
+      volatile SInt32 m_sequence;   // futex, bumped by the senders
+      volatile SInt32 m_waiting;    // the receiver is (about to go) asleep
+   } __attribute__((aligned(64)));
+
+   struct RingHeader
+   {
+      volatile UInt64 m_head __attribute__((aligned(64)));   // bytes written
+      volatile UInt64 m_tail __attribute__((aligned(64)));   // bytes read
+   };
+
+   // -- Local to the process
+
+   struct Ring
+   {
+      RingHeader *m_header;
+      Byte *m_data;
+   };
+
+   // Same as SockTransport::RecvBuffer
+   struct RecvBuffer
+   {
+      RecvBuffer() : m_data(NULL), m_size(0), m_start(0), m_end(0) {}
+
+      Byte *m_data;
+      UInt32 m_size;
+      UInt32 m_start;
+      UInt32 m_end;
+   };
+
+   enum UpdateThreadState
+   {
+      RUNNING,
+      EXITING,
+      EXITED
+   };
+
+   static const SInt32 GLOBAL_TAG = -1;
+   static const UInt32 DEFAULT_RING_SIZE = 1 << 20;
+   static const UInt32 RECV_BUFFER_SIZE = 1 << 20;
+   static const UInt32 SPIN_COUNT = 1000;
+
+   Node *m_global_node;
+
+   SInt32 m_num_procs;
+   SInt32 m_proc_index;
+
+   std::string m_segment_name;
+   Byte *m_segment;
+   UInt64 m_segment_size;
+   SegmentHeader *m_segment_header;
+   UInt32 m_ring_size;
+   Doorbell *m_doorbells;
+   Ring *m_send_rings;           // to every process
+   Lock *m_send_locks;
+   Ring *m_recv_rings;           // from every process
+   RecvBuffer *m_recv_buffers;
+
+   Thread *m_update_thread;
+   volatile UpdateThreadState m_update_thread_state;
+
+   typedef std::list<Byte*> buffer_list;
+   SInt32 m_num_lists;
+   buffer_list *m_buffer_lists;
+   Lock *m_buffer_list_locks;
+   Semaphore *m_buffer_list_sems;
+
+   void getProcInfo();
+   void initSegment();
+   void initBufferLists();
+   void insertInBufferList(SInt32 tag, Byte *buffer);
+
+   void sendPacket(SInt32 dest_proc, SInt32 tag, const void *buffer, UInt32 length);
+   void writeToRing(SInt32 dest_proc, const void *buffer, UInt32 length);
+   void ringDoorbell(SInt32 proc);
+
+   static void updateThreadFunc(void *vp);
+   void updateBufferLists();
+   bool receivePackets(SInt32 proc);
+   bool hasPendingPackets();
+   void terminateUpdateThread();
+};
+
+#endif // SHM_TRANSPORT_H
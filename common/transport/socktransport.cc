@@ -9,6 +9,9 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <sched.h>
+#include <limits.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
 
 #include "log.h"
 #include "config.h"
@@ -70,25 +73,11 @@ void SockTransport::initSockets()
 
    // -- client side
    m_send_sockets = new Socket[m_num_procs];
-   m_send_locks = new Lock[m_num_procs];
+   m_send_queues = new SendQueue[m_num_procs];
 
    for (SInt32 proc = 0; proc < m_num_procs; proc++)
    {
-      // Look up the mapping in the config file to find the address for this
-      // particular process.
-      char proc_str[8];
-      snprintf(proc_str, 8, "%d", proc);
-      string server_string = "process_map/process";
-      server_string += proc_str;
-      string server_addr = "";
-      try
-      {
-          server_addr = Sim()->getCfg()->getString(server_string, "127.0.0.1");
-      } catch (...)
-      {
-          LOG_ASSERT_ERROR(false, "Key: %s not found in config!", server_string.c_str());
-      }
-
+      string server_addr = getProcessAddress(proc);
       m_send_sockets[proc].connect(server_addr.c_str(), m_base_port + proc);
 
       m_send_sockets[proc].send(&m_proc_index, sizeof(m_proc_index));
@@ -96,7 +85,10 @@ void SockTransport::initSockets()
 
    // -- accept connections
    m_recv_sockets = new Socket[m_num_procs];
-   m_recv_locks = new Lock[m_num_procs];
+   m_recv_buffers = new RecvBuffer[m_num_procs];
+
+   m_epoll_fd = epoll_create(m_num_procs);
+   LOG_ASSERT_ERROR(m_epoll_fd >= 0, "Failed to create epoll instance.");
 
    for (SInt32 proc = 0; proc < m_num_procs; proc++)
    {
@@ -110,6 +102,17 @@ void SockTransport::initSockets()
                        proc_index);
 
       m_recv_sockets[proc_index] = sock;
+      m_recv_sockets[proc_index].setNonBlocking();
+
+      m_recv_buffers[proc_index].m_size = RECV_BUFFER_SIZE;
+      m_recv_buffers[proc_index].m_data = new Byte[RECV_BUFFER_SIZE];
+
+      struct epoll_event event;
+      memset(&event, 0, sizeof(event));
+      event.events = EPOLLIN;
+      event.data.u32 = proc_index;
+      __attribute__((unused)) SInt32 err = epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, sock.getFD(), &event);
+      LOG_ASSERT_ERROR(err >= 0, "Failed to add socket(%d) to epoll instance.", sock.getFD());
    }
 }
 
@@ -135,11 +138,7 @@ void SockTransport::updateThreadFunc(void *vp)
 
    SockTransport *st = (SockTransport*)vp;
 
-   while (st->m_update_thread_state == RUNNING)
-   {
-      st->updateBufferLists();
-      sched_yield();
-   }
+   st->updateBufferLists();
 
    st->m_update_thread_state = EXITED;
 
@@ -148,71 +147,139 @@ void SockTransport::updateThreadFunc(void *vp)
 
 void SockTransport::updateBufferLists()
 {
-   for (SInt32 i = 0; i < m_num_procs; i++)
+   std::vector<struct epoll_event> events(m_num_procs);
+
+   // Sleep until packets arrive, the terminate message comes from this process
+   while (m_update_thread_state == RUNNING)
    {
-      while (true)
+      SInt32 num_events = epoll_wait(m_epoll_fd, &events[0], m_num_procs, -1);
+      if (num_events < 0)
       {
-         UInt32 length;
+         LOG_ASSERT_ERROR(errno == EINTR, "epoll_wait failed: errno(%d)", errno);
+         continue;
+      }
 
-         m_recv_locks[i].acquire();
+      for (SInt32 i = 0; i < num_events; i++)
+      {
+         if (!receivePackets(events[i].data.u32))
+            return;
+      }
+   }
+}
 
-         // first get packet length, abort if none available
-         if (!m_recv_sockets[i].recv(&length, sizeof(length), false))
-         {
-            m_recv_locks[i].release();
-            break;
-         }
+bool SockTransport::receivePackets(SInt32 proc)
+{
+   RecvBuffer &recv_buffer = m_recv_buffers[proc];
+
+   while (true)
+   {
+      // Move the partial packet at the end of the buffer to its beginning
+      if (recv_buffer.m_end == recv_buffer.m_size)
+      {
+         memmove(recv_buffer.m_data, recv_buffer.m_data + recv_buffer.m_start, recv_buffer.m_end - recv_buffer.m_start);
+         recv_buffer.m_end -= recv_buffer.m_start;
+         recv_buffer.m_start = 0;
+      }
 
-         // now receive tag
-         SInt32 tag;
-         m_recv_sockets[i].recv(&tag, sizeof(tag), true);
+      SInt32 recvd = ::recv(m_recv_sockets[proc].getFD(), recv_buffer.m_data + recv_buffer.m_end,
+                            recv_buffer.m_size - recv_buffer.m_end, 0);
+      if (recvd == 0)
+      {
+         // Process exited, stop watching its socket
+         epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, m_recv_sockets[proc].getFD(), NULL);
+         return true;
+      }
+      else if (recvd < 0)
+      {
+         if (errno == EINTR)
+            continue;
+         LOG_ASSERT_ERROR(errno == EAGAIN || errno == EWOULDBLOCK, "Error on socket(%i): errno(%d)",
+                          m_recv_sockets[proc].getFD(), errno);
+         return true;
+      }
+      recv_buffer.m_end += recvd;
 
-         // now receive packet
-         Byte *buffer = new Byte[length];
-         m_recv_sockets[i].recv(buffer, length, true);
+      // Hand out all the complete packets
+      while (recv_buffer.m_end - recv_buffer.m_start >= sizeof(PacketHeader))
+      {
+         PacketHeader header;
+         memcpy(&header, recv_buffer.m_data + recv_buffer.m_start, sizeof(header));
 
+         UInt32 pkt_len = sizeof(header) + header.length;
 #ifdef __CHECKSUM_ENABLED__
-         // now receive checksum
-         UInt64 checksum = 0;
-         if ((tag != TERMINATE_TAG) && (tag != BARRIER_TAG))
+         if ((header.tag != TERMINATE_TAG) && (header.tag != BARRIER_TAG))
+            pkt_len += sizeof(UInt64);
+#endif // __CHECKSUM_ENABLED__
+
+         if (recv_buffer.m_end - recv_buffer.m_start < pkt_len)
          {
-            m_recv_sockets[i].recv(&checksum, sizeof(checksum), true);
+            // Wait for the rest, in a buffer large enough to hold it
+            if (pkt_len > recv_buffer.m_size)
+            {
+               Byte *data = new Byte[pkt_len];
+               memcpy(data, recv_buffer.m_data + recv_buffer.m_start, recv_buffer.m_end - recv_buffer.m_start);
+               delete [] recv_buffer.m_data;
+               recv_buffer.m_data = data;
+               recv_buffer.m_size = pkt_len;
+               recv_buffer.m_end -= recv_buffer.m_start;
+               recv_buffer.m_start = 0;
+            }
+            break;
          }
-#endif // __CHECKSUM_ENABLED__
 
-         m_recv_locks[i].release();
+         Byte *buffer = new Byte[header.length];
+         memcpy(buffer, recv_buffer.m_data + recv_buffer.m_start + sizeof(header), header.length);
 
-         switch (tag)
-         {
-         case TERMINATE_TAG:
-            LOG_PRINT("Quit message received.");
-            LOG_ASSERT_ERROR(m_update_thread_state == RUNNING, "Terminate received in unexpected state: %d", m_update_thread_state);
-            LOG_ASSERT_ERROR(i == m_proc_index, "Terminate received from unexpected process: %d != %d", i, m_proc_index);
-            m_update_thread_state = EXITING;
+         UInt64 checksum = 0;
+#ifdef __CHECKSUM_ENABLED__
+         if ((header.tag != TERMINATE_TAG) && (header.tag != BARRIER_TAG))
+            memcpy(&checksum, recv_buffer.m_data + recv_buffer.m_start + sizeof(header) + header.length, sizeof(checksum));
+#endif // __CHECKSUM_ENABLED__
 
-            delete [] buffer;
-            return;
+         recv_buffer.m_start += pkt_len;
 
-         case BARRIER_TAG:
-            m_barrier_sem.signal();
-            LOG_ASSERT_ERROR(i == (m_proc_index + m_num_procs - 1) % m_num_procs,
-                             "Barrier update from unexpected process: %d", i);
-            delete [] buffer;
-            break;
+         if (!handlePacket(proc, header.tag, buffer, header.length, checksum))
+            return false;
+      }
+
+      if (recv_buffer.m_start == recv_buffer.m_end)
+      {
+         recv_buffer.m_start = 0;
+         recv_buffer.m_end = 0;
+      }
+   }
+}
 
-         case GLOBAL_TAG:
-         default:
+bool SockTransport::handlePacket(SInt32 proc, SInt32 tag, Byte *buffer, UInt32 length, UInt64 checksum)
+{
+   switch (tag)
+   {
+   case TERMINATE_TAG:
+      LOG_PRINT("Quit message received.");
+      LOG_ASSERT_ERROR(m_update_thread_state == RUNNING, "Terminate received in unexpected state: %d", m_update_thread_state);
+      LOG_ASSERT_ERROR(proc == m_proc_index, "Terminate received from unexpected process: %d != %d", proc, m_proc_index);
+      m_update_thread_state = EXITING;
+
+      delete [] buffer;
+      return false;
+
+   case BARRIER_TAG:
+      m_barrier_sem.signal();
+      LOG_ASSERT_ERROR(proc == (m_proc_index + m_num_procs - 1) % m_num_procs,
+                       "Barrier update from unexpected process: %d", proc);
+      delete [] buffer;
+      return true;
+
+   case GLOBAL_TAG:
+   default:
 #ifdef __CHECKSUM_ENABLED__
-            Header* header = new Header(length, checksum);
-            insertInBufferList(tag, buffer, header);
+      insertInBufferList(tag, buffer, new Header(length, checksum));
 #else
-            insertInBufferList(tag, buffer);
+      insertInBufferList(tag, buffer);
 #endif // __CHECKSUM_ENABLED__
-            // do NOT delete buffer
-            break;
-         };
-      }
-   }
+      // do NOT delete buffer
+      return true;
+   };
 }
 
 void SockTransport::insertInBufferList(SInt32 tag, Byte *buffer, Header* header)
@@ -239,8 +306,7 @@ void SockTransport::terminateUpdateThread()
 
    // include m_proc_index as a dummy message body just to avoid extra
    // code paths in updateBufferLists
-   SInt32 quit_message[] = { sizeof(m_proc_index), TERMINATE_TAG, m_proc_index };
-   m_send_sockets[m_proc_index].send(quit_message, sizeof(quit_message));
+   sendPacket(m_proc_index, TERMINATE_TAG, &m_proc_index, sizeof(m_proc_index));
 
    while (m_update_thread_state != EXITED)
       sched_yield();
@@ -270,12 +336,14 @@ SockTransport::~SockTransport()
    {
       m_recv_sockets[i].close();
       m_send_sockets[i].close();
+      delete [] m_recv_buffers[i].m_data;
    }
    m_server_socket.close();
+   ::close(m_epoll_fd);
    
-   delete [] m_recv_locks;
+   delete [] m_recv_buffers;
    delete [] m_recv_sockets;
-   delete [] m_send_locks;
+   delete [] m_send_queues;
    delete [] m_send_sockets;
 }
 
@@ -300,18 +368,18 @@ void SockTransport::barrier()
 
    LOG_PRINT("Entering transport barrier");
 
-   Socket &sock = m_send_sockets[(m_proc_index+1) % m_num_procs];
-   SInt32 message[] = { sizeof(SInt32), BARRIER_TAG, 0 };
+   SInt32 next_proc = (m_proc_index+1) % m_num_procs;
+   SInt32 message = 0;
 
    if (m_proc_index != 0)
       m_barrier_sem.wait();
 
-   sock.send(message, sizeof(message));
+   sendPacket(next_proc, BARRIER_TAG, &message, sizeof(message));
 
    m_barrier_sem.wait();
 
    if (m_proc_index != m_num_procs - 1)
-      sock.send(message, sizeof(message));
+      sendPacket(next_proc, BARRIER_TAG, &message, sizeof(message));
 
    LOG_PRINT("Exiting transport barrier");
 }
@@ -425,33 +493,78 @@ void SockTransport::SockNode::send(SInt32 dest_proc,
    }
    else
    {
-#ifdef __CHECKSUM_ENABLED__
-      SInt32 pkt_len = sizeof(length) + sizeof(tag) + length + sizeof(checksum);
-#else
-      SInt32 pkt_len = sizeof(length) + sizeof(tag) + length;
-#endif // __CHECKSUM_ENABLED__
+      m_transport->sendPacket(dest_proc, tag, buffer, length);
+   }
 
-      Byte *pkt_buff = new Byte[pkt_len];
+   LOG_PRINT("Message sent.");
+}
 
-      // Length, Tag, Data, (Checksum)
-      Packet *p = (Packet*)pkt_buff;
-      
-      p->length = length;
-      p->tag = tag;
-      memcpy(&p->data, buffer, length);
+void SockTransport::sendPacket(SInt32 dest_proc, SInt32 tag, const void *buffer, UInt32 length)
+{
+   SendRequest request;
+   request.m_header.length = length;
+   request.m_header.tag = tag;
+   request.m_data = buffer;
+   request.m_checksum = 0;
+   request.m_done = false;
 
 #ifdef __CHECKSUM_ENABLED__
-      memcpy(&p->data + length, &checksum, sizeof(checksum));
+   request.m_checksum = computeCheckSum((const Byte*) buffer, length);
 #endif // __CHECKSUM_ENABLED__
 
-      m_transport->m_send_locks[dest_proc].acquire();
-      m_transport->m_send_sockets[dest_proc].send(pkt_buff, pkt_len);
-      m_transport->m_send_locks[dest_proc].release();
+   SendQueue &queue = m_send_queues[dest_proc];
+   queue.m_lock.acquire();
+   queue.m_pending.push_back(&request);
 
-      delete [] pkt_buff;
+   // Another sender writes it out, or leaves it to us
+   while (queue.m_flushing && !request.m_done)
+      queue.m_cond.wait(queue.m_lock);
+
+   if (request.m_done)
+   {
+      queue.m_lock.release();
+      return;
    }
 
-   LOG_PRINT("Message sent.");
+   // Our packet and the ones queued up behind it so far, in one round
+   queue.m_flushing = true;
+   queue.m_batch.swap(queue.m_pending);
+   queue.m_lock.release();
+
+   queue.m_iovecs.clear();
+   for (std::vector<SendRequest*>::iterator it = queue.m_batch.begin(); it != queue.m_batch.end(); it++)
+   {
+      SendRequest *req = *it;
+      struct iovec iov;
+
+      iov.iov_base = &req->m_header;
+      iov.iov_len = sizeof(req->m_header);
+      queue.m_iovecs.push_back(iov);
+
+      iov.iov_base = const_cast<void*>(req->m_data);
+      iov.iov_len = req->m_header.length;
+      queue.m_iovecs.push_back(iov);
+
+#ifdef __CHECKSUM_ENABLED__
+      if ((req->m_header.tag != TERMINATE_TAG) && (req->m_header.tag != BARRIER_TAG))
+      {
+         iov.iov_base = &req->m_checksum;
+         iov.iov_len = sizeof(req->m_checksum);
+         queue.m_iovecs.push_back(iov);
+      }
+#endif // __CHECKSUM_ENABLED__
+   }
+   m_send_sockets[dest_proc].send(&queue.m_iovecs[0], queue.m_iovecs.size());
+
+   queue.m_lock.acquire();
+   // The senders may return (and their requests go away) from here on
+   for (std::vector<SendRequest*>::iterator it = queue.m_batch.begin(); it != queue.m_batch.end(); it++)
+      (*it)->m_done = true;
+   queue.m_batch.clear();
+   // The first of the senders that queued up meanwhile takes over
+   queue.m_flushing = false;
+   queue.m_cond.broadcast();
+   queue.m_lock.release();
 }
 
 // -- Socket
@@ -571,6 +684,38 @@ void SockTransport::Socket::send(const void* buffer, UInt32 length)
    LOG_ASSERT_ERROR(sent == SInt32(length), "Failure sending packet on socket %d -- %d != %d", m_socket, sent, length);
 }
 
+void SockTransport::Socket::send(struct iovec *iov, SInt32 iov_count)
+{
+   while (iov_count > 0)
+   {
+      SInt32 sent = ::writev(m_socket, iov, (iov_count < IOV_MAX) ? iov_count : IOV_MAX);
+      if (sent < 0)
+      {
+         LOG_ASSERT_ERROR(errno == EINTR, "Failure sending packets on socket %d -- errno(%d)", m_socket, errno);
+         continue;
+      }
+
+      // Skip what has been written, the last iovec may have been written partially
+      while ((iov_count > 0) && ((UInt32) sent >= iov->iov_len))
+      {
+         sent -= iov->iov_len;
+         iov ++;
+         iov_count --;
+      }
+      if (iov_count > 0)
+      {
+         iov->iov_base = (Byte*) iov->iov_base + sent;
+         iov->iov_len -= sent;
+      }
+   }
+}
+
+void SockTransport::Socket::setNonBlocking()
+{
+   __attribute__((unused)) SInt32 err = fcntl(m_socket, F_SETFL, fcntl(m_socket, F_GETFL) | O_NONBLOCK);
+   LOG_ASSERT_ERROR(err >= 0, "Failed to set non-blocking.");
+}
+
 bool SockTransport::Socket::recv(void *buffer, UInt32 length, bool block)
 {
    SInt32 recvd;
@@ -4,8 +4,11 @@
 #include "transport.h"
 #include "thread.h"
 #include "semaphore.h"
+#include "cond.h"
 
+#include <sys/uio.h>
 #include <list>
+#include <vector>
 
 class SockTransport : public Transport
 {
@@ -36,11 +39,11 @@ public:
    Node *getGlobalNode();
 
 private:
-   struct Packet
+   // On the wire: Length, Tag, Data, (Checksum)
+   struct PacketHeader
    {
       UInt32 length;
       SInt32 tag;
-      Byte data;
    } __attribute__((packed));
 
    struct Header
@@ -57,8 +60,12 @@ private:
    void initBufferLists();
    void insertInBufferList(SInt32 tag, Byte *buffer, Header* header = NULL);
 
+   void sendPacket(SInt32 dest_proc, SInt32 tag, const void *buffer, UInt32 length);
+
    static void updateThreadFunc(void *vp);
    void updateBufferLists();
+   bool receivePackets(SInt32 proc);
+   bool handlePacket(SInt32 proc, SInt32 tag, Byte *buffer, UInt32 length, UInt64 checksum);
    void terminateUpdateThread();
 
    class Socket
@@ -75,8 +82,12 @@ private:
       void connect(const char *addr, SInt32 port);
 
       void send(const void* buffer, UInt32 length);
+      void send(struct iovec *iov, SInt32 iov_count);
       bool recv(void *buffer, UInt32 length, bool block);
 
+      void setNonBlocking();
+      SInt32 getFD() const { return m_socket; }
+
       void close();
 
    private:
@@ -105,10 +116,53 @@ private:
 
    Semaphore m_barrier_sem;
 
+   // A packet handed to sendPacket(), until it is written out
+   struct SendRequest
+   {
+      PacketHeader m_header;
+      const void *m_data;
+      UInt64 m_checksum;
+      bool m_done;
+   };
+
+   // The first sender to find the queue of a process idle writes out its
+   // packet and those of the senders queued up behind it in one writev(),
+   // and wakes them up once their packets are out. It then leaves the
+   // packets queued meanwhile to their senders, one of which takes over, so
+   // that no sender keeps writing for others. Packets are not copied,
+   // their senders wait for them.
+   struct SendQueue
+   {
+      SendQueue() : m_flushing(false) {}
+
+      Lock m_lock;
+      ConditionVariable m_cond;
+      std::vector<SendRequest*> m_pending;
+      bool m_flushing;
+      // Owned by the flushing sender
+      std::vector<SendRequest*> m_batch;
+      std::vector<struct iovec> m_iovecs;
+   };
+
+   // Bytes received from a process, parsed into packets by the update
+   // thread. Packets that do not fit are received into a larger buffer.
+   struct RecvBuffer
+   {
+      RecvBuffer() : m_data(NULL), m_size(0), m_start(0), m_end(0) {}
+
+      Byte *m_data;
+      UInt32 m_size;
+      UInt32 m_start;
+      UInt32 m_end;
+   };
+
+   static const UInt32 RECV_BUFFER_SIZE = 1 << 20;
+
    Socket m_server_socket;
-   Lock *m_recv_locks;
    Socket *m_recv_sockets;
-   Lock *m_send_locks;
+   RecvBuffer *m_recv_buffers;
+   SInt32 m_epoll_fd;
+   SendQueue *m_send_queues;
    Socket *m_send_sockets;
 
    Thread *m_update_thread;
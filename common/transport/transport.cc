@@ -1,12 +1,16 @@
 #define TRANSPORT_CC
 
 #include <assert.h>
+#include <sstream>
 
 #include "transport.h"
 #include "smtransport.h"
 //#include "mpitransport.h"
 #include "socktransport.h"
+#include "shmtransport.h"
+#include "mailboxtransport.h"
 
+#include "simulator.h"
 #include "config.h"
 #include "log.h"
 
@@ -20,13 +24,29 @@ Transport::Transport()
 
 Transport* Transport::create()
 {
-   // dynamically choose the transport based on number of processes
-   // this is required since MPICH seems to break in single-process mode
+   // The transport is picked by transport/type in the config file.
+   // 'mailbox' is only valid for single-process simulations. With 'socket',
+   // processes that all run on one host talk through shared memory instead
+   // (unless transport/shared_memory is false, or they were not started by
+   // tools/spawn_master.py).
 
    assert(m_singleton == NULL);
 
-   if (true)
-      m_singleton = new SockTransport();
+   std::string transport_type = Sim()->getCfg()->getString("transport/type", "socket");
+
+   if (transport_type == "mailbox")
+      m_singleton = new MailboxTransport();
+
+   else if (transport_type == "socket")
+   {
+      if (Config::getSingleton()->getProcessCount() > 1 &&
+          Sim()->getCfg()->getBool("transport/shared_memory", true) &&
+          ShmTransport::getRunId() != NULL &&
+          ShmTransport::isSingleHost())
+         m_singleton = new ShmTransport();
+      else
+         m_singleton = new SockTransport();
+   }
    
    // else if (Config::getSingleton()->getProcessCount() == 1)
    //    m_singleton = new SmTransport();
@@ -35,7 +55,7 @@ Transport* Transport::create()
    //    m_singleton = new MpiTransport();
    
    else
-      LOG_PRINT_ERROR("Negative no. processes ?!");
+      LOG_PRINT_ERROR("Unrecognized transport type: %s", transport_type.c_str());
 
    return m_singleton;
 }
@@ -45,6 +65,23 @@ Transport* Transport::getSingleton()
    return m_singleton;
 }
 
+std::string Transport::getProcessAddress(SInt32 proc)
+{
+   std::ostringstream server_string;
+   server_string << "process_map/process" << proc;
+
+   std::string server_addr = "";
+   try
+   {
+      server_addr = Sim()->getCfg()->getString(server_string.str(), "127.0.0.1");
+   }
+   catch (...)
+   {
+      LOG_PRINT_ERROR("Key: %s not found in config!", server_string.str().c_str());
+   }
+   return server_addr;
+}
+
 // -- Node -- //
 
 Transport::Node::Node(tile_id_t tile_id)
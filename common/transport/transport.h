@@ -1,6 +1,8 @@
 #ifndef TRANSPORT_H
 #define TRANSPORT_H
 
+#include <string>
+
 #include "fixed_types.h"
 
 class Transport
@@ -17,6 +19,8 @@ public:
       virtual void send(tile_id_t dest, const void *buffer, UInt32 length) = 0;
       virtual Byte* recv() = 0;
       virtual bool query() = 0;
+      // Give back a buffer returned by recv()
+      virtual void releaseBuffer(Byte *buffer) { delete [] buffer; }
 
    protected:
       tile_id_t getTileId();
@@ -37,6 +41,9 @@ public:
 protected:
    Transport();
 
+   // Host of a process, from [process_map]
+   static std::string getProcessAddress(SInt32 proc);
+
 private:
    static Transport *m_singleton;
 };
@@ -4,9 +4,7 @@
 #include "tile.h"
 #include "core.h"
 #include "clock_skew_management_object.h"
-#include "hash_map.h"
-
-extern HashMap core_map;
+#include "core_map.h"
 
 static bool enabled()
 {
@@ -19,7 +17,7 @@ void handlePeriodicSync(THREADID thread_id)
    if (!Sim()->isEnabled())
       return;
 
-   Core* core = core_map.get<Core>(thread_id);
+   Core* core = core_map.get(thread_id);
    assert(core);
    if (core->getTile()->getId() >= (tile_id_t) Sim()->getConfig()->getApplicationTiles())
    {
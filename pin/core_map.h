@@ -0,0 +1,45 @@
+#ifndef __CORE_MAP_H__
+#define __CORE_MAP_H__
+
+#include <cassert>
+#include <cstring>
+
+#include "pin.H"
+#include "fixed_types.h"
+
+class Core;
+
+// Core that each application thread runs on, indexed by its Pin THREADID,
+// for the analysis routines that run on every instruction. An entry is only
+// written by its own thread (when it starts, migrates to another tile and
+// exits), and read by that same thread, so no lock is needed.
+class CoreMap
+{
+public:
+   CoreMap()
+   {
+      memset(_core_list, 0, sizeof(_core_list));
+   }
+
+   Core* get(THREADID thread_id)
+   {
+      return _core_list[thread_id];
+   }
+
+   void set(THREADID thread_id, Core* core)
+   {
+      assert(thread_id < MAX_THREADS);
+      _core_list[thread_id] = core;
+   }
+
+private:
+   // Pin numbers its threads densely from 0 and reuses the numbers of
+   // threads that have exited
+   static const UInt32 MAX_THREADS = 4096;
+
+   Core* _core_list[MAX_THREADS];
+};
+
+extern CoreMap core_map;
+
+#endif /* __CORE_MAP_H__ */
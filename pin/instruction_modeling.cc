@@ -5,27 +5,34 @@
 #include "tile.h"
 #include "core.h"
 #include "core_model.h"
-#include "hash_map.h"
+#include "core_map.h"
 #include "mcpat_core_helper.h"
 
-extern HashMap core_map;
-
 void handleInstruction(THREADID thread_id, Instruction* instruction)
 {
    if (!Sim()->isEnabled())
       return;
 
-   CoreModel *core_model = core_map.get<Core>(thread_id)->getModel();
+   CoreModel *core_model = core_map.get(thread_id)->getModel();
    core_model->queueInstruction(instruction);
    core_model->iterate();
 }
 
+void handleBasicBlock(THREADID thread_id, BasicBlock* basic_block)
+{
+   if (!Sim()->isEnabled())
+      return;
+
+   CoreModel *core_model = core_map.get(thread_id)->getModel();
+   core_model->processBasicBlock(basic_block);
+}
+
 void handleBranch(THREADID thread_id, BOOL taken, ADDRINT target)
 {
    if (!Sim()->isEnabled())
       return;
 
-   CoreModel *core_model = core_map.get<Core>(thread_id)->getModel();
+   CoreModel *core_model = core_map.get(thread_id)->getModel();
    DynamicBranchInfo info(taken, target);
    core_model->pushDynamicBranchInfo(info);
 }
@@ -347,7 +354,7 @@ InstructionType getInstructionType(INS ins)
    }
 }
 
-VOID addInstructionModeling(INS ins)
+static Instruction* createInstruction(INS ins)
 {
    RegisterOperandList read_register_operands;
    RegisterOperandList write_register_operands;
@@ -379,32 +386,86 @@ VOID addInstructionModeling(INS ins)
    {
       instruction = new BranchInstruction(INS_Opcode(ins), INS_Address(ins), INS_Size(ins), INS_IsAtomicUpdate(ins),
                                           operand_list, mcpat_instruction);
+   }
 
+   // Now handle instructions which have a static cost
+   else
+   {
+      instruction = new Instruction(instruction_type, INS_Opcode(ins),
+                                    INS_Address(ins), INS_Size(ins), INS_IsAtomicUpdate(ins),
+                                    operand_list, mcpat_instruction);
+   }
+
+   return instruction;
+}
+
+// The core model must see an instruction before the memory operations of
+// that instruction push their dynamic information, so these calls go ahead
+// of the ones inserted to redirect memory (also when they are inserted
+// from the trace instrumentation routine)
+static VOID insertInstructionCalls(INS ins, Instruction* instruction)
+{
+   if (instruction->getType() == INST_BRANCH)
+   {
       INS_InsertCall(
          ins, IPOINT_TAKEN_BRANCH, (AFUNPTR)handleBranch,
+         IARG_CALL_ORDER, CALL_ORDER_FIRST + 1,
          IARG_THREAD_ID,
          IARG_BOOL, TRUE,
          IARG_BRANCH_TARGET_ADDR,
          IARG_END);
       INS_InsertCall(
          ins, IPOINT_AFTER, (AFUNPTR)handleBranch,
+         IARG_CALL_ORDER, CALL_ORDER_FIRST + 1,
          IARG_THREAD_ID,
          IARG_BOOL, FALSE,
          IARG_BRANCH_TARGET_ADDR,
          IARG_END);
    }
 
-   // Now handle instructions which have a static cost
-   else
-   {
-      instruction = new Instruction(instruction_type, INS_Opcode(ins),
-                                    INS_Address(ins), INS_Size(ins), INS_IsAtomicUpdate(ins),
-                                    operand_list, mcpat_instruction);
-   }
-
    INS_InsertCall(ins, IPOINT_BEFORE,
                   AFUNPTR(handleInstruction),
+                  IARG_CALL_ORDER, CALL_ORDER_FIRST + 1,
                   IARG_THREAD_ID,
                   IARG_PTR, instruction,
                   IARG_END);
 }
+
+VOID addInstructionModeling(INS ins)
+{
+   insertInstructionCalls(ins, createInstruction(ins));
+}
+
+VOID addBasicBlockModeling(BBL bbl)
+{
+   // Instructions that use dynamic information (memory operands, branch
+   // outcome) are modeled one by one. The runs of instructions between
+   // them are modeled with one call per run.
+   BasicBlock* basic_block = NULL;
+
+   for (INS ins = BBL_InsHead(bbl); INS_Valid(ins); ins = INS_Next(ins))
+   {
+      Instruction* instruction = createInstruction(ins);
+
+      if ((instruction->getType() == INST_BRANCH) ||
+          (instruction->getNumReadMemoryOperands() > 0) ||
+          (instruction->getNumWriteMemoryOperands() > 0))
+      {
+         insertInstructionCalls(ins, instruction);
+         basic_block = NULL;
+         continue;
+      }
+
+      if (!basic_block)
+      {
+         basic_block = new BasicBlock();
+         INS_InsertCall(ins, IPOINT_BEFORE,
+                        AFUNPTR(handleBasicBlock),
+                        IARG_CALL_ORDER, CALL_ORDER_FIRST + 1,
+                        IARG_THREAD_ID,
+                        IARG_PTR, basic_block,
+                        IARG_END);
+      }
+      basic_block->addInstruction(instruction);
+   }
+}
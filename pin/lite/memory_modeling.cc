@@ -3,9 +3,7 @@
 #include "tile_manager.h"
 #include "tile.h"
 #include "core.h"
-#include "hash_map.h"
-
-extern HashMap core_map;
+#include "core_map.h"
 
 namespace lite
 {
@@ -63,7 +61,7 @@ void handleMemoryRead(THREADID thread_id, bool is_atomic_update, IntPtr read_add
 
    Byte read_data_buf[read_data_size];
 
-   Core* core = core_map.get<Core>(thread_id);
+   Core* core = core_map.get(thread_id);
    core->initiateMemoryAccess(MemComponent::L1_DCACHE,
          (is_atomic_update) ? Core::LOCK : Core::NONE,
          (is_atomic_update) ? Core::READ_EX : Core::READ,
@@ -78,7 +76,7 @@ void handleMemoryWrite(THREADID thread_id, bool is_atomic_update, IntPtr write_a
    if (!Sim()->isEnabled())
       return;
 
-   Core* core = core_map.get<Core>(thread_id);
+   Core* core = core_map.get(thread_id);
    core->initiateMemoryAccess(MemComponent::L1_DCACHE,
          (is_atomic_update) ? Core::UNLOCK : Core::NONE,
          Core::WRITE,
@@ -47,7 +47,7 @@
 #include "runtime_energy_monitoring.h"
 #include "redirect_memory.h"
 #include "handle_syscalls.h"
-#include "hash_map.h"
+#include "core_map.h"
 #include <typeinfo>
 
 // lite directories
@@ -71,7 +71,10 @@ extern PIN_LOCK clone_memory_update_lock;
 map <ADDRINT, string> rtn_map;
 PIN_LOCK rtn_map_lock;
 
-HashMap core_map;
+CoreMap core_map;
+
+// Model the instructions that need no dynamic information a run at a time
+bool model_basic_blocks = false;
 // ---------------------------------------------------------------
 
 void printRtn (ADDRINT rtn_addr, bool enter)
@@ -164,6 +167,13 @@ void routineCallback(RTN rtn, void *v)
    }
 }
 
+VOID traceCallback(TRACE trace, void *v)
+{
+   // Core Performance Modeling
+   for (BBL bbl = TRACE_BblHead(trace); BBL_Valid(bbl); bbl = BBL_Next(bbl))
+      addBasicBlockModeling(bbl);
+}
+
 VOID instructionCallback(INS ins, void *v)
 {
    // Debugging Function
@@ -178,8 +188,9 @@ VOID instructionCallback(INS ins, void *v)
 
    if (Config::getSingleton()->getEnableCoreModeling())
    {
-      // Core Performance Modeling
-      addInstructionModeling(ins);
+      // Core Performance Modeling (in traceCallback with model_basic_blocks)
+      if (!model_basic_blocks)
+         addInstructionModeling(ins);
 
       // Progress Trace
       addProgressTrace(ins);
@@ -368,14 +379,20 @@ VOID threadStartCallback(THREADID threadIndex, CONTEXT *ctxt, INT32 flags, VOID
       }
    }
 
-   // Initialize Tile map
-   core_map.insert(threadIndex, Sim()->getTileManager()->getCurrentCore());
+   // Initialize Core map
+   core_map.set(threadIndex, Sim()->getTileManager()->getCurrentCore());
+}
+
+// Called by an application thread that has migrated to another tile
+void threadMigrationCallback(Core* core)
+{
+   core_map.set(PIN_ThreadId(), core);
 }
 
 VOID threadFiniCallback(THREADID threadIndex, const CONTEXT *ctxt, INT32 flags, VOID *v)
 {
-   // De-initialize Tile map
-   core_map.erase(threadIndex);
+   // De-initialize Core map
+   core_map.set(threadIndex, NULL);
    
    Sim()->getThreadManager()->onThreadExit();
 }
@@ -418,6 +435,7 @@ int main(int argc, char *argv[])
    // Added thread start/fini callback
    PIN_AddThreadStartFunction(threadStartCallback, 0);
    PIN_AddThreadFiniFunction(threadFiniCallback, 0);
+   Sim()->getTileManager()->setMigrationCallback(threadMigrationCallback);
 
    // Syscall modeling   
    if (Sim()->getConfig()->getSimulationMode() == Config::FULL)
@@ -439,6 +457,11 @@ int main(int argc, char *argv[])
    else // Sim()->getConfig()->getSimulationMode() == Config::LITE
       RTN_AddInstrumentFunction(lite::routineCallback, 0);
 
+   // Add TRACE instrumentation
+   model_basic_blocks = Sim()->getCfg()->getBool("core/model_basic_blocks", false);
+   if (model_basic_blocks && Config::getSingleton()->getEnableCoreModeling())
+      TRACE_AddInstrumentFunction(traceCallback, 0);
+
    // Add INS instrumentation
    INS_AddInstrumentFunction(instructionCallback, 0);
 
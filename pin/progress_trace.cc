@@ -10,9 +10,7 @@ using std::vector;
 #include "tile.h"
 #include "core.h"
 #include "core_model.h"
-#include "hash_map.h"
-
-extern HashMap core_map;
+#include "core_map.h"
 
 static UInt64 applicationStartTime;
 static TLS_KEY threadCounterKey;
@@ -58,7 +56,7 @@ static VOID traceProgress(THREADID thread_id)
    UInt64* counter_ptr = (UInt64*) PIN_GetThreadData(threadCounterKey);
    UInt64 counter = *counter_ptr;
 
-   Core *core = core_map.get<Core>(thread_id);
+   Core *core = core_map.get(thread_id);
    CoreModel *pm = core->getModel();
 
    UInt64 curr_time = pm->getCurrTime().getTime();
@@ -0,0 +1,47 @@
+#include <cstdio>
+#include <cstdlib>
+#include "carbon_user.h"
+#include "unit_test.h"
+
+// Compute-bound loop, mostly register-only instructions. Run it with
+// --core/model_basic_blocks=true and =false to compare the host time spent
+// per simulated instruction in both modeling modes.
+
+#define NUM_ITERATIONS     20000000
+
+// Kept out of line so that the loop stays as written
+static UInt64 __attribute__((noinline)) compute(UInt64 num_iterations)
+{
+   UInt64 a = 1, b = 2, c = 3;
+   for (UInt64 i = 0; i < num_iterations; i++)
+   {
+      a += b ^ i;
+      b = (b << 1) | (c >> 63);
+      c = c * 3 + a;
+   }
+   return a ^ b ^ c;
+}
+
+int main(int argc, char* argv[])
+{
+   CarbonStartSim(argc, argv);
+   printf("Starting Basic-Block-Modeling test\n");
+
+   UInt64 start_time = getHostTime();
+   UInt64 start_sim_time = CarbonGetTime();
+   UInt64 result = compute(NUM_ITERATIONS);
+   UInt64 sim_time = CarbonGetTime() - start_sim_time;
+   UInt64 host_time = getHostTime() - start_time;
+
+   // The loop must have been modeled
+   if (sim_time < NUM_ITERATIONS)
+      testFailed("Basic-Block-Modeling", "Simulated Time(%llu ns) too short", (long long unsigned int) sim_time);
+
+   printf("Iterations: %u, Result(%llx), Simulated Time(%llu ns), Host Time(%.2f ns/iteration)\n", NUM_ITERATIONS,
+          (long long unsigned int) result, (long long unsigned int) sim_time, ((double) host_time) * 1000 / NUM_ITERATIONS);
+
+   testSucceeded("Basic-Block-Modeling");
+   CarbonStopSim();
+
+   return 0;
+}
@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <cstdlib>
+#include "fixed_types.h"
+#include "simulator.h"
+#include "config_file.hpp"
+#include "handle_args.h"
+#include "queue_model_history_btree.h"
+#include "queue_model_history_list.h"
+#include "unit_test.h"
+
+// history_btree must compute the same delays as history_list with
+// interleaving disabled. Packets arrive out of order, so that they land
+// anywhere in the free interval history.
+//
+// The simulator is not started: the test only reads the configuration, which
+// the log the queue models print to needs.
+
+#define NUM_PACKETS           100000
+#define MAX_LIST_SIZE         100
+#define MIN_PROCESSING_TIME   2
+
+int main(int argc, char* argv[])
+{
+   string_vec args;
+   std::string config_path = "carbon_sim.cfg";
+   parse_args(args, config_path, argc, argv);
+
+   config::ConfigFile cfg;
+   cfg.load(config_path);
+   handle_args(args, cfg);
+
+   Simulator::setConfig(&cfg);
+   Simulator::allocate();
+
+   printf("Starting History-BTree test\n");
+
+   QueueModelHistoryList history_list(MIN_PROCESSING_TIME, MAX_LIST_SIZE, true, false);
+   QueueModelHistoryBTree history_btree(MIN_PROCESSING_TIME, MAX_LIST_SIZE, true);
+
+   srand(1);
+   UInt64 time = 0;
+   for (SInt32 i = 0; i < NUM_PACKETS; i++)
+   {
+      time += rand() % 12;
+      UInt64 pkt_time = (time > 1000) ? (time - rand() % 1000) : time;
+      UInt64 processing_time = MIN_PROCESSING_TIME + rand() % 8;
+
+      UInt64 expected_queue_delay = history_list.computeQueueDelay(pkt_time, processing_time);
+      UInt64 queue_delay = history_btree.computeQueueDelay(pkt_time, processing_time);
+      if (queue_delay != expected_queue_delay)
+      {
+         testFailed("History-BTree", "Queue Delay: Pkt(%llu,%llu), Expected(%llu), Got(%llu)",
+                    (long long unsigned int) pkt_time,
+                    (long long unsigned int) processing_time,
+                    (long long unsigned int) expected_queue_delay,
+                    (long long unsigned int) queue_delay);
+      }
+   }
+
+   testSucceeded("History-BTree");
+   return 0;
+}
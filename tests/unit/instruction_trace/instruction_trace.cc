@@ -0,0 +1,180 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "tile.h"
+#include "core.h"
+#include "core_model.h"
+#include "mem_component.h"
+#include "tile_manager.h"
+#include "simulator.h"
+#include "config.h"
+#include "instruction_trace.h"
+
+#include "carbon_user.h"
+#include "fixed_types.h"
+#include "unit_test.h"
+
+using namespace std;
+
+// Feeds a loop of 4 instructions (ALU, load, store, branch) to the core model
+// of tile 0 the way the Pin frontend does, with instruction_trace/record set,
+// and checks that the trace reads back as the same stream.
+
+#define NUM_ITERATIONS     1000
+
+static vector<InstructionTraceReader::Event> expected_events;
+
+static Instruction* createInstruction(InstructionType type, IntPtr address,
+                                      UInt32 num_read_memory_operands, UInt32 num_write_memory_operands)
+{
+   RegisterOperandList read_register_operands(1, 1);
+   RegisterOperandList write_register_operands(1, 2);
+   ImmediateOperandList immediate_operands;
+   OperandList operand_list(read_register_operands, write_register_operands,
+                            num_read_memory_operands, num_write_memory_operands,
+                            immediate_operands);
+
+   McPATInstruction::MicroOpList micro_op_list(1, McPATInstruction::INTEGER_INST);
+   McPATInstruction::RegisterFile register_file;
+   register_file._num_integer_reads = 1;
+   register_file._num_integer_writes = 1;
+   McPATInstruction::ExecutionUnitList execution_unit_list(1, McPATInstruction::ALU);
+   McPATInstruction* mcpat_instruction = new McPATInstruction(micro_op_list, register_file, execution_unit_list);
+
+   if (type == INST_BRANCH)
+      return new BranchInstruction(0, address, 4, false, operand_list, mcpat_instruction);
+   else
+      return new Instruction(type, 0, address, 4, false, operand_list, mcpat_instruction);
+}
+
+static void handleInstruction(CoreModel* core_model, Instruction* instruction)
+{
+   core_model->queueInstruction(instruction);
+   core_model->iterate();
+
+   InstructionTraceReader::Event event;
+   event._type = InstructionTraceReader::Event::INSTRUCTION;
+   event._instruction = instruction;
+   expected_events.push_back(event);
+}
+
+static void handleMemoryAccess(Core* core, Core::mem_op_t mem_op_type, IntPtr address)
+{
+   UInt64 data = 0;
+   core->initiateMemoryAccess(MemComponent::L1_DCACHE, Core::NONE, mem_op_type,
+                              address, (Byte*) &data, sizeof(data), true);
+
+   InstructionTraceReader::Event event;
+   event._type = InstructionTraceReader::Event::MEMORY_ACCESS;
+   event._lock_signal = Core::NONE;
+   event._mem_op_type = mem_op_type;
+   event._address = address;
+   event._size = sizeof(data);
+   expected_events.push_back(event);
+}
+
+static void handleBranch(CoreModel* core_model, bool taken, IntPtr target)
+{
+   core_model->pushDynamicBranchInfo(DynamicBranchInfo(taken, target));
+
+   InstructionTraceReader::Event event;
+   event._type = InstructionTraceReader::Event::BRANCH;
+   event._taken = taken;
+   event._target = target;
+   expected_events.push_back(event);
+}
+
+static bool compareEvents(const InstructionTraceReader::Event& expected, const InstructionTraceReader::Event& event)
+{
+   if (expected._type != event._type)
+      return false;
+
+   switch (expected._type)
+   {
+   case InstructionTraceReader::Event::INSTRUCTION:
+      return (expected._instruction->getType() == event._instruction->getType()) &&
+             (expected._instruction->getAddress() == event._instruction->getAddress()) &&
+             (expected._instruction->getNumReadMemoryOperands() == event._instruction->getNumReadMemoryOperands()) &&
+             (expected._instruction->getNumWriteMemoryOperands() == event._instruction->getNumWriteMemoryOperands()) &&
+             (expected._instruction->getReadRegisterOperands() == event._instruction->getReadRegisterOperands()) &&
+             (expected._instruction->getMcPATInstruction()->getMicroOpList() ==
+              event._instruction->getMcPATInstruction()->getMicroOpList());
+
+   case InstructionTraceReader::Event::MEMORY_ACCESS:
+      return (expected._lock_signal == event._lock_signal) &&
+             (expected._mem_op_type == event._mem_op_type) &&
+             (expected._address == event._address) &&
+             (expected._size == event._size);
+
+   case InstructionTraceReader::Event::BRANCH:
+      return (expected._taken == event._taken) &&
+             (expected._target == event._target);
+
+   default:
+      return false;
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   CarbonStartSim(argc, argv);
+   Simulator::enablePerformanceModelsInCurrentProcess();
+
+   Core* core = Sim()->getTileManager()->getCurrentCore();
+   CoreModel* core_model = core->getModel();
+   if (!core_model->getInstructionTraceWriter())
+      testFailed("Instruction trace", "Run with --instruction_trace/record=true");
+
+   Instruction* alu_instruction = createInstruction(INST_IALU, 0x400000, 0, 0);
+   Instruction* load_instruction = createInstruction(INST_MOV, 0x400004, 1, 0);
+   Instruction* store_instruction = createInstruction(INST_MOV, 0x400008, 0, 1);
+   Instruction* branch_instruction = createInstruction(INST_BRANCH, 0x40000c, 0, 0);
+
+   for (UInt32 i = 0; i < NUM_ITERATIONS; i++)
+   {
+      handleInstruction(core_model, alu_instruction);
+      handleInstruction(core_model, load_instruction);
+      handleMemoryAccess(core, Core::READ, 0x10000 + ((i * 8) % 4096));
+      handleInstruction(core_model, store_instruction);
+      handleMemoryAccess(core, Core::WRITE, 0x80000 - (i * 64));
+      handleInstruction(core_model, branch_instruction);
+      handleBranch(core_model, i != (NUM_ITERATIONS - 1), 0x400000);
+   }
+
+   core_model->getInstructionTraceWriter()->flush();
+
+   bool success = true;
+   {
+      InstructionTraceReader reader(Sim()->getConfig()->formatOutputFileName("instruction_trace.0.bin"));
+      if (reader.getTileId() != 0)
+      {
+         fprintf(stderr, "*ERROR* Trace of tile(%i)\n", reader.getTileId());
+         success = false;
+      }
+
+      for (UInt32 i = 0; success && i < expected_events.size(); i++)
+      {
+         InstructionTraceReader::Event event;
+         if (!reader.next(event))
+         {
+            fprintf(stderr, "*ERROR* Trace ends after %u of %u events\n", i, (UInt32) expected_events.size());
+            success = false;
+         }
+         else if (!compareEvents(expected_events[i], event))
+         {
+            fprintf(stderr, "*ERROR* Event(%u) differs\n", i);
+            success = false;
+         }
+      }
+   }
+
+   Simulator::disablePerformanceModelsInCurrentProcess();
+   CarbonStopSim();
+
+   if (!success)
+      testFailed("Instruction trace", "The trace differs from the instruction stream");
+
+   testSucceeded("Instruction trace");
+   return 0;
+}
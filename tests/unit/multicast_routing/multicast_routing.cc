@@ -0,0 +1,142 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include "fixed_types.h"
+#include "simulator.h"
+#include "transport.h"
+#include "dvfs_manager.h"
+#include "tile.h"
+#include "network.h"
+#include "network_model.h"
+#include "network_types.h"
+#include "config.h"
+#include "config_file.hpp"
+#include "handle_args.h"
+#include "unit_test.h"
+
+// Routes multicasts to random sets of receivers along the multicast tree of
+// emesh_hop_by_hop (network/emesh_hop_by_hop/multicast_tree_enabled), through
+// all the routers of the tree as Network::forwardPacket() does with the
+// shared memory shortcut, and checks that every receiver gets the packet
+// exactly once and that no other tile gets it.
+//
+// The simulator is not started: the test only reads the configuration and
+// creates the tiles, whose networks the models are attached to.
+
+#define NUM_MULTICASTS  20000
+#define PACKET_LENGTH   64
+
+static std::vector<Tile*> tile_list;
+
+static void fail(const char* msg, SInt32 sender, UInt32 num_receivers)
+{
+   testFailed("Multicast-Routing", "%s: sender(%i), receivers(%u)", msg, sender, num_receivers);
+}
+
+// Counts the hops that reached a RECEIVE_TILE in 'num_received', per tile
+static void routePacket(std::vector<NetworkModel*>& model_list, NetPacket& pkt, std::vector<UInt32>& num_received)
+{
+   NetworkModel::HopVector hops;
+   model_list[TILE_ID(pkt.sender)]->__routePacket(pkt, hops);
+
+   for (UInt32 i = 0; i < hops.size(); i++)
+   {
+      NetworkModel::Hop hop = hops[i];
+      if ((hop._next_tile_id < 0) || (hop._next_tile_id >= (tile_id_t) model_list.size()))
+         fail("Hop leaves the mesh", TILE_ID(pkt.sender), pkt.num_multicast_receivers);
+
+      pkt.node_type = hop._next_node_type;
+      pkt.time = hop._time;
+      pkt.zero_load_delay = hop._zero_load_delay;
+      pkt.contention_delay = hop._contention_delay;
+
+      if (hop._next_node_type != NetworkModel::RECEIVE_TILE)
+         model_list[hop._next_tile_id]->__routePacket(pkt, hops);
+      else
+         num_received[hop._next_tile_id] ++;
+   }
+}
+
+int main(int argc, char* argv[])
+{
+   string_vec args;
+   std::string config_path = "carbon_sim.cfg";
+   parse_args(args, config_path, argc, argv);
+
+   config::ConfigFile cfg;
+   cfg.load(config_path);
+   handle_args(args, cfg);
+
+   // Only the parts of Simulator::start() the tiles need
+   Simulator::setConfig(&cfg);
+   Simulator::allocate();
+   Transport::create();
+   DVFSManager::initializeDVFS();
+
+   SInt32 num_tiles = (SInt32) Config::getSingleton()->getApplicationTiles();
+   for (tile_id_t i = 0; i < num_tiles; i++)
+      tile_list.push_back(new Tile(i));
+
+   printf("Starting Multicast-Routing test\n");
+
+   std::vector<NetworkModel*> model_list(num_tiles);
+   for (SInt32 i = 0; i < num_tiles; i++)
+   {
+      Network* network = tile_list[i]->getNetwork();
+      model_list[i] = NetworkModel::createModel(network, STATIC_NETWORK_USER, NETWORK_EMESH_HOP_BY_HOP);
+      model_list[i]->enable();
+   }
+   if (!model_list[0]->hasMulticastCapability())
+      testFailed("Multicast-Routing", "Run with --network/emesh_hop_by_hop/multicast_tree_enabled=true");
+
+   srand(1);
+   std::vector<tile_id_t> tiles(num_tiles);
+   std::vector<UInt32> num_received(num_tiles);
+   UInt64 curr_time = 0;
+   UInt64 num_receptions = 0;
+
+   UInt64 start_time = getHostTime();
+   for (SInt32 i = 0; i < NUM_MULTICASTS; i++)
+   {
+      // A random subset of the other tiles, in random order (all of them
+      // every 100 packets)
+      SInt32 sender = rand() % num_tiles;
+      for (SInt32 j = 0; j < num_tiles; j++)
+         tiles[j] = j;
+      std::swap(tiles[sender], tiles[num_tiles - 1]);
+      std::random_shuffle(tiles.begin(), tiles.end() - 1);
+      UInt32 num_receivers = (i % 100 == 0) ? (num_tiles - 1) : (1 + rand() % (num_tiles - 1));
+
+      NetPacket pkt(Time(curr_time), USER, sender, NetPacket::MULTICAST, PACKET_LENGTH, NULL);
+      pkt.num_multicast_receivers = num_receivers;
+      pkt.multicast_receivers = &tiles[0];
+
+      num_received.assign(num_tiles, 0);
+      routePacket(model_list, pkt, num_received);
+
+      for (UInt32 j = 0; j < num_receivers; j++)
+      {
+         if (num_received[tiles[j]] != 1)
+            fail("Receiver not reached exactly once", sender, num_receivers);
+      }
+      for (UInt32 j = num_receivers; j < (UInt32) num_tiles; j++)
+      {
+         if (num_received[tiles[j]] != 0)
+            fail("Packet reached a tile that is not a receiver", sender, num_receivers);
+      }
+
+      num_receptions += num_receivers;
+      curr_time += 1000;
+   }
+   UInt64 multicast_time = getHostTime() - start_time;
+
+   printf("emesh_hop_by_hop: Multicasts(%.0f packets/sec), Average Receivers(%.1f)\n",
+          ((double) NUM_MULTICASTS) * 1000000 / multicast_time, ((double) num_receptions) / NUM_MULTICASTS);
+
+   for (SInt32 i = 0; i < num_tiles; i++)
+      delete model_list[i];
+
+   testSucceeded("Multicast-Routing");
+   return 0;
+}
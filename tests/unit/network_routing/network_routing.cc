@@ -0,0 +1,154 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "fixed_types.h"
+#include "simulator.h"
+#include "transport.h"
+#include "dvfs_manager.h"
+#include "tile.h"
+#include "network.h"
+#include "network_model.h"
+#include "network_types.h"
+#include "config.h"
+#include "config_file.hpp"
+#include "handle_args.h"
+#include "unit_test.h"
+
+// Routes random unicasts and broadcasts through all the routers of the
+// packet's path (as Network::forwardPacket() does with the shared memory
+// shortcut), checks that they reach their receivers and reports the host
+// throughput of the routing functions of each network model.
+//
+// The simulator is not started: the test only reads the configuration and
+// creates the tiles, whose networks the models are attached to.
+
+#define NUM_UNICASTS    200000
+#define NUM_BROADCASTS  2000
+#define PACKET_LENGTH   64
+
+static std::vector<Tile*> tile_list;
+
+static void fail(const char* model_name, const char* msg)
+{
+   testFailed("Network-Routing", "%s: %s", model_name, msg);
+}
+
+// Returns the number of hops that reached a RECEIVE_TILE, marking them in 'reached'
+static UInt32 routePacket(std::vector<NetworkModel*>& model_list, NetPacket& pkt, std::vector<bool>& reached)
+{
+   NetworkModel::HopVector hops;
+   model_list[TILE_ID(pkt.sender)]->__routePacket(pkt, hops);
+
+   UInt32 num_received = 0;
+   for (UInt32 i = 0; i < hops.size(); i++)
+   {
+      NetworkModel::Hop hop = hops[i];
+
+      pkt.node_type = hop._next_node_type;
+      pkt.time = hop._time;
+      pkt.zero_load_delay = hop._zero_load_delay;
+      pkt.contention_delay = hop._contention_delay;
+
+      if (hop._next_node_type != NetworkModel::RECEIVE_TILE)
+      {
+         model_list[hop._next_tile_id]->__routePacket(pkt, hops);
+      }
+      else
+      {
+         reached[hop._next_tile_id] = true;
+         num_received ++;
+      }
+   }
+   return num_received;
+}
+
+static void testModel(UInt32 model_type, const char* model_name)
+{
+   SInt32 num_tiles = (SInt32) Config::getSingleton()->getApplicationTiles();
+
+   std::vector<NetworkModel*> model_list(num_tiles);
+   for (SInt32 i = 0; i < num_tiles; i++)
+   {
+      Network* network = tile_list[i]->getNetwork();
+      model_list[i] = NetworkModel::createModel(network, STATIC_NETWORK_USER, model_type);
+      model_list[i]->enable();
+   }
+
+   std::vector<bool> reached(num_tiles);
+   UInt64 curr_time = 0;
+
+   UInt64 start_time = getHostTime();
+   for (SInt32 i = 0; i < NUM_UNICASTS; i++)
+   {
+      SInt32 sender = rand() % num_tiles;
+      SInt32 receiver = rand() % (num_tiles - 1);
+      if (receiver >= sender)
+         receiver ++;
+
+      NetPacket pkt(Time(curr_time), USER, sender, receiver, PACKET_LENGTH, NULL);
+      reached.assign(num_tiles, false);
+      if ((routePacket(model_list, pkt, reached) != 1) || !reached[receiver])
+         fail(model_name, "Unicast did not reach its receiver");
+      curr_time += 1000;
+   }
+   UInt64 unicast_time = getHostTime() - start_time;
+
+   UInt64 broadcast_time = 0;
+   if (model_list[0]->hasBroadcastCapability())
+   {
+      start_time = getHostTime();
+      for (SInt32 i = 0; i < NUM_BROADCASTS; i++)
+      {
+         SInt32 sender = rand() % num_tiles;
+
+         NetPacket pkt(Time(curr_time), USER, sender, NetPacket::BROADCAST, PACKET_LENGTH, NULL);
+         reached.assign(num_tiles, false);
+         routePacket(model_list, pkt, reached);
+         for (SInt32 j = 0; j < num_tiles; j++)
+         {
+            if ((j != sender) && !reached[j])
+               fail(model_name, "Broadcast did not reach all the tiles");
+         }
+         curr_time += 1000;
+      }
+      broadcast_time = getHostTime() - start_time;
+   }
+
+   printf("%s: Unicasts(%.0f packets/sec)", model_name, ((double) NUM_UNICASTS) * 1000000 / unicast_time);
+   if (broadcast_time > 0)
+      printf(", Broadcasts(%.0f packets/sec)", ((double) NUM_BROADCASTS) * 1000000 / broadcast_time);
+   printf("\n");
+
+   for (SInt32 i = 0; i < num_tiles; i++)
+      delete model_list[i];
+}
+
+int main(int argc, char* argv[])
+{
+   string_vec args;
+   std::string config_path = "carbon_sim.cfg";
+   parse_args(args, config_path, argc, argv);
+
+   config::ConfigFile cfg;
+   cfg.load(config_path);
+   handle_args(args, cfg);
+
+   // Only the parts of Simulator::start() the tiles need
+   Simulator::setConfig(&cfg);
+   Simulator::allocate();
+   Transport::create();
+   DVFSManager::initializeDVFS();
+
+   for (tile_id_t i = 0; i < (tile_id_t) Config::getSingleton()->getApplicationTiles(); i++)
+      tile_list.push_back(new Tile(i));
+
+   printf("Starting Network-Routing test\n");
+
+   srand(1);
+   testModel(NETWORK_EMESH_HOP_COUNTER, "emesh_hop_counter");
+   testModel(NETWORK_EMESH_HOP_BY_HOP, "emesh_hop_by_hop");
+   testModel(NETWORK_ATAC, "atac");
+
+   testSucceeded("Network-Routing");
+   return 0;
+}
@@ -0,0 +1,89 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include "fixed_types.h"
+#include "time_types.h"
+#include "unit_test.h"
+
+// Checks that the conversions through a ClockPeriod give the same results
+// as the floating-point ones, and compares their host cost.
+
+#define NUM_CHECKS         1000000
+#define NUM_CONVERSIONS    10000000
+
+static const double frequency_list[] = { 1.0, 2.0, 0.5, 2.5, 4.0, 1.25, 0.25, 1.5, 3.0, 1.1, 0.8, 0.1, 0.001 };
+static const UInt32 NUM_FREQUENCIES = sizeof(frequency_list) / sizeof(frequency_list[0]);
+
+static void fail(const char* conversion, double frequency, UInt64 value, UInt64 expected, UInt64 got)
+{
+   testFailed("Time-Conversion", "%s: Frequency(%g), Value(%llu), Expected(%llu), Got(%llu)", conversion, frequency,
+              (long long unsigned int) value, (long long unsigned int) expected, (long long unsigned int) got);
+}
+
+// Random value with a random number of bits, so that all magnitudes are covered
+static UInt64 randomValue()
+{
+   UInt64 value = (((UInt64) rand()) << 32) ^ (((UInt64) rand()) << 16) ^ ((UInt64) rand());
+   return value >> (rand() % 64);
+}
+
+static void checkConversions(double frequency)
+{
+   ClockPeriod period(frequency);
+   for (SInt32 i = 0; i < NUM_CHECKS; i++)
+   {
+      UInt64 cycles = randomValue() >> 10;   // 1000 * cycles must not overflow
+      UInt64 expected = Latency(cycles, frequency).toPicosec();
+      UInt64 got = Latency(cycles, period).toPicosec();
+      if (got != expected)
+         fail("Latency::toPicosec", frequency, cycles, expected, got);
+
+      Time time(randomValue());
+      expected = time.toCycles(frequency);
+      got = time.toCycles(period);
+      if (got != expected)
+         fail("Time::toCycles", frequency, time.getTime(), expected, got);
+
+      expected = (UInt64) ceil(((double) time.getTime()) / 1000.0);
+      got = time.toNanosec();
+      if (got != expected)
+         fail("Time::toNanosec", frequency, time.getTime(), expected, got);
+   }
+}
+
+int main(int argc, char* argv[])
+{
+   printf("Starting Time-Conversion test\n");
+
+   srand(1);
+   for (UInt32 i = 0; i < NUM_FREQUENCIES; i++)
+      checkConversions(frequency_list[i]);
+
+   // Exact periods are used for the first ones only
+   if ((ClockPeriod(1.0).getPicosec() != 1000) || (ClockPeriod(2.5).getPicosec() != 400) ||
+       (ClockPeriod(1.5).getPicosec() != 0) || (ClockPeriod(1.1).getPicosec() != 0))
+      testFailed("Time-Conversion", "Wrong clock period");
+
+   double frequency = 2.0;
+   ClockPeriod period(frequency);
+   UInt64 total = 0;
+
+   UInt64 start_time = getHostTime();
+   for (UInt64 i = 0; i < NUM_CONVERSIONS; i++)
+      total += Time(Latency(i, frequency)).toCycles(frequency);
+   UInt64 frequency_time = getHostTime() - start_time;
+
+   start_time = getHostTime();
+   for (UInt64 i = 0; i < NUM_CONVERSIONS; i++)
+      total -= Time(Latency(i, period)).toCycles(period);
+   UInt64 period_time = getHostTime() - start_time;
+
+   if (total != 0)
+      testFailed("Time-Conversion", "Conversions with a ClockPeriod differ");
+
+   printf("Cycles -> Picosec -> Cycles: Frequency(%.2f ns/conversion), ClockPeriod(%.2f ns/conversion)\n",
+          ((double) frequency_time) * 1000 / NUM_CONVERSIONS, ((double) period_time) * 1000 / NUM_CONVERSIONS);
+
+   testSucceeded("Time-Conversion");
+   return 0;
+}
@@ -0,0 +1,58 @@
+#include <cstdio>
+#include <cstdlib>
+#include "carbon_user.h"
+#include "unit_test.h"
+
+// Bounces a message between tile 0 and tile 1, which sit in different
+// processes with PROCS=2. Run it with --transport/shared_memory=false to
+// compare the shared memory transport with the socket one.
+
+#define NUM_ROUND_TRIPS    100000
+
+static void* pong(void* arg);
+
+int main(int argc, char* argv[])
+{
+   CarbonStartSim(argc, argv);
+   printf("Starting Transport-Ping-Pong test\n");
+
+   CAPI_Initialize(0);
+   carbon_thread_t thread = CarbonSpawnThread(pong, NULL);
+
+   UInt64 value = 0;
+   UInt64 start_time = getHostTime();
+   for (UInt32 i = 0; i < NUM_ROUND_TRIPS; i++)
+   {
+      CAPI_message_send_w((CAPI_endpoint_t) 0, (CAPI_endpoint_t) 1, (char*) &value, sizeof(value));
+      CAPI_message_receive_w((CAPI_endpoint_t) 1, (CAPI_endpoint_t) 0, (char*) &value, sizeof(value));
+   }
+   UInt64 elapsed_time = getHostTime() - start_time;
+
+   CarbonJoinThread(thread);
+
+   if (value != NUM_ROUND_TRIPS)
+      testFailed("Transport-Ping-Pong", "Value(%llu), Expected(%u)", (long long unsigned int) value, NUM_ROUND_TRIPS);
+
+   printf("Round trips: %u, Messages/sec(%.0f), Latency(%.2f us/round trip)\n", NUM_ROUND_TRIPS,
+          ((double) 2 * NUM_ROUND_TRIPS) * 1000000 / elapsed_time, ((double) elapsed_time) / NUM_ROUND_TRIPS);
+
+   testSucceeded("Transport-Ping-Pong");
+   CarbonStopSim();
+
+   return 0;
+}
+
+static void* pong(void* arg)
+{
+   CAPI_Initialize(1);
+
+   UInt64 value;
+   for (UInt32 i = 0; i < NUM_ROUND_TRIPS; i++)
+   {
+      CAPI_message_receive_w((CAPI_endpoint_t) 0, (CAPI_endpoint_t) 1, (char*) &value, sizeof(value));
+      value ++;
+      CAPI_message_send_w((CAPI_endpoint_t) 1, (CAPI_endpoint_t) 0, (char*) &value, sizeof(value));
+   }
+
+   return NULL;
+}
@@ -0,0 +1,44 @@
+#ifndef UNIT_TEST_H
+#define UNIT_TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <sys/time.h>
+
+#include "fixed_types.h"
+
+// Helpers shared by the unit tests. A test reports its outcome as
+// "<name> test: SUCCESS" or "<name> test: FAILED".
+
+// Host time in microseconds, to time the code under test
+static inline UInt64 getHostTime()
+{
+   timeval t;
+   gettimeofday(&t, NULL);
+   return (((UInt64) t.tv_sec) * 1000000 + t.tv_usec);
+}
+
+static inline void testFailed(const char* name, const char* format, ...)
+   __attribute__((format(printf, 2, 3), noreturn));
+
+// Prints the error and the outcome of the test, and exits
+static inline void testFailed(const char* name, const char* format, ...)
+{
+   va_list args;
+   va_start(args, format);
+   fprintf(stderr, "*ERROR* ");
+   vfprintf(stderr, format, args);
+   fprintf(stderr, "\n");
+   va_end(args);
+
+   fprintf(stderr, "%s test: FAILED\n", name);
+   exit(EXIT_FAILURE);
+}
+
+static inline void testSucceeded(const char* name)
+{
+   printf("%s test: SUCCESS\n", name);
+}
+
+#endif // UNIT_TEST_H
@@ -30,10 +30,11 @@ def get_pin_home(graphite_home):
 #  start up a command on one machine
 #  can be called by spawn_master.py or spawn_slave.py
 
-def spawn_job(proc_num, command, graphite_home):
+def spawn_job(proc_num, run_id, command, graphite_home):
     # Set LD_LIBRARY_PATH using PIN_HOME from Makefile.config
     os.environ['LD_LIBRARY_PATH'] =  "%s/intel64/runtime" % get_pin_home(graphite_home)
     os.environ['CARBON_PROCESS_INDEX'] = "%d" % (proc_num)
+    os.environ['CARBON_RUN_ID'] = run_id
     os.environ['GRAPHITE_HOME'] = graphite_home
     proc = subprocess.Popen(command, shell=True, preexec_fn=os.setsid, env=os.environ)
     return proc
@@ -17,7 +17,7 @@ from termcolors import *
 # spawn_job:
 #  start up a command across multiple machines
 #  returns an object that can be passed to poll_job()
-def spawn_job(machine_list, command, working_dir, graphite_home):
+def spawn_job(machine_list, run_id, command, working_dir, graphite_home):
     
     graphite_procs = {}
 
@@ -27,10 +27,10 @@ def spawn_job(machine_list, command, working_dir, graphite_home):
             exec_command = "%s" % (command)
             
             print "%s Starting process: %d: %s" % (pmaster(), i, exec_command)
-            graphite_procs[i] = spawn.spawn_job(i, exec_command, graphite_home)
+            graphite_procs[i] = spawn.spawn_job(i, run_id, exec_command, graphite_home)
         else:
             command = command.replace("\"", "\\\"")
-            spawn_slave_command = "python -u %s/tools/spawn_slave.py %s %d \\\"%s\\\"" % (graphite_home, working_dir, i, command)
+            spawn_slave_command = "python -u %s/tools/spawn_slave.py %s %d %s \\\"%s\\\"" % (graphite_home, working_dir, i, run_id, command)
             exec_command = "ssh -x %s \"%s\"" % (machine_list[i], spawn_slave_command)
    
             print "%s Starting process: %d: %s" % (pmaster(), i, exec_command)
@@ -102,6 +102,19 @@ def kill_job(graphite_procs):
 
 # Helper functions
 
+# Identifies the simulation to its processes (CARBON_RUN_ID), which name the
+# resources they share on a host after it
+def get_run_id():
+    return "%d_%d" % (os.getpid(), int(time.time()))
+
+# Remove the shared memory segment of the transport, which is left behind
+# when the simulation dies before all its processes have attached to it
+def remove_shm_segment(run_id):
+    try:
+        os.remove("/dev/shm/carbon_transport_%s" % (run_id))
+    except OSError:
+        pass
+
 # Read output_dir from the command string
 def get_output_dir(command):
     output_dir_match = re.match(r'.*--general/output_dir\s*=\s*([^\s]+)', command)
@@ -203,6 +216,7 @@ if __name__=="__main__":
     num_processes = get_num_processes(command)
     process_list = get_process_list(command, num_processes)
     working_dir = os.getcwd()
+    run_id = get_run_id()
 
     # Get graphite home
     graphite_home = spawn.get_graphite_home()
@@ -212,14 +226,18 @@ if __name__=="__main__":
 
     # Spawn job
     graphite_procs = spawn_job(process_list,
+                               run_id,
                                command,
                                working_dir,
                                graphite_home)
 
     try:
-        sys.exit(wait_job(graphite_procs))
+        returnCode = wait_job(graphite_procs)
 
     except KeyboardInterrupt:
         msg = colorstr('Keyboard interrupt. Killing simulation', 'RED')
         print "%s %s" % (pmaster(), msg)
-        sys.exit(kill_job(graphite_procs))
+        returnCode = kill_job(graphite_procs)
+
+    remove_shm_segment(run_id)
+    sys.exit(returnCode)
@@ -0,0 +1,151 @@
+// Renders the binary traces written by the EventTracer (event_trace.<proc>.bin
+// in the output directory) as text, one record per line:
+//
+//    <time> <thread> <tile> <module> <event> <message>
+//
+// Usage: trace_decoder [-s] <trace file>...
+//    -s    sort the records of all the files by simulated time (the records of
+//          a thread are otherwise printed in the order they were recorded)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+#include "trace_events.h"
+
+static const char* module_names[] =
+{
+#define TRACE_MODULE_DEF(id, name) name,
+   TRACE_MODULE_LIST
+#undef TRACE_MODULE_DEF
+};
+
+static const char* event_names[] =
+{
+#define TRACE_EVENT_DEF(module_id, event_id, format) #event_id,
+   TRACE_EVENT_LIST
+#undef TRACE_EVENT_DEF
+};
+
+static const char* event_formats[] =
+{
+#define TRACE_EVENT_DEF(module_id, event_id, format) format,
+   TRACE_EVENT_LIST
+#undef TRACE_EVENT_DEF
+};
+
+struct DecodedRecord
+{
+   UInt32 process;
+   UInt32 thread;
+   TraceRecord record;
+};
+
+static bool compareTime(const DecodedRecord& first, const DecodedRecord& second)
+{
+   return first.record.time < second.record.time;
+}
+
+static void printRecord(const DecodedRecord& decoded)
+{
+   const TraceRecord& record = decoded.record;
+   if (record.event >= NUM_TRACE_EVENTS)
+   {
+      printf("%llu %u.%u %d ? UNKNOWN(%u)\n", (long long unsigned int) record.time,
+             decoded.process, decoded.thread, record.tile_id, record.event);
+      return;
+   }
+
+   printf("%llu %u.%u %d %s %s ", (long long unsigned int) record.time,
+          decoded.process, decoded.thread, record.tile_id,
+          module_names[TRACE_EVENT_MODULES[record.event]], event_names[record.event]);
+   printf(event_formats[record.event], (long long int) record.args[0],
+          (long long int) record.args[1], (long long int) record.args[2]);
+   printf("\n");
+}
+
+// Returns the number of records that were dropped while tracing
+static UInt64 decodeFile(const char* filename, UInt32 process, bool sort, std::vector<DecodedRecord>& records)
+{
+   FILE* file = fopen(filename, "r");
+   if (!file)
+   {
+      fprintf(stderr, "Could not open %s\n", filename);
+      exit(EXIT_FAILURE);
+   }
+
+   TraceFileHeader file_header;
+   if (fread(&file_header, sizeof(file_header), 1, file) != 1 ||
+       file_header.magic != TraceFileHeader::MAGIC)
+   {
+      fprintf(stderr, "%s is not an event trace\n", filename);
+      exit(EXIT_FAILURE);
+   }
+   if (file_header.version != TraceFileHeader::VERSION || file_header.record_size != sizeof(TraceRecord))
+   {
+      fprintf(stderr, "%s was written by a different version of the simulator\n", filename);
+      exit(EXIT_FAILURE);
+   }
+
+   UInt64 num_dropped = 0;
+   TraceBlockHeader block_header;
+   while (fread(&block_header, sizeof(block_header), 1, file) == 1)
+   {
+      num_dropped += block_header.num_dropped;
+      for (UInt32 i = 0; i < block_header.num_records; i++)
+      {
+         DecodedRecord decoded;
+         decoded.process = process;
+         decoded.thread = block_header.thread;
+         if (fread(&decoded.record, sizeof(TraceRecord), 1, file) != 1)
+         {
+            fprintf(stderr, "%s is truncated\n", filename);
+            exit(EXIT_FAILURE);
+         }
+
+         if (sort)
+            records.push_back(decoded);
+         else
+            printRecord(decoded);
+      }
+   }
+
+   fclose(file);
+   return num_dropped;
+}
+
+int main(int argc, char* argv[])
+{
+   bool sort = false;
+   int first_file = 1;
+   if (argc > 1 && strcmp(argv[1], "-s") == 0)
+   {
+      sort = true;
+      first_file = 2;
+   }
+
+   if (first_file >= argc)
+   {
+      fprintf(stderr, "Usage: %s [-s] <trace file>...\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   std::vector<DecodedRecord> records;
+   UInt64 num_dropped = 0;
+   for (int i = first_file; i < argc; i++)
+      num_dropped += decodeFile(argv[i], i - first_file, sort, records);
+
+   if (sort)
+   {
+      std::stable_sort(records.begin(), records.end(), compareTime);
+      for (std::vector<DecodedRecord>::iterator it = records.begin(); it != records.end(); it++)
+         printRecord(*it);
+   }
+
+   if (num_dropped > 0)
+      fprintf(stderr, "%llu records were dropped while tracing\n", (long long unsigned int) num_dropped);
+
+   return 0;
+}
@@ -0,0 +1,173 @@
+// Replays the instruction traces recorded with instruction_trace/record = true
+// (instruction_trace.<tile>.bin in the output directory of the recording run),
+// without Pin and without the application. Every traced tile gets a thread
+// that feeds the instructions, data accesses and branch outcomes of its trace
+// to the core model and the memory subsystem of that tile, in the order the
+// frontend fed them during the recording. One recording can so be replayed
+// with any configuration that has as many tiles (caches, network, DVFS, ...).
+//
+// Usage: trace_replay <trace file>... -c <config> [--<section>/<key>=<value>]...
+//    or: make -C tools/trace_replay TRACES="<trace file>..." CORES=<tiles>
+//
+// The threads are replayed independently: their synchronization (mutexes,
+// barriers, joins) and their system calls are not in the traces. Only the
+// clock skew management scheme keeps their clocks close.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <vector>
+#include <string>
+
+#include "tile.h"
+#include "core.h"
+#include "core_model.h"
+#include "mem_component.h"
+#include "tile_manager.h"
+#include "simulator.h"
+#include "config.h"
+#include "clock_skew_management_object.h"
+#include "instruction_trace.h"
+#include "log.h"
+
+#include "carbon_user.h"
+#include "fixed_types.h"
+
+using namespace std;
+
+static UInt64 getHostTime()
+{
+   struct timeval t;
+   gettimeofday(&t, NULL);
+   return ((UInt64) t.tv_sec) * 1000000 + t.tv_usec;
+}
+
+// Same calls as the Pin frontend (handleInstruction, handlePeriodicSync,
+// handleBranch in pin/ and the memory redirection)
+static void replay(const string& filename)
+{
+   InstructionTraceReader reader(filename);
+
+   Core* core = Sim()->getTileManager()->getCurrentCore();
+   LOG_ASSERT_ERROR(reader.getTileId() == core->getTile()->getId(),
+                    "%s was recorded on tile(%i), replaying it on tile(%i)",
+                    filename.c_str(), reader.getTileId(), core->getTile()->getId());
+
+   CoreModel* core_model = core->getModel();
+   ClockSkewManagementClient* client = core->getClockSkewManagementClient();
+
+   // Contents of the replayed data accesses
+   vector<Byte> data_buf(64);
+
+   UInt64 num_instructions = 0;
+   UInt64 num_memory_accesses = 0;
+   UInt64 start_time = getHostTime();
+
+   InstructionTraceReader::Event event;
+   while (reader.next(event))
+   {
+      switch (event._type)
+      {
+      case InstructionTraceReader::Event::INSTRUCTION:
+         core_model->queueInstruction(event._instruction);
+         core_model->iterate();
+         if (client)
+            client->synchronize();
+         num_instructions ++;
+         break;
+
+      case InstructionTraceReader::Event::MEMORY_ACCESS:
+         if (event._size > data_buf.size())
+            data_buf.resize(event._size);
+         core->initiateMemoryAccess(MemComponent::L1_DCACHE, event._lock_signal, event._mem_op_type,
+                                    event._address, &data_buf[0], event._size, true);
+         num_memory_accesses ++;
+         break;
+
+      case InstructionTraceReader::Event::BRANCH:
+         core_model->pushDynamicBranchInfo(DynamicBranchInfo(event._taken, event._target));
+         break;
+      }
+   }
+
+   UInt64 host_time = getHostTime() - start_time;
+   printf("Tile(%i): Instructions(%llu), Memory Accesses(%llu), Simulated Time(%llu ns), Host Time(%llu us)\n",
+          core->getTile()->getId(), (long long unsigned int) num_instructions,
+          (long long unsigned int) num_memory_accesses,
+          (long long unsigned int) core_model->getCurrTime().toNanosec(), (long long unsigned int) host_time);
+}
+
+static void* replayThread(void* arg)
+{
+   replay(*(string*) arg);
+   return NULL;
+}
+
+int main(int argc, char* argv[])
+{
+   // The arguments that are not simulator options
+   vector<string> trace_files;
+   for (int i = 1; i < argc; i++)
+   {
+      if (strcmp(argv[i], "-c") == 0)
+         i ++;
+      else if (strcmp(argv[i], "--") == 0)
+         break;
+      else if (strncmp(argv[i], "--", 2) != 0)
+         trace_files.push_back(argv[i]);
+   }
+   if (trace_files.empty())
+   {
+      fprintf(stderr, "Usage: %s <trace file>... -c <config> [--<section>/<key>=<value>]...\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   CarbonStartSim(argc, argv);
+
+   // Threads are spawned on the tiles of their traces through the thread spawner
+   LOG_ASSERT_ERROR(Sim()->getConfig()->getSimulationMode() == Config::FULL,
+                    "trace_replay needs general/mode = full");
+   LOG_ASSERT_ERROR(Config::getSingleton()->getProcessCount() == 1,
+                    "trace_replay runs in a single process");
+
+   vector<tile_id_t> tile_list(trace_files.size());
+   vector<bool> traced_tiles(Config::getSingleton()->getApplicationTiles(), false);
+   for (UInt32 i = 0; i < trace_files.size(); i++)
+   {
+      InstructionTraceReader reader(trace_files[i]);
+      tile_list[i] = reader.getTileId();
+      LOG_ASSERT_ERROR(tile_list[i] < (tile_id_t) traced_tiles.size(),
+                       "%s was recorded on tile(%i), only %u application tiles",
+                       trace_files[i].c_str(), tile_list[i], traced_tiles.size());
+      LOG_ASSERT_ERROR(!traced_tiles[tile_list[i]], "Two traces of tile(%i)", tile_list[i]);
+      traced_tiles[tile_list[i]] = true;
+   }
+
+   Simulator::enablePerformanceModelsInCurrentProcess();
+
+   UInt64 start_time = getHostTime();
+
+   // The main thread runs on tile 0
+   vector<carbon_thread_t> thread_list;
+   for (UInt32 i = 0; i < trace_files.size(); i++)
+   {
+      if (tile_list[i] != 0)
+         thread_list.push_back(CarbonSpawnThreadOnTile(tile_list[i], replayThread, &trace_files[i]));
+   }
+   for (UInt32 i = 0; i < trace_files.size(); i++)
+   {
+      if (tile_list[i] == 0)
+         replay(trace_files[i]);
+   }
+   for (UInt32 i = 0; i < thread_list.size(); i++)
+      CarbonJoinThread(thread_list[i]);
+
+   printf("Replayed %u traces, Host Time(%llu us)\n", (UInt32) trace_files.size(),
+          (long long unsigned int) (getHostTime() - start_time));
+
+   Simulator::disablePerformanceModelsInCurrentProcess();
+   CarbonStopSim();
+
+   return 0;
+}